@@ -1,6 +1,7 @@
 #include "ACCController.h"
 #include <iostream>
 #include <algorithm> // for std::max, std::min
+#include <cmath>
 
 ACCController::ACCController() {
     // --- 1. 물리 단위 파라미터 (튜닝) ---
@@ -10,9 +11,26 @@ ACCController::ACCController() {
     m_targetSafeDistance_m = 1.2; // (안전 강화) 목표 안전 거리를 80cm -> 1m로 늘림
     m_acc_Kp = 0.4;           // (부드럽게) 속도 변화 반응성을 0.8 -> 0.6으로 낮춤
 
+    // --- 헤드웨이 간격 제어 (computeGapSpeed) ---
+    m_headway_s = 0.8;        // 0.8m/s 주행 시 목표 간격 = 0.4 + 0.64m
+    m_gap_Kp = 0.8;
+    m_ttcStop_s = 0.6;
+    m_maxAccel_mps2 = 1.0;
+    m_maxDecel_mps2 = 3.0;
+    m_gapSpeed_ms = 0.0;
+
     // --- 2. 모터 명령 변환 파라미터 ---
     m_speedCmd_Max = 100;
     m_speedCmd_Min_Run = 40;  // 40 이하는 모터가 안 돈다고 가정
+
+    // --- 3. 고정소수점 파라미터 (TC375 DRIVELAW_ACC_DEFAULTS와 같은 값) ---
+    m_fx.max_speed_mms = (int32_t)std::lround(m_maxSpeed_ms * 1000.0);
+    m_fx.base_speed_mms = (int32_t)std::lround(m_baseSpeed_ms * 1000.0);
+    m_fx.stop_distance_mm = (int32_t)std::lround(m_stopDistance_m * 1000.0);
+    m_fx.target_distance_mm = (int32_t)std::lround(m_targetSafeDistance_m * 1000.0);
+    m_fx.kp_q16 = (int32_t)std::lround(m_acc_Kp * DRIVELAW_Q16_ONE);
+    m_fx.cmd_max = m_speedCmd_Max;
+    m_fx.cmd_min_run = m_speedCmd_Min_Run;
 }
 
 int ACCController::scaleSpeedToCommand(double speed_ms) {
@@ -36,4 +54,34 @@ int ACCController::computeBaseSpeed(double frontDistance_m) {
     targetSpeed_ms = std::max(0.0, std::min(m_maxSpeed_ms, targetSpeed_ms));
 
     return scaleSpeedToCommand(targetSpeed_ms);
-}
\ No newline at end of file
+}
+
+void ACCController::setCurrentCommand(int speedCmd) {
+    // scaleSpeedToCommand의 역변환
+    if (speedCmd <= 0) { m_gapSpeed_ms = 0.0; return; }
+    double ratio = double(speedCmd - m_speedCmd_Min_Run) / (m_speedCmd_Max - m_speedCmd_Min_Run);
+    m_gapSpeed_ms = std::max(0.0, std::min(1.0, ratio)) * m_maxSpeed_ms;
+}
+
+int ACCController::computeGapSpeed(const RangeEstimate& est, double rawRange_m, double dt_s) {
+    // 원시 거리 / 트랙 없음 / 비상 정지 거리 / TTC 임박 → 즉시 정지 (감속 한계 적용 안 함)
+    // 원시 거리는 computeBaseSpeed와 같이 첫 샘플에서 판단 (칼만 게이트는 max_rejects 샘플 동안 거름)
+    if (rawRange_m < m_stopDistance_m ||
+        !est.valid || est.range_m < m_stopDistance_m || est.ttc_s < m_ttcStop_s) {
+        m_gapSpeed_ms = 0.0;
+        return 0;
+    }
+
+    double egoSpeed_ms = m_gapSpeed_ms;
+    double leadSpeed_ms = std::max(0.0, egoSpeed_ms + est.rate_mps);
+    double desiredGap_m = m_stopDistance_m + m_headway_s * egoSpeed_ms;
+    double targetSpeed_ms = leadSpeed_ms + m_gap_Kp * (est.range_m - desiredGap_m);
+
+    // 클램핑 + 가감속 제한
+    targetSpeed_ms = std::max(0.0, std::min(m_maxSpeed_ms, targetSpeed_ms));
+    targetSpeed_ms = std::max(egoSpeed_ms - m_maxDecel_mps2 * dt_s,
+                              std::min(egoSpeed_ms + m_maxAccel_mps2 * dt_s, targetSpeed_ms));
+    m_gapSpeed_ms = targetSpeed_ms;
+
+    return scaleSpeedToCommand(targetSpeed_ms);
+}
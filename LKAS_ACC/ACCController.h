@@ -1,5 +1,8 @@
 #pragma once
 
+#include "RangeTracker.h"
+#include "../iLLD_TC375_ADS_FreeRTOS_Basic/App/App_DriveLaw.h"
+
 class ACCController {
 public:
     /**
@@ -14,6 +17,38 @@ public:
      */
     int computeBaseSpeed(double frontDistance_m);
 
+    /**
+     * @brief computeBaseSpeed의 고정소수점 버전 (TC375와 공유하는 App_DriveLaw.h, 정수 연산만)
+     * @param frontDistance_mm ToF 거리 (mm, CAN 값 그대로)
+     * @return 0~100 사이의 모터 속도 명령 (double 버전과 정수 경계에서만 1 차이 가능)
+     */
+    int computeBaseSpeedMm(int frontDistance_mm) const { return DriveLaw_AccBaseSpeed(&m_fx, frontDistance_mm); }
+
+    /**
+     * @brief 고정소수점 파라미터 (아래 double 파라미터를 mm, mm/s, Q16으로 변환한 값)
+     */
+    const DriveLawAccParams& fixedParams() const { return m_fx; }
+
+    /**
+     * @brief 헤드웨이 간격 제어 (RangeTracker 추정값 사용, --acc-gap)
+     *
+     * 목표 간격 = 정지 거리 + 헤드웨이 시간 * 현재 속도, 목표 속도 = 앞 물체 속도 + Kp * (거리 - 목표 간격).
+     * 앞 물체 속도는 직전 명령 속도 + 거리 변화율로 추정하고, TTC가 짧으면 즉시 정지합니다.
+     * 정지 외에는 가속/감속 한계로 명령 변화를 제한합니다.
+     * @param est RangeTracker::estimate() 결과 (valid가 false이면 정지)
+     * @param rawRange_m 가장 최근 ToF 원시 거리 (m, 게이팅 전). 정지 거리보다 가까우면 추정값과 무관하게
+     *                   즉시 정지 (게이트가 갑자기 나타난 물체를 튀는 값으로 거르는 동안에도 첫 샘플에서 정지)
+     * @param dt_s 직전 호출 이후 시간 (s, 제어 주기)
+     * @return 0~100 사이의 모터 속도 명령
+     */
+    int computeGapSpeed(const RangeEstimate& est, double rawRange_m, double dt_s);
+
+    /**
+     * @brief computeGapSpeed가 기억하는 현재 속도를 모터 명령(0~100)으로 지정
+     *        (회피/회전 상태에서 속도를 직접 정한 뒤 차선 주행으로 복귀할 때)
+     */
+    void setCurrentCommand(int speedCmd);
+
 private:
     /**
      * @brief 계산된 물리 속도(m/s)를 모터 명령(0~100)으로 변환
@@ -27,7 +62,17 @@ private:
     double m_targetSafeDistance_m;  // 목표 안전 거리 (m)
     double m_acc_Kp;                // 비례 게인 (P-Controller)
 
+    // --- 헤드웨이 간격 제어 파라미터 (computeGapSpeed) ---
+    double m_headway_s;             // 목표 간격 = 정지 거리 + 헤드웨이 * 속도
+    double m_gap_Kp;                // 간격 오차 게인 (1/s)
+    double m_ttcStop_s;             // TTC가 이보다 짧으면 즉시 정지
+    double m_maxAccel_mps2;         // 명령 가속 한계
+    double m_maxDecel_mps2;         // 명령 감속 한계 (비상 정지는 제외)
+    double m_gapSpeed_ms;           // 직전 명령 속도 (m/s)
+
     // --- 2. 모터 명령 변환 파라미터 (튜닝 필요) ---
     int m_speedCmd_Max;        // TC375의 최대 속도 명령 (예: 100)
     int m_speedCmd_Min_Run;    // 모터가 실제로 돌기 시작하는 최소 명령 (예: 40)
+
+    DriveLawAccParams m_fx;    // computeBaseSpeedMm용 (생성자에서 위 값으로 채움)
 };
\ No newline at end of file
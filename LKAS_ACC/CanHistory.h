@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 디코드된 CAN 프레임 하나 (CanHistory 항목)
+ */
+struct CanSample {
+    int64_t rx_ns = 0;    // 커널 수신 시각 (CLOCK_MONOTONIC ns)
+    int32_t value = 0;    // 디코드 값 (ToF: 거리 mm, 장애물/표지판: data[0] 코드)
+    uint32_t index = 0;   // 이 ID로 받은 몇 번째 프레임인지 (0부터)
+};
+
+/**
+ * @brief CAN ID 하나의 타임스탬프 이력 (단일 작성자 / 다중 독자 lock-free 링)
+ *
+ * - 작성자(CAN 수신 스레드)는 push()만, 독자(제어 스레드 등)는 조회 함수만 호출합니다.
+ * - 슬롯마다 stamp(= 프레임 번호 + 1, 쓰는 중에는 0)를 두어, 독자가 읽는 동안 덮어써진
+ *   슬롯은 버리므로 항상 온전한 항목만 돌려줍니다. (락/시스템 콜/할당 없음)
+ * - 조회 시각(now_ns)은 호출자가 CLOCK_MONOTONIC으로 넘깁니다.
+ *
+ * @tparam N 슬롯 개수 (2의 거듭제곱)
+ */
+template <size_t N>
+class CanHistory {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "CanHistory: N은 2의 거듭제곱이어야 합니다.");
+
+public:
+    /**
+     * @brief 새 항목 기록 (작성자 전용)
+     */
+    void push(int64_t rx_ns, int32_t value) {
+        const uint64_t n = m_count.load(std::memory_order_relaxed);
+        Slot& s = m_slots[n & (N - 1)];
+        s.stamp.store(0, std::memory_order_relaxed);            // 쓰는 중
+        std::atomic_thread_fence(std::memory_order_release);
+        s.rx_ns.store(rx_ns, std::memory_order_relaxed);
+        s.value.store(value, std::memory_order_relaxed);
+        s.stamp.store(n + 1, std::memory_order_release);
+        m_count.store(n + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 지금까지 기록된 항목 수
+     */
+    uint64_t count() const { return m_count.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 가장 최근 항목
+     * @return 아직 항목이 없으면 false
+     */
+    bool latest(CanSample& out) const {
+        for (;;) {
+            const uint64_t n = count();
+            if (n == 0) return false;
+            if (read(n - 1, out)) return true;   // 읽는 중 덮어써졌으면 새 최신 항목으로 다시
+        }
+    }
+
+    /**
+     * @brief 최근 window_ns 안에 받은 항목 (최신 것부터)
+     * @param out 결과 배열 (nullptr이면 개수만 셈)
+     * @param max_out out 크기 (링 크기 N을 넘는 항목은 이미 덮어써져 셀 수 없음)
+     * @return 채운(센) 항목 수
+     */
+    int recent(int64_t now_ns, int64_t window_ns, CanSample* out, int max_out) const {
+        const uint64_t n = count();
+        int got = 0;
+        for (uint64_t k = 0; k < n && k < N && got < max_out; k++) {
+            CanSample s;
+            if (!read(n - 1 - k, s)) break;                     // 덮어써짐 → 더 오래된 것도 없음
+            if (now_ns - s.rx_ns > window_ns) break;
+            if (out) out[got] = s;
+            got++;
+        }
+        return got;
+    }
+
+    /**
+     * @brief 최근 window_ns 동안의 수신 빈도 (Hz)
+     */
+    double rateHz(int64_t now_ns, int64_t window_ns) const {
+        if (window_ns <= 0) return 0.0;
+        return recent(now_ns, window_ns, nullptr, (int)N) * 1e9 / (double)window_ns;
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> stamp{0};
+        std::atomic<int64_t> rx_ns{0};
+        std::atomic<int32_t> value{0};
+    };
+
+    // 프레임 번호 idx인 항목을 읽음 (덮어써졌거나 쓰는 중이면 false)
+    bool read(uint64_t idx, CanSample& out) const {
+        const Slot& s = m_slots[idx & (N - 1)];
+        if (s.stamp.load(std::memory_order_acquire) != idx + 1) return false;
+        CanSample tmp;
+        tmp.rx_ns = s.rx_ns.load(std::memory_order_relaxed);
+        tmp.value = s.value.load(std::memory_order_relaxed);
+        tmp.index = (uint32_t)idx;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.stamp.load(std::memory_order_relaxed) != idx + 1) return false;
+        out = tmp;
+        return true;
+    }
+
+    Slot m_slots[N];
+    alignas(64) std::atomic<uint64_t> m_count{0};
+};
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <ratio>
+#include <type_traits>
+#include <linux/can.h> // canid_t
+
+/**
+ * @brief 컴파일 타임 CAN 신호 테이블 (DBC와 같은 방식의 신호 정의)
+ *
+ * 신호마다 ID, 시작 비트, 길이, 바이트 순서, 부호, 배율을 템플릿 인자로 적으면
+ * decode/encode가 상수 shift/mask만으로 만들어집니다. (분기/루프 없음, 8바이트 한 번 읽기)
+ *
+ * - 비트 번호는 DBC 규칙: 비트 b = data[b / 8]의 (b % 8)번째 비트 (0 = LSB)
+ * - Intel(little-endian): START = 신호의 LSB 비트
+ * - Motorola(big-endian): START = 신호의 MSB 비트 (DBC 표기와 같음)
+ * - 배율은 std::ratio (물리값 = raw * SCALE)
+ *
+ * 수신(TofCanReader)과 송신(Raspberrypi/Send_Detect2.cpp)이 아래 can_db 테이블 하나를 공유하므로
+ * 레이아웃을 바꾸거나 새 센서 프레임을 추가할 때는 여기만 고치면 됩니다.
+ */
+
+enum class ByteOrder { Intel, Motorola };
+
+namespace can_detail {
+
+// 8바이트 프레임 데이터를 64비트 정수로 (Intel: little-endian, Motorola: big-endian 해석)
+inline uint64_t load_le(const uint8_t* d) {
+    uint64_t w;
+    memcpy(&w, d, 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return w;
+}
+inline void store_le(uint8_t* d, uint64_t w) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    memcpy(d, &w, 8);
+}
+inline uint64_t load_be(const uint8_t* d) { return __builtin_bswap64(load_le(d)); }
+inline void store_be(uint8_t* d, uint64_t w) { store_le(d, __builtin_bswap64(w)); }
+
+constexpr uint64_t bswap64(uint64_t v) {
+    uint64_t r = 0;
+    for (int i = 0; i < 8; i++) r |= ((v >> (i * 8)) & 0xFF) << ((7 - i) * 8);
+    return r;
+}
+
+constexpr int popcount64(uint64_t v) {
+    int n = 0;
+    for (; v; v &= v - 1) n++;
+    return n;
+}
+
+} // namespace can_detail
+
+/**
+ * @brief 신호 하나의 정의와 디코더/인코더
+ * @tparam ID CAN ID
+ * @tparam START 시작 비트 (Intel: LSB, Motorola: MSB, DBC 비트 번호)
+ * @tparam LEN 비트 길이 (1~64)
+ * @tparam ORDER 바이트 순서
+ * @tparam SIGNED 2의 보수 부호 여부
+ * @tparam SCALE 물리값 배율 (std::ratio)
+ */
+template <canid_t ID, unsigned START, unsigned LEN, ByteOrder ORDER,
+          bool SIGNED = false, typename SCALE = std::ratio<1>>
+struct CanSignal {
+    static_assert(LEN >= 1 && LEN <= 64, "CanSignal: 길이는 1~64비트");
+    static_assert(START < 64, "CanSignal: 시작 비트는 0~63");
+
+    static constexpr canid_t id = ID;
+    static constexpr unsigned length = LEN;
+    static constexpr ByteOrder order = ORDER;
+    static constexpr bool is_signed = SIGNED;
+    static constexpr double scale = double(SCALE::num) / double(SCALE::den);
+
+    static constexpr uint64_t mask = (LEN == 64) ? ~0ULL : ((1ULL << LEN) - 1);
+
+    // 64비트 워드 안에서 신호 LSB 위치
+    //  Intel   : little-endian 워드의 비트 = DBC 비트 번호 그대로
+    //  Motorola: big-endian 워드에서 DBC 비트 b는 (7 - b/8)*8 + b%8, MSB에서 LEN-1만큼 아래가 LSB
+    static constexpr int msb_be = (7 - int(START) / 8) * 8 + int(START) % 8;
+    static constexpr int shift = (ORDER == ByteOrder::Intel) ? int(START) : msb_be - int(LEN) + 1;
+    static_assert(shift >= 0 && shift + int(LEN) <= 64, "CanSignal: 신호가 8바이트 프레임을 벗어남");
+
+    /** @brief 이 신호가 차지하는 비트 (DBC 비트 번호 기준 마스크, 겹침 검사용) */
+    static constexpr uint64_t occupancy =
+        (ORDER == ByteOrder::Intel) ? (mask << shift) : can_detail::bswap64(mask << shift);
+
+    /** @brief 이 신호를 읽는 데 필요한 최소 DLC */
+    static constexpr unsigned min_dlc = (64 - __builtin_clzll(occupancy) + 7) / 8;
+
+    using raw_type = typename std::conditional<SIGNED, int64_t, uint64_t>::type;
+
+    /**
+     * @brief raw 값 (부호 있는 신호는 부호 확장) - data는 8바이트 버퍼 (can_frame::data)
+     */
+    static raw_type raw(const uint8_t* data) {
+        uint64_t w = (ORDER == ByteOrder::Intel) ? can_detail::load_le(data) : can_detail::load_be(data);
+        uint64_t v = (w >> shift) & mask;
+        if constexpr (SIGNED && LEN < 64) {
+            return int64_t(v << (64 - LEN)) >> (64 - LEN);
+        } else {
+            return raw_type(v);
+        }
+    }
+
+    /** @brief 물리값 (raw * SCALE) */
+    static double decode(const uint8_t* data) { return double(raw(data)) * scale; }
+
+    /**
+     * @brief raw 값을 써 넣습니다. (다른 신호 비트는 유지, 범위를 넘는 비트는 잘림)
+     */
+    static void encodeRaw(uint8_t* data, raw_type value) {
+        uint64_t w = (ORDER == ByteOrder::Intel) ? can_detail::load_le(data) : can_detail::load_be(data);
+        w = (w & ~(mask << shift)) | ((uint64_t(value) & mask) << shift);
+        if (ORDER == ByteOrder::Intel) can_detail::store_le(data, w);
+        else can_detail::store_be(data, w);
+    }
+
+    /** @brief 물리값을 raw로 바꿔 써 넣습니다. (반올림) */
+    static void encode(uint8_t* data, double physical) {
+        double r = physical / scale;
+        encodeRaw(data, raw_type(r < 0 ? r - 0.5 : r + 0.5));
+    }
+};
+
+/**
+ * @brief 메시지(프레임) 정의: ID/DLC와 소속 신호들
+ *
+ * 컴파일 타임에 신호 ID 일치, DLC 안에 들어가는지, 신호끼리 비트가 겹치지 않는지 검사합니다.
+ */
+template <canid_t ID, unsigned DLC, typename... Signals>
+struct CanMessage {
+    static_assert(DLC >= 1 && DLC <= 8, "CanMessage: DLC는 1~8");
+    static_assert(((Signals::id == ID) && ...), "CanMessage: 신호 ID가 메시지 ID와 다름");
+    static_assert(((Signals::min_dlc <= DLC) && ...), "CanMessage: 신호가 DLC를 벗어남");
+    static_assert(can_detail::popcount64((Signals::occupancy | ...)) ==
+                  (can_detail::popcount64(Signals::occupancy) + ...),
+                  "CanMessage: 신호 비트가 서로 겹침");
+
+    static constexpr canid_t id = ID;
+    static constexpr unsigned dlc = DLC;
+
+    /** @brief 프레임 헤더 초기화 (ID, DLC, 데이터 0) */
+    static void init(struct can_frame& frame) {
+        memset(&frame, 0, sizeof(frame));
+        frame.can_id = ID;
+        frame.can_dlc = DLC;
+    }
+};
+
+// ==========================================================
+// ===== 신호 테이블 (ToF / 객체 검출) =====
+// ==========================================================
+namespace can_db {
+
+constexpr canid_t TOF_ID = 0x200;      // ToF 센서
+constexpr canid_t DETECT_ID = 0x300;   // YOLO 검출 결과 (Raspberrypi/Send_Detect2.cpp)
+
+// 0x200: [0-1] 거리 mm (little-endian)
+using TofDistance = CanSignal<TOF_ID, 0, 16, ByteOrder::Intel>;
+using TofMsg = CanMessage<TOF_ID, 2, TofDistance>;
+
+// 0x300: [0] 클래스, [1-2] 박스 너비 px (big-endian)
+using DetectClass = CanSignal<DETECT_ID, 0, 8, ByteOrder::Intel>;
+using DetectWidth = CanSignal<DETECT_ID, 15, 16, ByteOrder::Motorola>;
+using DetectMsg = CanMessage<DETECT_ID, 3, DetectClass, DetectWidth>;
+
+// DetectClass 값
+constexpr uint8_t CLASS_BOX    = 0x01;   // 장애물
+constexpr uint8_t CLASS_SIGN_A = 0x02;   // 우회전 표지판
+constexpr uint8_t CLASS_SIGN_B = 0x03;
+
+} // namespace can_db
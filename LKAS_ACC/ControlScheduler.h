@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include "LatencyStats.h"
+
+/**
+ * @brief 절대 시각 기준 고정 주기 스케줄러 (제어/TX 스레드용)
+ *
+ * clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)으로 k번째 주기의 마감 시각
+ * (start + k * period)까지 잠들므로, 작업 시간이나 카메라 프레임 타이밍에 따라 주기가 밀리지 않습니다.
+ * (FreeRTOS의 vTaskDelayUntil과 같은 방식, TC375 task_motor_control 주기와 맞출 수 있음)
+ *
+ * 사용법 (전용 스레드 안에서):
+ *   ControlScheduler sched(10000);
+ *   sched.configureThread(80, 3);   // (선택) SCHED_FIFO 80, CPU 3 고정
+ *   sched.start();
+ *   while (running) { uint64_t k = sched.waitNextTick(); ...; sched.endTick(); }
+ *
+ * - 깨어난 시각 - 마감 시각 = 주기 지터 (히스토그램)
+ * - 작업이 다음 마감을 넘기면 deadline miss, 통째로 지나간 주기는 건너뛰고(skipped) 따라잡지 않습니다.
+ * - 통계는 스케줄러 스레드만 기록합니다. LatencyStats 값은 스레드 종료 후 읽으세요.
+ *   (카운터는 atomic이라 실행 중에도 읽을 수 있음)
+ */
+class ControlScheduler {
+public:
+    /**
+     * @param period_us 주기 (마이크로초, 예: 10000 = 10ms)
+     */
+    explicit ControlScheduler(int64_t period_us);
+
+    /**
+     * @brief 호출한 스레드에 실시간 정책을 적용합니다. (실패해도 경고만 출력하고 계속)
+     * @param fifo_priority 1~99이면 SCHED_FIFO, 0이면 기본 스케줄링 유지
+     * @param cpu 0 이상이면 해당 CPU에 고정, -1이면 고정 안 함
+     * @return 요청한 설정이 모두 적용되면 true
+     */
+    bool configureThread(int fifo_priority, int cpu);
+
+    /**
+     * @brief 기준 시각을 지금으로 잡습니다. (첫 마감 = 지금 + 주기)
+     */
+    void start();
+
+    /**
+     * @brief 다음 주기의 마감 시각까지 잠듭니다.
+     * @return 시작 이후 주기 번호 (1부터, 건너뛴 주기도 번호에 포함)
+     */
+    uint64_t waitNextTick();
+
+    /**
+     * @brief 이번 주기의 작업 끝 (실행 시간 기록, deadline miss 판정)
+     */
+    void endTick();
+
+    int64_t periodUs() const { return m_period_ns / 1000; }
+    uint64_t ticks() const { return m_ticks.load(std::memory_order_relaxed); }
+    uint64_t deadlineMisses() const { return m_misses.load(std::memory_order_relaxed); }
+    uint64_t skippedTicks() const { return m_skipped.load(std::memory_order_relaxed); }
+
+    const LatencyStats& wakeJitter() const { return m_jitter; }
+    const LatencyStats& execTime() const { return m_exec; }
+
+    /**
+     * @brief 지터/실행 시간/deadline miss 요약 출력
+     */
+    void printStats(const char* tag, FILE* out = stdout) const;
+
+private:
+    int64_t m_period_ns;
+    int64_t m_deadline_ns;   // 현재 주기의 마감 시각 (CLOCK_MONOTONIC ns)
+    int64_t m_wake_ns;       // 현재 주기에 실제로 깨어난 시각
+    uint64_t m_tick;
+
+    std::atomic<uint64_t> m_ticks{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_skipped{0};
+
+    LatencyStats m_jitter;   // 깨어난 시각 - 마감 시각 (ms)
+    LatencyStats m_exec;     // 작업 실행 시간 (ms)
+};
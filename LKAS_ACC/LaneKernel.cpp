@@ -0,0 +1,410 @@
+#include "LaneKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LANE_KERNEL_NEON 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define LANE_KERNEL_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define LANE_KERNEL_SSE2 1
+#endif
+
+static const int HSV_SHIFT = 12;
+static const int HSV_ROUND = 1 << (HSV_SHIFT - 1);
+static const int HUE_RANGE = 180;
+
+// dst[i] = min(a[i], b[i]) 또는 max(a[i], b[i])
+static void minmax_u8(const uint8_t* a, const uint8_t* b, uint8_t* dst, int n, bool is_max) {
+    int i = 0;
+#if defined(LANE_KERNEL_NEON)
+    if (is_max) {
+        for (; i + 16 <= n; i += 16) vst1q_u8(dst + i, vmaxq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+    } else {
+        for (; i + 16 <= n; i += 16) vst1q_u8(dst + i, vminq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+    }
+#elif defined(LANE_KERNEL_AVX2)
+    for (; i + 32 <= n; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), is_max ? _mm256_max_epu8(va, vb) : _mm256_min_epu8(va, vb));
+    }
+#elif defined(LANE_KERNEL_SSE2)
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(dst + i), is_max ? _mm_max_epu8(va, vb) : _mm_min_epu8(va, vb));
+    }
+#endif
+    if (is_max) {
+        for (; i < n; i++) dst[i] = std::max(a[i], b[i]);
+    } else {
+        for (; i < n; i++) dst[i] = std::min(a[i], b[i]);
+    }
+}
+
+LaneKernel::LaneKernel()
+    : m_cols(0), m_rows(0), m_final(nullptr), m_mode(LaneThresholdMode::AUTO), m_gateValid(false) {
+    // OpenCV color_hsv의 RGB2HSV_b 테이블과 동일하게 계산 (saturate_cast<int> = 반올림)
+    m_sdiv[0] = m_hdiv[0] = 0;
+    for (int i = 1; i < 256; i++) {
+        m_sdiv[i] = (int)std::lrint((255 << HSV_SHIFT) / (1. * i));
+        m_hdiv[i] = (int)std::lrint((HUE_RANGE << HSV_SHIFT) / (6. * i));
+    }
+}
+
+void LaneKernel::reserve(int cols, int rows) {
+    if (cols == m_cols && rows == m_rows) return;
+    m_cols = cols;
+    m_rows = rows;
+    m_bufA.resize((size_t)cols * rows);
+    m_bufB.resize((size_t)cols * rows);
+    m_line.resize((size_t)cols + 4);   // 최대 반경 2 (5x5) 좌우 패딩
+    m_rowMax.resize((size_t)cols * 3);
+    m_rowMin.resize((size_t)cols * 3);
+    m_rowCount.resize(rows);
+    m_rowSum.resize(rows);
+}
+
+void LaneKernel::buildColorGate(const LaneThreshold& th) {
+    if (m_gateValid && th == m_gateTh) return;   // 트랙바가 바뀔 때만 재계산
+
+    for (int v = 0; v < 256; v++) {
+        int lo = -1, hi = -1;
+        if (v >= th.vmin && v <= th.vmax) {
+            for (int diff = 0; diff <= v; diff++) {
+                int s = (diff * m_sdiv[v] + HSV_ROUND) >> HSV_SHIFT;
+                if (s >= th.smin && s <= th.smax) {
+                    if (lo < 0) lo = diff;
+                    hi = diff;
+                }
+            }
+        }
+        m_gateOk[v] = (lo >= 0) ? 0xFF : 0;
+        m_gateLo[v] = (uint8_t)((lo >= 0) ? lo : 0);
+        m_gateSpan[v] = (uint8_t)((lo >= 0) ? (hi - lo) : 0);
+    }
+    m_gateTh = th;
+    m_gateValid = true;
+}
+
+#if defined(LANE_KERNEL_NEON) && defined(__aarch64__)
+// 256엔트리 바이트 LUT 조회 (64바이트씩 4번 vqtbl/vqtbx)
+static inline uint8x16_t lut256_u8(const uint8x16x4_t* t, uint8x16_t idx) {
+    uint8x16_t r = vqtbl4q_u8(t[0], idx);
+    r = vqtbx4q_u8(r, t[1], vsubq_u8(idx, vdupq_n_u8(64)));
+    r = vqtbx4q_u8(r, t[2], vsubq_u8(idx, vdupq_n_u8(128)));
+    r = vqtbx4q_u8(r, t[3], vsubq_u8(idx, vdupq_n_u8(192)));
+    return r;
+}
+
+static inline void load_lut256(const uint8_t* src, uint8x16x4_t* t) {
+    for (int k = 0; k < 4; k++) {
+        t[k].val[0] = vld1q_u8(src + 64 * k);
+        t[k].val[1] = vld1q_u8(src + 64 * k + 16);
+        t[k].val[2] = vld1q_u8(src + 64 * k + 32);
+        t[k].val[3] = vld1q_u8(src + 64 * k + 48);
+    }
+}
+#endif
+
+// HSV 변환 없이 max(B,G,R), min(B,G,R)과 LUT만으로 판정 (H 범위가 전체일 때 HSV 경로와 동일한 결과)
+void LaneKernel::thresholdColorGate(const uint8_t* bgr, size_t step, int px_step, const LaneThreshold& th, uint8_t* dst) {
+    buildColorGate(th);
+
+    if (px_step != 3) {
+        // 열 샘플링(다운스케일): 픽셀이 연속이 아니므로 스칼라로 처리
+        for (int y = 0; y < m_rows; y++) {
+            const uint8_t* q = bgr + y * step;
+            uint8_t* d = dst + (size_t)y * m_cols;
+            for (int x = 0; x < m_cols; x++, q += px_step) {
+                unsigned v = std::max(q[0], std::max(q[1], q[2]));
+                unsigned diff = v - std::min(q[0], std::min(q[1], q[2]));
+                d[x] = ((uint8_t)(diff - m_gateLo[v]) <= m_gateSpan[v]) ? m_gateOk[v] : 0;
+            }
+        }
+        return;
+    }
+
+#if defined(LANE_KERNEL_NEON) && defined(__aarch64__)
+    uint8x16x4_t tOk[4], tLo[4], tSpan[4];
+    load_lut256(m_gateOk, tOk);
+    load_lut256(m_gateLo, tLo);
+    load_lut256(m_gateSpan, tSpan);
+#else
+    const int n = m_cols * 3;
+    uint8_t* mx = m_rowMax.data();
+    uint8_t* mn = m_rowMin.data();
+#endif
+
+    for (int y = 0; y < m_rows; y++) {
+        const uint8_t* p = bgr + y * step;
+        uint8_t* d = dst + (size_t)y * m_cols;
+        int x = 0;
+
+#if defined(LANE_KERNEL_NEON) && defined(__aarch64__)
+        // 16픽셀씩 B,G,R 분리 로드 → max/min → LUT 3개 조회 → 구간 비교
+        for (; x + 16 <= m_cols; x += 16) {
+            uint8x16x3_t px = vld3q_u8(p + 3 * x);
+            uint8x16_t v  = vmaxq_u8(px.val[0], vmaxq_u8(px.val[1], px.val[2]));
+            uint8x16_t lo = vminq_u8(px.val[0], vminq_u8(px.val[1], px.val[2]));
+            uint8x16_t rel = vsubq_u8(vsubq_u8(v, lo), lut256_u8(tLo, v)); // diff < lo 이면 랩어라운드로 큰 값
+            uint8x16_t in = vcleq_u8(rel, lut256_u8(tSpan, v));
+            vst1q_u8(d + x, vandq_u8(in, lut256_u8(tOk, v)));
+        }
+        for (; x < m_cols; x++) {
+            const uint8_t* q = p + 3 * x;
+            unsigned v = std::max(q[0], std::max(q[1], q[2]));
+            unsigned diff = v - std::min(q[0], std::min(q[1], q[2]));
+            d[x] = ((uint8_t)(diff - m_gateLo[v]) <= m_gateSpan[v]) ? m_gateOk[v] : 0;
+        }
+#else
+        // 바이트 i 위치에 max/min(p[i], p[i+1], p[i+2]) → i=3x 위치가 픽셀 x의 max/min
+        // (B,G,R 분리 없이 연속 바이트에 SIMD 적용)
+        minmax_u8(p, p + 1, mx, n - 1, true);
+        minmax_u8(mx, p + 2, mx, n - 2, true);
+        minmax_u8(p, p + 1, mn, n - 1, false);
+        minmax_u8(mn, p + 2, mn, n - 2, false);
+
+        for (; x < m_cols; x++) {
+            unsigned v = mx[3 * x];
+            unsigned diff = v - mn[3 * x];
+            d[x] = ((uint8_t)(diff - m_gateLo[v]) <= m_gateSpan[v]) ? m_gateOk[v] : 0;
+        }
+#endif
+    }
+}
+
+void LaneKernel::threshold(const uint8_t* bgr, size_t step, int px_step, const LaneThreshold& th, uint8_t* dst) {
+    // H 범위가 전체(0~179)면 색상 계산을 생략
+    const bool need_hue = !th.hueIsFull();
+
+    for (int y = 0; y < m_rows; y++) {
+        const uint8_t* p = bgr + y * step;
+        uint8_t* d = dst + (size_t)y * m_cols;
+        for (int x = 0; x < m_cols; x++, p += px_step) {
+            int b = p[0], g = p[1], r = p[2];
+            int v = std::max(b, std::max(g, r));
+            int vmin = std::min(b, std::min(g, r));
+            int diff = v - vmin;
+            int s = (diff * m_sdiv[v] + HSV_ROUND) >> HSV_SHIFT;
+
+            bool ok = (v >= th.vmin && v <= th.vmax && s >= th.smin && s <= th.smax);
+            if (ok && need_hue) {
+                int vr = (v == r) ? -1 : 0;
+                int vg = (v == g) ? -1 : 0;
+                int h = (vr & (g - b)) +
+                        (~vr & ((vg & (b - r + 2 * diff)) + ((~vg) & (r - g + 4 * diff))));
+                h = (h * m_hdiv[diff] + HSV_ROUND) >> HSV_SHIFT;
+                h += (h < 0) ? HUE_RANGE : 0;
+                ok = (h >= th.hmin && h <= th.hmax);
+            }
+            d[x] = ok ? 255 : 0;
+        }
+    }
+}
+
+// Y가 범위 안이고 |U-128| + |V-128| <= chroma_max 이면 차선
+// 크로마는 가로 2픽셀(YUYV, NV12) / 세로 2행(NV12)이 한 샘플을 공유합니다.
+void LaneKernel::thresholdYUV(LaneYuvLayout layout, const uint8_t* luma, size_t luma_step,
+                              const uint8_t* chroma, size_t chroma_step, int rs, int cs,
+                              const LaneYuvThreshold& th, uint8_t* dst) {
+    const int ymin = th.ymin, ymax = th.ymax, cmax = th.chroma_max;
+
+    for (int y = 0; y < m_rows; y++) {
+        const int ly = y * rs;  // ROI 기준 행
+        uint8_t* d = dst + (size_t)y * m_cols;
+
+        if (layout == LaneYuvLayout::YUYV) {
+            const uint8_t* p = luma + (size_t)ly * luma_step;
+            if (cs == 1) {
+                // 전체 해상도: 크로마 쌍 하나(Y0 U Y1 V)로 두 픽셀 판정
+                int x = 0;
+                for (; x + 1 < m_cols; x += 2, p += 4) {
+                    bool c_ok = std::abs(p[1] - 128) + std::abs(p[3] - 128) <= cmax;
+                    d[x]     = (c_ok && p[0] >= ymin && p[0] <= ymax) ? 255 : 0;
+                    d[x + 1] = (c_ok && p[2] >= ymin && p[2] <= ymax) ? 255 : 0;
+                }
+                if (x < m_cols) {
+                    bool c_ok = std::abs(p[1] - 128) + std::abs(p[3] - 128) <= cmax;
+                    d[x] = (c_ok && p[0] >= ymin && p[0] <= ymax) ? 255 : 0;
+                }
+            } else {
+                for (int x = 0; x < m_cols; x++) {
+                    int sx = x * cs;
+                    const uint8_t* c = p + 4 * (sx >> 1);
+                    int yv = p[2 * sx];
+                    bool ok = yv >= ymin && yv <= ymax &&
+                              std::abs(c[1] - 128) + std::abs(c[3] - 128) <= cmax;
+                    d[x] = ok ? 255 : 0;
+                }
+            }
+        } else {
+            const uint8_t* yp = luma + (size_t)ly * luma_step;
+            const uint8_t* cp = chroma + (size_t)(ly >> 1) * chroma_step;
+            for (int x = 0; x < m_cols; x++) {
+                int sx = x * cs;
+                const uint8_t* c = cp + 2 * (sx >> 1);
+                int yv = yp[sx];
+                bool ok = yv >= ymin && yv <= ymax &&
+                          std::abs(c[0] - 128) + std::abs(c[1] - 128) <= cmax;
+                d[x] = ok ? 255 : 0;
+            }
+        }
+    }
+}
+
+// 한 결과 행의 (2rx+1)x(2ry+1) 사각 커널 erode(min) / dilate(max)
+// in[0..n-1]: 커널이 덮는 입력 행들 (영상 위아래 밖의 행은 빠져 있음)
+// OpenCV 기본 경계(morphologyDefaultBorderValue)는 영상 밖 픽셀을 무시하는 것과 같고,
+// min/max에서는 이것이 가장자리 복제(replicate)와 결과가 같으므로 가로는 가장자리 값으로 패딩합니다.
+void LaneKernel::morphRow(const uint8_t* const* in, int n, uint8_t* dst, int rx, bool is_max) {
+    const int cols = m_cols;
+    uint8_t* line = m_line.data() + rx;  // line[-rx .. cols+rx-1] 사용
+
+    // (1) 세로 방향: 입력 행들의 min/max
+    memcpy(line, in[0], cols);
+    for (int k = 1; k < n; k++) minmax_u8(line, in[k], line, cols, is_max);
+
+    // (2) 가로 방향: 좌우 패딩을 가장자리 값으로 채운 뒤 이동하며 min/max
+    if (rx == 0) {
+        memcpy(dst, line, cols);
+        return;
+    }
+    for (int k = 1; k <= rx; k++) {
+        line[-k] = line[0];
+        line[cols - 1 + k] = line[cols - 1];
+    }
+    minmax_u8(line - rx, line - rx + 1, dst, cols, is_max);
+    for (int k = 2; k <= 2 * rx; k++) minmax_u8(dst, line - rx + k, dst, cols, is_max);
+}
+
+// 최종 마스크(0/255) 한 행의 모멘트와 행별 합 누적 (x좌표는 원본 ROI 기준 = x * x_scale)
+void LaneKernel::accumulateRow(int y, const uint8_t* d, int x_scale, LaneMoments& out) {
+    uint32_t cnt = 0, sx = 0;
+    for (int x = 0; x < m_cols; x++) {
+        uint32_t m = d[x] & 1;
+        cnt += m;
+        sx += m * (uint32_t)(x * x_scale);
+    }
+    m_rowCount[y] = cnt;
+    m_rowSum[y] = sx;
+    out.m00 += cnt;
+    out.m10 += sx;
+}
+
+void LaneKernel::process(const uint8_t* bgr, size_t step, int cols, int rows,
+                         const LaneThreshold& th, LaneMoments& out,
+                         const LaneSampling& sampling) {
+    out = LaneMoments();
+    const int rs = std::max(1, sampling.row_step);
+    const int cs = std::max(1, sampling.col_step);
+    reserve((cols + cs - 1) / cs, (rows + rs - 1) / rs);
+    if (m_cols <= 0 || m_rows <= 0) { m_final = m_bufA.data(); return; }
+
+    // 샘플 격자: 행 간격 step*rs, 픽셀 간격 3*cs 바이트
+    if (m_mode == LaneThresholdMode::AUTO && th.hueIsFull()) {
+        thresholdColorGate(bgr, step * rs, 3 * cs, th, m_bufA.data());
+    } else {
+        threshold(bgr, step * rs, 3 * cs, th, m_bufA.data());
+    }
+    filter(sampling, out);
+}
+
+void LaneKernel::processYUV(LaneYuvLayout layout, const uint8_t* luma, size_t luma_step,
+                            const uint8_t* chroma, size_t chroma_step, int cols, int rows,
+                            const LaneYuvThreshold& th, LaneMoments& out,
+                            const LaneSampling& sampling) {
+    out = LaneMoments();
+    const int rs = std::max(1, sampling.row_step);
+    const int cs = std::max(1, sampling.col_step);
+    reserve((cols + cs - 1) / cs, (rows + rs - 1) / rs);
+    if (m_cols <= 0 || m_rows <= 0) { m_final = m_bufA.data(); return; }
+
+    thresholdYUV(layout, luma, luma_step, chroma, chroma_step, rs, cs, th, m_bufA.data());
+    filter(sampling, out);
+}
+
+// m_bufA의 임계값 마스크 → OPEN → CLOSE → 모멘트를 한 번의 행 스트리밍으로 처리해 m_bufB에 최종 마스크
+//
+// 단계 k의 결과 행 y는 앞 단계의 행 y-ry .. y+ry만 필요하므로, 단계 사이에는 다음 단계 커널 높이
+// (2ry+1)만큼의 행만 링 버퍼로 둡니다. 단계 k는 누적 지연 lag_k = ry_0 + .. + ry_k 만큼 늦게 따라가며
+// (시각 t에 행 t - lag_k 생산), 같은 시각에 앞 단계가 행 t - lag_k + ry_k 까지 만들어 두므로
+// ROI의 각 행은 단계마다 한 번씩만 계산되고 중간 결과는 몇 행짜리 링(L1)에만 머뭅니다.
+void LaneKernel::filter(const LaneSampling& sampling, LaneMoments& out) {
+    const int cols = m_cols, rows = m_rows;
+    const int cs = std::max(1, sampling.col_step);
+    const int ro = std::max(0, sampling.open_radius);
+    const int rc = std::max(0, sampling.close_radius);
+    const int vy = sampling.vertical ? 1 : 0;
+    const int rmax = std::max(ro, rc);
+    if (m_line.size() < (size_t)cols + 2 * rmax) m_line.resize((size_t)cols + 2 * rmax);
+    if (m_rowPtr.size() < (size_t)2 * rmax + 1) m_rowPtr.resize((size_t)2 * rmax + 1);
+
+    // OPEN (기본 3x3) = erode → dilate, CLOSE (기본 5x5) = dilate → erode
+    struct Stage { int rx, ry; bool is_max; uint8_t* ring; int ring_rows; int lag; };
+    Stage st[4];
+    int ns = 0;
+    if (ro > 0) {
+        st[ns++] = {ro, ro * vy, false, nullptr, 0, 0};
+        st[ns++] = {ro, ro * vy, true, nullptr, 0, 0};
+    }
+    if (rc > 0) {
+        st[ns++] = {rc, rc * vy, true, nullptr, 0, 0};
+        st[ns++] = {rc, rc * vy, false, nullptr, 0, 0};
+    }
+
+    const uint8_t* a = m_bufA.data();
+    uint8_t* b = m_bufB.data();
+    if (ns == 0) {
+        for (int y = 0; y < rows; y++) accumulateRow(y, a + (size_t)y * cols, cs, out);
+        m_final = a;
+        return;
+    }
+
+    // 마지막 단계를 제외한 각 단계의 결과 링: 다음 단계 커널 높이만큼의 행
+    size_t ring_size = 0;
+    for (int k = 0; k + 1 < ns; k++) {
+        st[k].ring_rows = std::min(rows, 2 * st[k + 1].ry + 1);
+        ring_size += (size_t)st[k].ring_rows * cols;
+    }
+    if (m_ring.size() < ring_size) m_ring.resize(ring_size);
+    uint8_t* r = m_ring.data();
+    int lag = 0;
+    for (int k = 0; k < ns; k++) {
+        lag += st[k].ry;
+        st[k].lag = lag;
+        if (k + 1 < ns) {
+            st[k].ring = r;
+            r += (size_t)st[k].ring_rows * cols;
+        }
+    }
+
+    const uint8_t** in = m_rowPtr.data();   // 커널이 덮는 입력 행
+    for (int t = 0; t < rows + lag; t++) {
+        for (int k = 0; k < ns; k++) {
+            const int y = t - st[k].lag;
+            if (y < 0 || y >= rows) continue;
+            const int y_lo = std::max(0, y - st[k].ry);
+            const int y_hi = std::min(rows - 1, y + st[k].ry);
+            int n = 0;
+            for (int yy = y_lo; yy <= y_hi; yy++) {
+                in[n++] = (k == 0) ? a + (size_t)yy * cols
+                                   : st[k - 1].ring + (size_t)(yy % st[k - 1].ring_rows) * cols;
+            }
+            if (k + 1 < ns) {
+                morphRow(in, n, st[k].ring + (size_t)(y % st[k].ring_rows) * cols, st[k].rx, st[k].is_max);
+            } else {
+                uint8_t* d = b + (size_t)y * cols;
+                morphRow(in, n, d, st[k].rx, st[k].is_max);
+                accumulateRow(y, d, cs, out);
+            }
+        }
+    }
+    m_final = b;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// HSV 임계값 (OpenCV 8비트 HSV 범위: H 0~179, S/V 0~255)
+struct LaneThreshold {
+    int hmin = 0, hmax = 179;
+    int smin = 0, smax = 80;
+    int vmin = 200, vmax = 255;
+
+    bool operator==(const LaneThreshold& o) const {
+        return hmin == o.hmin && hmax == o.hmax && smin == o.smin &&
+               smax == o.smax && vmin == o.vmin && vmax == o.vmax;
+    }
+    bool operator!=(const LaneThreshold& o) const { return !(*this == o); }
+
+    // H 범위가 전체(0~179)이면 색상(Hue)은 판정에 영향이 없음
+    bool hueIsFull() const { return hmin <= 0 && hmax >= 179; }
+};
+
+// YUV 임계값: 차선(흰색) = 밝고(Y 높음) 무채색(U, V가 128 근처)
+struct LaneYuvThreshold {
+    int ymin = 180, ymax = 255;
+    int chroma_max = 40;    // |U-128| + |V-128| 최대값
+};
+
+// YUV 입력 배치
+enum class LaneYuvLayout {
+    YUYV,   // packed 4:2:2 (Y0 U Y1 V), luma 포인터 하나만 사용
+    NV12,   // Y 평면 + UV interleave 평면 (4:2:0)
+};
+
+// 임계값 판정 방식
+enum class LaneThresholdMode {
+    AUTO,   // H 범위가 전체면 컬러 게이트, 좁혀졌을 때만 HSV 변환
+    HSV,    // 항상 픽셀마다 HSV(S, H) 계산
+};
+
+// 이진 마스크의 모멘트 (전체 해상도에서는 cv::moments(mask, true)의 m00, m10과 동일)
+// 샘플링 시에도 x좌표는 원본 ROI 좌표 기준이며, m00은 실제로 검사한 샘플 수입니다.
+struct LaneMoments {
+    uint64_t m00 = 0;   // 차선 픽셀(샘플) 수
+    uint64_t m10 = 0;   // 차선 픽셀 x좌표 합
+};
+
+// 샘플링 설정: 정확도 대신 처리량을 얻기 위한 옵션
+struct LaneSampling {
+    int row_step = 1;       // N행마다 1행만 처리 (ROI 기준)
+    int col_step = 1;       // N열마다 1열만 처리 (row_step과 같으면 1/N 다운스케일)
+    int open_radius = 1;    // OPEN 커널 반경 (샘플 격자 기준, 0이면 생략)
+    int close_radius = 2;   // CLOSE 커널 반경 (샘플 격자 기준, 0이면 생략)
+    bool vertical = true;   // false이면 세로 방향 모폴로지 생략 (행 샘플링 시 행끼리 인접하지 않음)
+};
+
+/**
+ * @brief ROI 전용 LKAS 커널 (BGR→HSV 또는 YUV 임계값 → 3x3 OPEN → 5x5 CLOSE → 모멘트)
+ *
+ * 기존 OpenCV 경로(cvtColor + inRange 전체 프레임 → ROI clone → morphologyEx x2 → moments)와
+ * 비트 단위로 같은 마스크/모멘트를 만들되,
+ *  - ROI 행만 임계값 처리하고 (H 범위가 전체면 HSV 변환 없이 max/min + LUT 컬러 게이트)
+ *  - 임계값 마스크 한 번 만든 뒤, OPEN/CLOSE 4단계를 행 단위로 흘려 보내며 (단계 사이에는
+ *    커널 높이만큼의 행 링 버퍼만 두므로 ROI의 각 행은 단계마다 한 번만 계산)
+ *  - 마지막 단계가 행을 쓰는 즉시 모멘트(+ 행별 합)를 누적합니다. (프레임 크기가 같으면 할당 없음)
+ * LaneSampling으로 N행마다 / 1/N 다운스케일 격자만 처리해 정확도 대신 CPU 시간을 줄일 수 있습니다.
+ * 모폴로지는 min/max 분리 필터로 구현하며 NEON / AVX2 / SSE2로 벡터화됩니다.
+ *
+ * OpenCV에 의존하지 않으므로 cv::Mat 없이도 사용할 수 있습니다.
+ */
+class LaneKernel {
+public:
+    LaneKernel();
+
+    /**
+     * @brief ROI 영역(BGR 8UC3)을 처리합니다.
+     * @param bgr ROI 첫 행의 시작 포인터
+     * @param step 행 간격 (바이트)
+     * @param cols ROI 폭 (픽셀)
+     * @param rows ROI 높이 (픽셀)
+     * @param th HSV 임계값
+     * @param out 모멘트 결과
+     * @param sampling 행/열 샘플링 설정 (기본값: 전체 해상도, 기존 OpenCV 경로와 동일)
+     */
+    void process(const uint8_t* bgr, size_t step, int cols, int rows,
+                 const LaneThreshold& th, LaneMoments& out,
+                 const LaneSampling& sampling = LaneSampling());
+
+    /**
+     * @brief ROI 영역(YUYV 또는 NV12)을 처리합니다. (HSV 변환 없이 Y / 크로마 거리로 판정)
+     * @param layout YUYV 또는 NV12
+     * @param luma YUYV: ROI 첫 행의 packed 포인터 / NV12: ROI 첫 행의 Y 평면 포인터
+     * @param luma_step luma 행 간격 (바이트)
+     * @param chroma NV12: ROI 첫 행에 해당하는 UV 평면 행 포인터 (YUYV면 nullptr)
+     * @param chroma_step UV 평면 행 간격 (바이트)
+     * @param cols ROI 폭 (픽셀, 시작 x는 짝수여야 크로마 쌍이 맞음)
+     * @param rows ROI 높이 (픽셀, NV12는 ROI 시작 행이 짝수여야 함)
+     * @param th YUV 임계값
+     * @param out 모멘트 결과
+     * @param sampling 행/열 샘플링 설정
+     */
+    void processYUV(LaneYuvLayout layout, const uint8_t* luma, size_t luma_step,
+                    const uint8_t* chroma, size_t chroma_step, int cols, int rows,
+                    const LaneYuvThreshold& th, LaneMoments& out,
+                    const LaneSampling& sampling = LaneSampling());
+
+    /**
+     * @brief 마지막 process()의 최종 마스크 (0/255, 샘플 격자 크기, 행 간격 = cols())
+     */
+    const uint8_t* mask() const { return m_final; }
+    int cols() const { return m_cols; }
+    int rows() const { return m_rows; }
+
+    /**
+     * @brief 마지막 process()의 샘플 행별 차선 픽셀 수 / x좌표 합 (rows()개)
+     */
+    const uint32_t* rowCount() const { return m_rowCount.data(); }
+    const uint32_t* rowSum() const { return m_rowSum.data(); }
+
+    /**
+     * @brief 임계값 판정 방식 설정 (기본: AUTO)
+     */
+    void setThresholdMode(LaneThresholdMode mode) { m_mode = mode; }
+
+private:
+    void reserve(int cols, int rows);
+    void threshold(const uint8_t* bgr, size_t step, int px_step, const LaneThreshold& th, uint8_t* dst);
+    void thresholdColorGate(const uint8_t* bgr, size_t step, int px_step, const LaneThreshold& th, uint8_t* dst);
+    void thresholdYUV(LaneYuvLayout layout, const uint8_t* luma, size_t luma_step,
+                      const uint8_t* chroma, size_t chroma_step, int rs, int cs,
+                      const LaneYuvThreshold& th, uint8_t* dst);
+    void buildColorGate(const LaneThreshold& th);
+    void filter(const LaneSampling& sampling, LaneMoments& out);
+    void morphRow(const uint8_t* const* in, int n, uint8_t* dst, int rx, bool is_max);
+    void accumulateRow(int y, const uint8_t* d, int x_scale, LaneMoments& out);
+
+    int m_cols, m_rows;
+    std::vector<uint32_t> m_rowCount, m_rowSum;
+    std::vector<uint8_t> m_bufA, m_bufB;   // 임계값 마스크 / 최종 마스크
+    std::vector<uint8_t> m_ring;           // 모폴로지 단계 사이 행 링 버퍼
+    std::vector<const uint8_t*> m_rowPtr;  // 커널이 덮는 입력 행 포인터
+    std::vector<uint8_t> m_line;           // 세로 방향 결과 + 좌우 패딩
+    std::vector<uint8_t> m_rowMax, m_rowMin; // 컬러 게이트용 행 단위 max/min(B,G,R)
+    const uint8_t* m_final;
+    LaneThresholdMode m_mode;
+
+    // 컬러 게이트 LUT: V=max(B,G,R)마다 통과하는 diff=max-min 구간 [lo, lo+span]
+    // (S = diff*255/V 는 V가 고정이면 diff에 대해 단조 증가하므로 구간 하나로 표현됨)
+    uint8_t m_gateOk[256];     // 0xFF: 통과 가능한 diff가 있음, 0: 이 V는 항상 탈락
+    uint8_t m_gateLo[256];
+    uint8_t m_gateSpan[256];
+    LaneThreshold m_gateTh;
+    bool m_gateValid;
+
+    // OpenCV RGB2HSV_b와 동일한 나눗셈 테이블 (hsv_shift = 12)
+    int m_sdiv[256];
+    int m_hdiv[256];
+};
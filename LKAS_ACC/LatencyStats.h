@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/**
+ * @brief 지연 시간(ms) 통계를 위한 고정 구간 히스토그램
+ *
+ * - 버킷은 생성자에서 한 번만 할당되며, add()는 할당 없이 O(1)입니다.
+ * - 한 스레드에서만 add() 하도록 사용합니다. (스레드마다 별도 인스턴스)
+ * - 범위를 넘는 값은 마지막 버킷(overflow)에 모이고, max는 그대로 기록됩니다.
+ */
+class LatencyStats {
+public:
+    /**
+     * @param bin_ms 버킷 하나의 폭 (ms)
+     * @param num_bins 버킷 개수 (범위 = bin_ms * num_bins)
+     */
+    explicit LatencyStats(double bin_ms = 0.5, int num_bins = 1000)
+        : m_bin_ms(bin_ms), m_bins(num_bins + 1, 0) {}
+
+    void add(double ms) {
+        if (ms < 0.0) ms = 0.0;
+        int idx = (int)(ms / m_bin_ms);
+        if (idx >= (int)m_bins.size() - 1) idx = (int)m_bins.size() - 1;
+        m_bins[idx]++;
+        m_count++;
+        m_sum += ms;
+        m_max = std::max(m_max, ms);
+    }
+
+    void reset() {
+        std::fill(m_bins.begin(), m_bins.end(), 0);
+        m_count = 0; m_sum = 0.0; m_max = 0.0;
+    }
+
+    uint64_t count() const { return m_count; }
+    double mean() const { return m_count ? m_sum / m_count : 0.0; }
+    double max() const { return m_max; }
+
+    /**
+     * @brief 백분위수 (버킷 상한값 기준)
+     * @param p 0.0 ~ 1.0 (예: 0.99)
+     */
+    double percentile(double p) const {
+        if (m_count == 0) return 0.0;
+        uint64_t target = (uint64_t)(p * m_count);
+        if (target >= m_count) target = m_count - 1;
+        uint64_t acc = 0;
+        for (size_t i = 0; i < m_bins.size(); i++) {
+            acc += m_bins[i];
+            if (acc > target) {
+                return std::min(m_max, (i + 1) * m_bin_ms);
+            }
+        }
+        return m_max;
+    }
+
+    /**
+     * @brief 한 줄 요약 출력 (예: "[LAT] vision  n=120 avg=8.1 p50=7.5 p99=15.0 max=21.3 ms")
+     */
+    void print(const char* tag, FILE* out = stdout) const {
+        fprintf(out, "[LAT] %-14s n=%llu avg=%.2f p50=%.2f p99=%.2f max=%.2f ms\n",
+                tag, (unsigned long long)m_count, mean(),
+                percentile(0.50), percentile(0.99), m_max);
+    }
+
+    /**
+     * @brief 히스토그램 출력 (bucket_ms 폭으로 다시 묶어 비어 있지 않은 구간만)
+     *        (예: "[HIST] frame_age  [ 10.0,  15.0) ms   412 ########")
+     */
+    void printHistogram(const char* tag, double bucket_ms, FILE* out = stdout) const {
+        if (m_count == 0) return;
+        int per = std::max(1, (int)(bucket_ms / m_bin_ms + 0.5));
+        uint64_t peak = 0;
+        for (size_t i = 0; i < m_bins.size(); i += per) {
+            uint64_t n = 0;
+            for (size_t j = i; j < std::min(m_bins.size(), i + per); j++) n += m_bins[j];
+            peak = std::max(peak, n);
+        }
+        for (size_t i = 0; i < m_bins.size(); i += per) {
+            uint64_t n = 0;
+            for (size_t j = i; j < std::min(m_bins.size(), i + per); j++) n += m_bins[j];
+            if (n == 0) continue;
+            int bar = (int)(40 * n / peak);
+            // 마지막 버킷(overflow)은 상한 없음
+            double hi = (i + per >= m_bins.size()) ? m_max : (i + per) * m_bin_ms;
+            fprintf(out, "[HIST] %-14s [%6.1f, %6.1f%c ms %8llu %.*s\n", tag, i * m_bin_ms, hi,
+                    (i + per >= m_bins.size()) ? ']' : ')',
+                    (unsigned long long)n, bar, "########################################");
+        }
+    }
+
+private:
+    double m_bin_ms;
+    std::vector<uint64_t> m_bins;
+    uint64_t m_count = 0;
+    double m_sum = 0.0;
+    double m_max = 0.0;
+};
@@ -0,0 +1,103 @@
+#include "RangeTracker.h"
+#include <cmath>
+#include <algorithm>
+
+static const double INIT_RATE_SIGMA_MPS = 1.0;  // 첫 샘플의 변화율 불확실성 (차량 최대 속도 수준)
+static const double MIN_CLOSING_MPS = 0.02;     // 이보다 느리게 가까워지면 TTC 없음 (정지로 봄)
+static const double NO_TTC_S = 1e9;
+
+RangeTracker::RangeTracker(double meas_sigma_m, double accel_sigma,
+                           double gate_sigma, int max_rejects, double max_gap_s)
+    : m_r(meas_sigma_m * meas_sigma_m),
+      m_q(accel_sigma * accel_sigma),
+      m_gate2(gate_sigma * gate_sigma),
+      m_max_rejects(max_rejects),
+      m_max_gap_s(max_gap_s),
+      m_valid(false), m_t_ns(0),
+      m_x0(0.0), m_x1(0.0),
+      m_p00(0.0), m_p01(0.0), m_p11(0.0),
+      m_reject_run(0),
+      m_updates(0), m_rejected(0), m_restarts(0) {}
+
+void RangeTracker::reset() {
+    m_valid = false;
+    m_reject_run = 0;
+}
+
+void RangeTracker::init(int64_t t_ns, double range_m) {
+    m_valid = true;
+    m_t_ns = t_ns;
+    m_x0 = range_m;
+    m_x1 = 0.0;
+    m_p00 = m_r;
+    m_p01 = 0.0;
+    m_p11 = INIT_RATE_SIGMA_MPS * INIT_RATE_SIGMA_MPS;
+    m_reject_run = 0;
+}
+
+bool RangeTracker::update(int64_t t_ns, double range_m) {
+    if (range_m <= 0.0) return false;
+    if (!m_valid) {
+        init(t_ns, range_m);
+        m_updates++;
+        return true;
+    }
+    if (t_ns <= m_t_ns) return false;   // 같은 샘플 / 순서 뒤바뀜
+
+    const double dt = (t_ns - m_t_ns) * 1e-9;
+    if (dt > m_max_gap_s) {
+        init(t_ns, range_m);
+        m_restarts++;
+        m_updates++;
+        return true;
+    }
+
+    // 예측: x = F x, P = F P F' + Q (연속 백색 가속도 잡음)
+    const double dt2 = dt * dt;
+    const double x0 = m_x0 + m_x1 * dt;
+    const double p00 = m_p00 + dt * (2.0 * m_p01 + dt * m_p11) + m_q * dt2 * dt / 3.0;
+    const double p01 = m_p01 + dt * m_p11 + m_q * dt2 / 2.0;
+    const double p11 = m_p11 + m_q * dt;
+
+    // 게이팅: 튀는 값은 상태에 반영하지 않음 (연속되면 새 물체로 재시작)
+    const double y = range_m - x0;
+    const double s = p00 + m_r;
+    if (y * y > m_gate2 * s) {
+        m_rejected++;
+        if (++m_reject_run >= m_max_rejects) {
+            init(t_ns, range_m);
+            m_restarts++;
+            m_updates++;
+            return true;
+        }
+        return false;
+    }
+
+    // 갱신
+    const double k0 = p00 / s;
+    const double k1 = p01 / s;
+    m_x0 = x0 + k0 * y;
+    m_x1 = m_x1 + k1 * y;
+    m_p00 = (1.0 - k0) * p00;
+    m_p01 = (1.0 - k0) * p01;
+    m_p11 = p11 - k1 * p01;
+    m_t_ns = t_ns;
+    m_reject_run = 0;
+    m_updates++;
+    return true;
+}
+
+RangeEstimate RangeTracker::estimate(int64_t now_ns) const {
+    RangeEstimate e;
+    if (!m_valid) return e;
+
+    const double dt = now_ns > m_t_ns ? (now_ns - m_t_ns) * 1e-9 : 0.0;
+    e.valid = true;
+    e.t_ns = now_ns;
+    e.rate_mps = m_x1;
+    e.range_m = std::max(0.0, m_x0 + m_x1 * dt);
+    double p00 = m_p00 + dt * (2.0 * m_p01 + dt * m_p11) + m_q * dt * dt * dt / 3.0;
+    e.range_sigma_m = std::sqrt(std::max(0.0, p00));
+    e.ttc_s = (m_x1 < -MIN_CLOSING_MPS) ? e.range_m / -m_x1 : NO_TTC_S;
+    return e;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief RangeTracker가 내놓는 전방 물체 추정값
+ */
+struct RangeEstimate {
+    bool valid = false;        // 초기화된 트랙이 있는지 (없으면 나머지 값은 의미 없음)
+    double range_m = 0.0;      // 거리 (m)
+    double rate_mps = 0.0;     // 거리 변화율 (m/s, 음수 = 가까워짐)
+    double ttc_s = 1e9;        // 충돌까지 남은 시간 (s, 멀어지거나 정지면 1e9)
+    double range_sigma_m = 0.0; // 거리 추정 표준편차 (m)
+    int64_t t_ns = 0;          // 추정 시각 (CLOCK_MONOTONIC ns)
+};
+
+/**
+ * @brief 등속 모델 칼만 필터로 ToF 거리/거리 변화율/TTC를 추정합니다.
+ *
+ * - 상태 [거리, 변화율], 측정은 거리 하나. 샘플마다 커널 수신 타임스탬프(rx_ns)를 받아
+ *   실제 간격으로 예측하므로 CAN 지터/누락이 있어도 변화율이 흔들리지 않습니다.
+ * - 혁신(innovation)이 gate_sigma를 넘는 샘플은 튀는 값으로 버리고,
+ *   max_rejects번 연속으로 버려지면 물체가 바뀐 것으로 보고 새 측정값으로 다시 시작합니다.
+ * - 샘플 간격이 max_gap_s보다 길면 (센서 끊김) 이전 트랙을 버리고 다시 시작합니다.
+ * - 할당/시스템 콜 없음 (제어 스레드에서 매 주기 호출)
+ */
+class RangeTracker {
+public:
+    /**
+     * @param meas_sigma_m ToF 측정 잡음 표준편차 (m)
+     * @param accel_sigma 물체 상대 가속도 표준편차 (m/s^2, 클수록 변화율이 빨리 따라감)
+     * @param gate_sigma 이상값 판정 기준 (혁신 / 혁신 표준편차)
+     * @param max_rejects 연속 이상값이 이 횟수에 도달하면 재초기화
+     * @param max_gap_s 이보다 긴 샘플 간격이면 재초기화 (s)
+     */
+    explicit RangeTracker(double meas_sigma_m = 0.015, double accel_sigma = 1.5,
+                          double gate_sigma = 5.0, int max_rejects = 3, double max_gap_s = 0.5);
+
+    /**
+     * @brief 트랙 삭제 (ToF가 끊겼을 때)
+     */
+    void reset();
+
+    /**
+     * @brief 측정값 반영
+     * @param t_ns 측정 시각 (CLOCK_MONOTONIC ns, 커널 수신 타임스탬프)
+     * @param range_m 측정 거리 (m, 0 이하는 무효 측정으로 무시)
+     * @return 반영했으면 true (이상값/무효/과거 시각이면 false)
+     */
+    bool update(int64_t t_ns, double range_m);
+
+    /**
+     * @brief now_ns까지 예측한 추정값 (상태는 바꾸지 않음)
+     */
+    RangeEstimate estimate(int64_t now_ns) const;
+
+    uint32_t updates() const { return m_updates; }
+    uint32_t rejected() const { return m_rejected; }
+    uint32_t restarts() const { return m_restarts; }
+
+private:
+    void init(int64_t t_ns, double range_m);
+
+    // 파라미터
+    double m_r;                 // 측정 분산 (m^2)
+    double m_q;                 // 가속도 분산 (m^2/s^4)
+    double m_gate2;             // gate_sigma^2
+    int m_max_rejects;
+    double m_max_gap_s;
+
+    // 상태
+    bool m_valid;
+    int64_t m_t_ns;
+    double m_x0, m_x1;          // 거리, 변화율
+    double m_p00, m_p01, m_p11; // 공분산 (대칭)
+    int m_reject_run;
+
+    // 통계
+    uint32_t m_updates;
+    uint32_t m_rejected;
+    uint32_t m_restarts;
+};
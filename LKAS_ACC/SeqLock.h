@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief 단일 작성자 / 다중 독자용 seqlock 스냅샷
+ *
+ * - 작성자는 store()만, 독자는 load()/try_load()만 호출합니다. (작성자 스레드는 하나)
+ * - 독자는 락/시스템 콜 없이 항상 일관된(찢어지지 않은) 최신 값을 얻습니다.
+ *   작성 중이면 다시 읽으므로 작성자가 독자를 기다리지 않습니다.
+ * - 값은 8바이트 atomic 워드 배열에 나눠 저장하므로 읽기/쓰기 경합이 데이터 레이스가 아닙니다.
+ *
+ * @tparam T 저장할 타입 (trivially copyable, 작은 구조체 권장)
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock: T는 trivially copyable이어야 합니다.");
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+    SeqLock() { store(T{}); m_seq.store(0, std::memory_order_relaxed); }
+
+    /**
+     * @brief 새 값을 게시합니다. (작성자 전용)
+     */
+    void store(const T& value) {
+        uint64_t buf[WORDS] = {};
+        memcpy(buf, &value, sizeof(T));
+        const uint32_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);       // 홀수: 작성 중
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) m_data[i].store(buf[i], std::memory_order_relaxed);
+        m_seq.store(seq + 2, std::memory_order_release);       // 짝수: 완료
+    }
+
+    /**
+     * @brief 최신 값을 한 번 읽어 봅니다. 작성 중이었으면 false (독자 전용)
+     */
+    bool try_load(T& out) const {
+        const uint32_t s0 = m_seq.load(std::memory_order_acquire);
+        if (s0 & 1) return false;
+        uint64_t buf[WORDS];
+        for (size_t i = 0; i < WORDS; i++) buf[i] = m_data[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_seq.load(std::memory_order_relaxed) != s0) return false;
+        memcpy(&out, buf, sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief 일관된 최신 값을 읽습니다. (작성 중이면 끝날 때까지 다시 읽음)
+     */
+    T load() const {
+        T out;
+        while (!try_load(out)) {}
+        return out;
+    }
+
+    /**
+     * @brief 게시 횟수 (값이 바뀌었는지 확인용)
+     */
+    uint32_t version() const { return m_seq.load(std::memory_order_acquire) / 2; }
+
+private:
+    alignas(64) std::atomic<uint32_t> m_seq{0};
+    std::atomic<uint64_t> m_data[WORDS];
+};
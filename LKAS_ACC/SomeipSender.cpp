@@ -1,23 +1,78 @@
 #include "SomeipSender.h"
 #include <iostream>
-#include <vector>
 #include <cstring>  // C 표준 (memset, memcpy)
 #include <unistd.h> // C 표준 (close)
 #include <cstdint>  // C 표준 (uint8_t, uint32_t)
+#include <chrono>
+#include <cerrno>
+#include <ctime>
+#include <sys/uio.h> // iovec
+#include <poll.h>
+#include <algorithm>
 
 // SOME/IP 헤더 상수 (lkas_someip.cpp에서 가져옴)
 static const uint16_t CLIENT_ID        = 0x1111;
 static const uint8_t  IFACE_VER        = 0x01;
 static const uint8_t  PROTO_VER        = 0x01;
 static const uint8_t  MSG_TYPE_REQUEST = 0x00;
+static const uint8_t  MSG_TYPE_RESPONSE= 0x80;
 static const uint8_t  RET_OK           = 0x00;
 static const uint16_t SERVICE_ID_COMMON= 0x0100;
 static const uint16_t METHOD_ID_MOTOR  = 0x0201;
 
-SomeipSender::SomeipSender(): sock_(-1), session_(1) {}
+// SOME/IP-SD (TC375 someip.c의 SOMEIPSD_SendOfferService/SOMEIPSD_Recv_Callback과 맞춤)
+static const uint16_t SD_PORT          = 30490;  // PN_SOMEIPSD
+static const uint32_t SD_MSG_ID        = 0xFFFF8100;
+static const uint8_t  MSG_TYPE_NOTIFY  = 0x02;
+static const uint8_t  SD_FLAGS         = 0xC0;   // reboot | unicast
+static const uint8_t  SD_ENTRY_FIND    = 0x00;
+static const uint8_t  SD_ENTRY_OFFER   = 0x01;
+static const uint8_t  SD_OPT_IPV4_EP   = 0x04;
+static const uint8_t  L4_PROTO_UDP     = 0x11;
+static const uint32_t SD_FIND_TTL      = 3;      // 초
+
+// Big-Endian 정수 변환
+static inline void be16(uint8_t* p, uint16_t v) { p[0]=uint8_t(v>>8); p[1]=uint8_t(v); }
+static inline void be32(uint8_t* p, uint32_t v) {
+    p[0]=uint8_t(v>>24); p[1]=uint8_t(v>>16); p[2]=uint8_t(v>>8); p[3]=uint8_t(v);
+}
+
+// 고정 필드만 채운 SOME/IP 헤더 (length/request id는 전송 시 patchHeader에서)
+static void init_header(uint8_t* hdr) {
+    uint32_t msg_id = (uint32_t(SERVICE_ID_COMMON) << 16) | uint32_t(METHOD_ID_MOTOR);
+    be32(&hdr[0], msg_id);
+    be32(&hdr[4], 8);
+    be32(&hdr[8], uint32_t(CLIENT_ID) << 16);
+    hdr[12] = PROTO_VER;
+    hdr[13] = IFACE_VER;
+    hdr[14] = MSG_TYPE_REQUEST;
+    hdr[15] = RET_OK;
+}
+
+static int64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int64_t realtime_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+SomeipSender::SomeipSender():
+    sock_(-1), session_(1),
+    ack_timeout_ns_(100 * 1000000LL),
+    rtt_(0.01, 5000),   // 10us 단위, 50ms까지
+    sd_sock_(-1), sd_session_(1), sd_self_port_(0)
+{
+    init_header(hdr_);
+    for (int i = 0; i < MAX_BATCH; i++) init_header(batch_hdr_[i]);
+}
 
 SomeipSender::~SomeipSender() {
     closeSock();
+    if (sd_sock_ >= 0) ::close(sd_sock_);
 }
 
 void SomeipSender::closeSock() {
@@ -25,9 +80,12 @@ void SomeipSender::closeSock() {
         ::close(sock_);
         sock_ = -1;
     }
+    dst_ = sockaddr_in{};
 }
 
-bool SomeipSender::open_to(const char* self_ip, const char* dst_ip, int dst_port) {
+bool SomeipSender::openSocket(const char* self_ip, int self_port) {
+    // 이전 소켓(예: Offer 후 connect 실패)이 같은 포트에 남아 응답을 가로채지 않도록 먼저 닫음
+    closeSock();
     sock_ = ::socket(AF_INET, SOCK_DGRAM, 0);
     if (sock_ < 0) { 
         perror("[ERR] SomeipSender: udp socket"); 
@@ -38,54 +96,403 @@ bool SomeipSender::open_to(const char* self_ip, const char* dst_ip, int dst_port
     sockaddr_in src{}; 
     src.sin_family = AF_INET;
     src.sin_addr.s_addr = inet_addr(self_ip);
-    src.sin_port = htons(0); // (아무 포트나 사용)
+    src.sin_port = htons(self_port); // 0이면 아무 포트나 사용
+    int reuse = 1;
+    setsockopt(sock_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
     if (bind(sock_, (sockaddr*)&src, sizeof(src)) < 0) {
         perror("[ERR] SomeipSender: udp bind"); 
         closeSock(); 
         return false;
     }
+    // 응답 수신 시각을 커널이 기록 (RTT가 pollResponses 호출 시점에 좌우되지 않도록)
+    int on = 1;
+    if (setsockopt(sock_, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) < 0) {
+        perror("[WARN] SomeipSender: SO_TIMESTAMPNS");
+    }
+    return true;
+}
 
-    // TC375 목적지 설정
-    memset(&dst_, 0, sizeof(dst_));
-    dst_.sin_family = AF_INET;
-    dst_.sin_addr.s_addr = inet_addr(dst_ip);
-    dst_.sin_port = htons(dst_port);
+// TC375 목적지로 connect (이후 send는 목적지 주소 없이, 다시 호출하면 목적지만 바뀜)
+// dst_는 connect 성공 후에만 바꿈: 실패 시 endpoint()/useEndpoint()가 연결되지 않은 주소를 보지 않도록
+// (실패하면 이전 연결 상태를 믿을 수 없으므로 비워 둠 → 같은 Offer가 다시 오면 재시도)
+bool SomeipSender::connectTo(const sockaddr_in& dst) {
+    if (connect(sock_, (const sockaddr*)&dst, sizeof(dst)) < 0) {
+        perror("[ERR] SomeipSender: udp connect");
+        dst_ = sockaddr_in{};
+        return false;
+    }
+    dst_ = dst;
     return true;
 }
 
-bool SomeipSender::sendMotor(const std::string& payload) {
+bool SomeipSender::open_to(const char* self_ip, const char* dst_ip, int dst_port, int self_port) {
+    if (!openSocket(self_ip, self_port)) return false;
+
+    sockaddr_in dst{};
+    dst.sin_family = AF_INET;
+    dst.sin_addr.s_addr = inet_addr(dst_ip);
+    dst.sin_port = htons(dst_port);
+    if (!connectTo(dst)) {
+        closeSock();
+        return false;
+    }
+    return true;
+}
+
+// SOME/IP session ID는 0을 쓰지 않음 (0xFFFF 다음은 1)
+// ack 슬롯은 session % ACK_SLOTS로 색인하고 응답의 session 전체를 비교하므로 건너뛴 0과 무관
+static uint16_t next_session(uint16_t session) {
+    return (session == 0xFFFF) ? 1 : uint16_t(session + 1);
+}
+
+// length/session만 갱신 (나머지 헤더 필드는 init_header에서 고정)
+void SomeipSender::patchHeader(uint8_t* hdr, size_t payload_len) {
+    be32(&hdr[4], uint32_t(8 + payload_len)); // 8(헤더일부) + 페이로드
+    be16(&hdr[10], session_);                 // request id 하위 16비트 = session
+    trackRequest(session_, monotonic_ns());
+    session_ = next_session(session_);
+}
+
+// connect된 UDP 소켓은 상대 포트가 닫혀 있으면(ICMP unreachable) 다음 send가 ECONNREFUSED로 실패.
+// TC375 재부팅 중에는 매 주기 발생하므로 로그 없이 실패만 반환합니다.
+bool SomeipSender::reportSendError(const char* what) {
+    if (errno != ECONNREFUSED) perror(what);
+    return false;
+}
+
+bool SomeipSender::sendPayload(const void* payload, size_t len) {
     if (sock_ < 0) return false;
 
-    // SOME/IP 헤더 생성 (16 바이트)
-    uint32_t msg_id = (uint32_t(SERVICE_ID_COMMON) << 16) | uint32_t(METHOD_ID_MOTOR);
-    uint32_t req_id = (uint32_t(CLIENT_ID) << 16) | (session_++ & 0xFFFF);
-    uint32_t length = 8 + payload.size(); // 8(헤더일부) + 페이로드
-    
-    std::vector<uint8_t> pkt(16 + payload.size());
-
-    // Big-Endian 32비트 정수 변환 함수
-    auto be32 = [](uint8_t* p, uint32_t v){ 
-        p[0]=uint8_t(v>>24); p[1]=uint8_t(v>>16); p[2]=uint8_t(v>>8); p[3]=uint8_t(v); 
-    };
-
-    be32(&pkt[0],  msg_id);
-    be32(&pkt[4],  length);
-    be32(&pkt[8],  req_id);
-    pkt[12] = PROTO_VER; 
-    pkt[13] = IFACE_VER; 
-    pkt[14] = MSG_TYPE_REQUEST; 
-    pkt[15] = RET_OK;
-
-    // 페이로드 복사
-    if(!payload.empty()) {
-        memcpy(&pkt[16], payload.data(), payload.size());
-    }
-
-    // UDP 전송
-    ssize_t sent = ::sendto(sock_, pkt.data(), pkt.size(), 0, (sockaddr*)&dst_, sizeof(dst_));
-    if (sent < 0) { 
-        perror("[WARN] SomeipSender: sendto"); 
-        return false; 
+    patchHeader(hdr_, len);
+    iovec iov[2];
+    iov[0].iov_base = hdr_;
+    iov[0].iov_len = sizeof(hdr_);
+    iov[1].iov_base = const_cast<void*>(payload);
+    iov[1].iov_len = len;
+
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = (len > 0) ? 2 : 1;
+    if (::sendmsg(sock_, &msg, 0) < 0) return reportSendError("[WARN] SomeipSender: sendmsg");
+    return true;
+}
+
+bool SomeipSender::sendMotor(const std::string& payload) {
+    return sendPayload(payload.data(), payload.size());
+}
+
+void SomeipSender::encodeMotor(uint8_t* p, const MotorCommand& cmd, uint16_t seq) const {
+    uint32_t now_ms = uint32_t(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+
+    p[0] = MOTOR_BIN_MAGIC;
+    p[1] = MOTOR_BIN_VERSION;
+    be16(&p[2], seq);
+    be32(&p[4], now_ms);
+    be16(&p[8],  uint16_t(cmd.right_duty));
+    be16(&p[10], uint16_t(cmd.left_duty));
+    p[12] = cmd.right_dir;
+    p[13] = cmd.left_dir;
+    p[14] = cmd.steer_valid ? MOTOR_BIN_FLAG_STEER : 0; // flags
+    p[15] = cmd.steer_valid ? uint8_t(cmd.steer) : 0;   // steer
+}
+
+bool SomeipSender::sendMotor(const MotorCommand& cmd) {
+    uint8_t payload[MOTOR_BIN_SIZE];
+    encodeMotor(payload, cmd, session_); // SOME/IP session과 같은 번호
+    return sendPayload(payload, sizeof(payload));
+}
+
+int SomeipSender::sendBatch(const MotorCommand* cmds, int n) {
+    if (sock_ < 0 || n <= 0) return 0;
+    if (n > MAX_BATCH) n = MAX_BATCH;
+
+    iovec iov[MAX_BATCH][2];
+    mmsghdr msgs[MAX_BATCH];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < n; i++) {
+        encodeMotor(batch_payload_[i], cmds[i], session_);
+        patchHeader(batch_hdr_[i], MOTOR_BIN_SIZE);
+        iov[i][0].iov_base = batch_hdr_[i];
+        iov[i][0].iov_len = 16;
+        iov[i][1].iov_base = batch_payload_[i];
+        iov[i][1].iov_len = MOTOR_BIN_SIZE;
+        msgs[i].msg_hdr.msg_iov = iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 2;
     }
+    int sent = ::sendmmsg(sock_, msgs, n, 0);
+    if (sent < 0) {
+        reportSendError("[WARN] SomeipSender: sendmmsg");
+        return -1;
+    }
+    return sent;
+}
+
+// ===== 응답(ack) 추적 =====
+
+void SomeipSender::trackRequest(uint16_t session, int64_t now_ns) {
+    AckSlot& s = slots_[session % ACK_SLOTS];
+    if (s.state == 1) stats_.lost++;   // 슬롯을 재사용할 때까지 응답 없음
+    s.session = session;
+    s.state = 1;
+    s.t_send_ns = now_ns;
+    s.t_send_rt_ns = realtime_ns();
+    stats_.sent++;
+}
+
+void SomeipSender::expireRequests(int64_t now_ns) {
+    for (AckSlot& s : slots_) {
+        if (s.state == 1 && now_ns - s.t_send_ns > ack_timeout_ns_) {
+            s.state = 2;
+            stats_.lost++;
+        }
+    }
+}
+
+int SomeipSender::pollResponses() {
+    if (sock_ < 0) return 0;
+
+    int got = 0;
+    uint8_t buf[64];
+    alignas(cmsghdr) char ctrl[CMSG_SPACE(sizeof(timespec))];
+    for (;;) {
+        iovec iov{buf, sizeof(buf)};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = ctrl;
+        msg.msg_controllen = sizeof(ctrl);
+        ssize_t n = ::recvmsg(sock_, &msg, MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNREFUSED)
+                perror("[WARN] SomeipSender: recvmsg");
+            break;
+        }
+        got++;
+
+        // 같은 서비스/메서드의 응답만 (헤더 16바이트, [14] = 0x80)
+        if (n < 16 ||
+            uint16_t((buf[0] << 8) | buf[1]) != SERVICE_ID_COMMON ||
+            uint16_t((buf[2] << 8) | buf[3]) != METHOD_ID_MOTOR ||
+            buf[14] != MSG_TYPE_RESPONSE) {
+            stats_.unmatched++;
+            continue;
+        }
+        uint16_t session = uint16_t((buf[10] << 8) | buf[11]);
+        AckSlot& s = slots_[session % ACK_SLOTS];
+        if (s.session != session || s.state == 0) {
+            stats_.unmatched++;
+            continue;
+        }
+
+        // RTT: 커널 수신 타임스탬프 - 송신 시각 (타임스탬프가 없거나 시계가 튀면 지금 시각 기준)
+        int64_t rtt_ns = -1;
+        for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec ts;
+                memcpy(&ts, CMSG_DATA(cm), sizeof(ts));
+                rtt_ns = ((int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec) - s.t_send_rt_ns;
+            }
+        }
+        if (rtt_ns < 0 || rtt_ns > 10 * 1000000000LL) rtt_ns = monotonic_ns() - s.t_send_ns;
+
+        if (s.state == 2) {
+            stats_.late++;                      // 이미 lost로 집계됨
+        } else if (rtt_ns > ack_timeout_ns_) {
+            stats_.lost++;                      // 제한 시간을 넘겨 도착 (아직 만료 처리 전)
+            stats_.late++;
+        } else {
+            stats_.acked++;
+            rtt_.add(rtt_ns / 1e6);
+        }
+        s.state = 0;
+    }
+    expireRequests(monotonic_ns());
+    return got;
+}
+
+SomeipLinkStats SomeipSender::linkStats() const {
+    SomeipLinkStats st = stats_;
+    st.pending = 0;
+    for (const AckSlot& s : slots_) if (s.state == 1) st.pending++;
+    return st;
+}
+
+void SomeipSender::printLinkStats(const char* tag, FILE* out) const {
+    SomeipLinkStats st = linkStats();
+    fprintf(out, "[LINK] %-12s sent=%llu acked=%llu late=%llu lost=%llu unmatched=%llu pending=%llu loss=%.2f%%\n",
+            tag, (unsigned long long)st.sent, (unsigned long long)st.acked,
+            (unsigned long long)st.late, (unsigned long long)st.lost,
+            (unsigned long long)st.unmatched, (unsigned long long)st.pending,
+            st.lossRate() * 100.0);
+    rtt_.print("rtt", out);
+}
+
+// ===== SOME/IP-SD (서비스 검색) =====
+
+static inline uint16_t rd16(const uint8_t* p) { return uint16_t((p[0] << 8) | p[1]); }
+static inline uint32_t rd32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+/**
+ * SD 메시지에서 service_id의 OfferService 엔트리와 그 IPv4(UDP) endpoint 옵션을 찾습니다.
+ * (엔트리/옵션 배열을 길이 필드대로 순회하므로 고정 오프셋에 의존하지 않음)
+ * @return 1: offer 찾음(ep 채움), 0: stop offer(TTL 0), -1: 해당 offer 없음/형식 오류
+ */
+static int parse_offer(const uint8_t* buf, size_t n, uint16_t service_id, sockaddr_in& ep) {
+    if (n < 28 || rd32(buf) != SD_MSG_ID) return -1;
+    uint32_t entries_len = rd32(&buf[20]);
+    size_t entries = 24;
+    if (entries_len % 16 != 0 || entries + entries_len + 4 > n) return -1;
+    size_t options = entries + entries_len + 4;
+    uint32_t options_len = rd32(&buf[entries + entries_len]);
+    if (options + options_len > n) return -1;
+
+    // 옵션 시작 위치 목록 (인덱스 → 오프셋)
+    size_t opt_ofs[16];
+    int num_opts = 0;
+    for (size_t o = options; o + 3 <= options + options_len && num_opts < 16; ) {
+        opt_ofs[num_opts++] = o;
+        o += 3 + rd16(&buf[o]);   // length는 type/reserved 다음부터의 길이 (+3 = length 2바이트 + type)
+    }
+
+    for (size_t e = entries; e + 16 <= entries + entries_len; e += 16) {
+        const uint8_t* ent = &buf[e];
+        if (ent[0] != SD_ENTRY_OFFER || rd16(&ent[4]) != service_id) continue;
+        uint32_t ttl = (uint32_t(ent[9]) << 16) | (uint32_t(ent[10]) << 8) | ent[11];
+        if (ttl == 0) return 0;
+
+        // 첫 번째/두 번째 옵션 run에서 UDP IPv4 endpoint 찾기
+        int runs[2][2] = { { ent[1], ent[3] >> 4 }, { ent[2], ent[3] & 0x0F } };
+        for (auto& run : runs) {
+            for (int k = run[0]; k < run[0] + run[1] && k < num_opts; k++) {
+                const uint8_t* opt = &buf[opt_ofs[k]];
+                if (opt_ofs[k] + 12 > options + options_len) continue;
+                if (opt[2] != SD_OPT_IPV4_EP || rd16(opt) != 0x0009 || opt[9] != L4_PROTO_UDP) continue;
+                memset(&ep, 0, sizeof(ep));
+                ep.sin_family = AF_INET;
+                memcpy(&ep.sin_addr.s_addr, &opt[4], 4);   // 이미 네트워크 바이트 순서
+                ep.sin_port = htons(rd16(&opt[10]));
+                return 1;
+            }
+        }
+    }
+    return -1;
+}
+
+bool SomeipSender::openDiscovery(const char* self_ip, int self_port, const char* find_ip) {
+    sd_self_ip_ = self_ip;
+    sd_self_port_ = self_port;
+
+    sd_sock_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (sd_sock_ < 0) {
+        perror("[ERR] SomeipSender: sd socket");
+        return false;
+    }
+    int on = 1;
+    setsockopt(sd_sock_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(sd_sock_, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+
+    // TC375의 브로드캐스트 Offer를 받으려면 INADDR_ANY:30490
+    sockaddr_in src{};
+    src.sin_family = AF_INET;
+    src.sin_addr.s_addr = htonl(INADDR_ANY);
+    src.sin_port = htons(SD_PORT);
+    if (bind(sd_sock_, (sockaddr*)&src, sizeof(src)) < 0) {
+        perror("[ERR] SomeipSender: sd bind");
+        ::close(sd_sock_);
+        sd_sock_ = -1;
+        return false;
+    }
+
+    memset(&sd_find_dst_, 0, sizeof(sd_find_dst_));
+    sd_find_dst_.sin_family = AF_INET;
+    sd_find_dst_.sin_addr.s_addr = inet_addr(find_ip);
+    sd_find_dst_.sin_port = htons(SD_PORT);
+    return true;
+}
+
+bool SomeipSender::sendFindService() {
+    if (sd_sock_ < 0) return false;
+
+    uint8_t msg[44];
+    memset(msg, 0, sizeof(msg));
+    be32(&msg[0], SD_MSG_ID);
+    be32(&msg[4], sizeof(msg) - 8);
+    be32(&msg[8], sd_session_);                // client 0x0000
+    sd_session_ = next_session(sd_session_);
+    msg[12] = PROTO_VER;
+    msg[13] = IFACE_VER;
+    msg[14] = MSG_TYPE_NOTIFY;
+    msg[15] = RET_OK;
+    msg[16] = SD_FLAGS;
+    be32(&msg[20], 16);                        // entries 길이
+    uint8_t* ent = &msg[24];
+    ent[0] = SD_ENTRY_FIND;                    // 옵션 없음
+    be16(&ent[4], SERVICE_ID_COMMON);
+    be16(&ent[6], 0xFFFF);                     // 모든 인스턴스
+    ent[8] = 0xFF;                             // 모든 major 버전
+    ent[9] = uint8_t(SD_FIND_TTL >> 16); ent[10] = uint8_t(SD_FIND_TTL >> 8); ent[11] = uint8_t(SD_FIND_TTL);
+    be32(&ent[12], 0xFFFFFFFF);                // 모든 minor 버전
+    be32(&msg[40], 0);                         // options 길이
+
+    if (::sendto(sd_sock_, msg, sizeof(msg), 0, (sockaddr*)&sd_find_dst_, sizeof(sd_find_dst_)) < 0) {
+        perror("[WARN] SomeipSender: FindService sendto");
+        return false;
+    }
+    return true;
+}
+
+bool SomeipSender::useEndpoint(const sockaddr_in& ep) {
+    bool same = isConnected() && ep.sin_addr.s_addr == dst_.sin_addr.s_addr && ep.sin_port == dst_.sin_port;
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &ep.sin_addr, ip, sizeof(ip));
+    if (same) {
+        // 같은 endpoint 재Offer = TC375 재부팅 (connect된 소켓은 그대로 사용 가능)
+        std::cout << "[INFO] SomeipSender: TC375 re-offered " << ip << ":" << ntohs(ep.sin_port) << "\n";
+        return true;
+    }
+    const bool opened = sock_ < 0;
+    if (opened && !openSocket(sd_self_ip_.c_str(), sd_self_port_)) return false;
+    if (!connectTo(ep)) {
+        if (opened) closeSock();   // 여기서 연 소켓은 CTRL_PORT에 바인딩된 채로 남기지 않음
+        return false;
+    }
+    std::cout << "[INFO] SomeipSender: TC375 offer -> connected " << ip << ":" << ntohs(ep.sin_port) << "\n";
     return true;
-}
\ No newline at end of file
+}
+
+bool SomeipSender::readOffers(int timeout_ms) {
+    if (sd_sock_ < 0) return false;
+
+    bool got = false;
+    uint8_t buf[256];
+    for (;;) {
+        pollfd pfd{sd_sock_, POLLIN, 0};
+        if (::poll(&pfd, 1, got ? 0 : timeout_ms) <= 0) break;
+        ssize_t n = ::recv(sd_sock_, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n <= 0) break;
+
+        sockaddr_in ep;
+        int r = parse_offer(buf, (size_t)n, SERVICE_ID_COMMON, ep);
+        if (r == 1) got = useEndpoint(ep) || got;
+        else if (r == 0) std::cout << "[WARN] SomeipSender: TC375 StopOffer\n";
+    }
+    return got;
+}
+
+bool SomeipSender::findService(int timeout_ms, int retry_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        sendFindService();
+        int left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (readOffers(std::max(0, std::min(retry_ms, left)))) return true;
+    }
+    return false;
+}
+
+bool SomeipSender::pollDiscovery() {
+    return readOffers(0);
+}
@@ -1,11 +1,68 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
+#include <cstddef>
 #include <sys/socket.h> // sockaddr_in
 #include <arpa/inet.h>  // inet_addr
+#include "LatencyStats.h"
 
+// 바이너리 모터 명령 페이로드 (method 0x0201, big-endian 16바이트)
+// 레이아웃은 TC375 App_Comm.h의 APP_COMM_DRIVE_BIN_* 정의와 반드시 같아야 합니다.
+static const uint8_t  MOTOR_BIN_MAGIC   = 0xD5;
+static const uint8_t  MOTOR_BIN_VERSION = 0x01;
+static const size_t   MOTOR_BIN_SIZE    = 16;
+static const uint8_t  MOTOR_BIN_FLAG_STEER = 0x01; // [14] flags bit0: [15] steer 유효
+
+/**
+ * @brief 모터 명령 (텍스트 "Rspd;Lspd;Rdir;Ldir"와 같은 필드 순서)
+ */
+struct MotorCommand {
+    int16_t right_duty = 0; // 0~100
+    int16_t left_duty  = 0;
+    uint8_t right_dir  = 1; // 1: 전진
+    uint8_t left_dir   = 1;
+    bool steer_valid   = false; // true: 연속 조향 값(steer) 포함 (flags bit0, --steer-pd)
+    int8_t steer       = 0;     // -100 (좌) ~ +100 (우), TC375 방향지시등 판단용
+};
+
+/**
+ * @brief 제어 링크 응답 통계 (SomeipSender::linkStats)
+ */
+struct SomeipLinkStats {
+    uint64_t sent = 0;      // 추적한 요청 수
+    uint64_t acked = 0;     // 제한 시간 안에 응답 받음 (RTT 기록)
+    uint64_t late = 0;      // 제한 시간이 지난 뒤 응답 받음
+    uint64_t lost = 0;      // 제한 시간 안에 응답 없음 (나중에 늦게 온 것 포함)
+    uint64_t unmatched = 0; // 추적 중이 아닌 session의 응답 (중복/너무 오래됨/다른 메시지)
+    uint64_t pending = 0;   // 아직 응답을 기다리는 요청
+
+    /** @brief 응답이 끝내 오지 않은 비율 (late는 도착했으므로 제외) */
+    double lossRate() const {
+        uint64_t done = acked + lost;
+        return done ? double(lost - late) / double(done) : 0.0;
+    }
+};
+
+/**
+ * @brief TC375로 SOME/IP 모터 명령을 보내는 UDP 송신기
+ *
+ * - open_to()에서 connect()한 UDP 소켓을 사용합니다. (전송마다 목적지 주소 조회/검사 생략)
+ * - 16바이트 SOME/IP 헤더는 멤버 버퍼에 미리 만들어 두고 length/session만 고칩니다.
+ * - 헤더와 페이로드는 sendmsg의 iovec 두 개로 보내므로 패킷 버퍼 조립/복사/힙 할당이 없습니다.
+ * - TC375(SOMEIP_Callback)는 요청을 message type 0x80으로 그대로 돌려보내므로,
+ *   pollResponses()로 응답을 session ID로 요청과 짝지어 왕복 시간(RTT)과 손실을 집계합니다.
+ *   RTT는 커널 수신 타임스탬프(SO_TIMESTAMPNS) 기준이라 pollResponses 호출 주기와 무관합니다.
+ *   (TC375는 응답을 항상 PN_SERVICE_1(30509) 포트로 보내므로 open_to의 self_port도 30509로 맞추세요)
+ * - IP를 고정하지 않으려면 openDiscovery() + findService()로 TC375의 OfferService(SOME/IP-SD, 30490)를
+ *   받아 endpoint에 자동 연결하고, 제어 주기마다 pollDiscovery()로 재부팅 후 Offer를 반영합니다.
+ * - 한 스레드(제어 스레드)에서만 사용하세요.
+ */
 class SomeipSender {
 public:
+    static const int MAX_BATCH = 8;   // sendBatch() 한 번에 보낼 수 있는 최대 명령 수
+    static const int ACK_SLOTS = 256; // 응답 대기 추적 슬롯 (session 하위 8비트로 색인)
+
     SomeipSender();
     ~SomeipSender();
 
@@ -14,15 +71,39 @@ public:
      * @param self_ip RPi의 IP (예: "192.168.2.10")
      * @param dst_ip TC375의 IP (예: "192.168.2.30")
      * @param dst_port TC375의 Port (예: 30509)
+     * @param self_port RPi 쪽 포트 (0이면 임의, 응답을 받으려면 30509)
      * @return 성공 시 true
      */
-    bool open_to(const char* self_ip, const char* dst_ip, int dst_port);
+    bool open_to(const char* self_ip, const char* dst_ip, int dst_port, int self_port = 0);
 
     /**
      * @brief 소켓을 닫습니다.
      */
     void closeSock();
 
+    /**
+     * @brief SOME/IP-SD 소켓(INADDR_ANY:30490)을 엽니다. (open_to 대신 서비스 검색으로 연결할 때)
+     * @param self_ip 데이터 소켓을 바인딩할 RPi IP ("0.0.0.0"이면 모든 인터페이스)
+     * @param self_port 데이터 소켓 로컬 포트 (응답을 받으려면 30509)
+     * @param find_ip FindService를 보낼 주소 (기본 브로드캐스트, 테스트 시 유니캐스트)
+     */
+    bool openDiscovery(const char* self_ip, int self_port, const char* find_ip = "255.255.255.255");
+
+    /**
+     * @brief FindService를 retry_ms마다 보내며 OfferService를 기다리고, 받으면 그 endpoint에 연결합니다.
+     * @return timeout_ms 안에 연결되면 true
+     */
+    bool findService(int timeout_ms, int retry_ms = 100);
+
+    /**
+     * @brief 쌓인 OfferService를 non-blocking으로 처리합니다. (TC375 재부팅/IP 변경 시 즉시 재연결)
+     * @return 이번 호출에서 Offer를 받아 연결(유지)했으면 true
+     */
+    bool pollDiscovery();
+
+    bool isConnected() const { return sock_ >= 0 && dst_.sin_port != 0; }   // connect 성공 후에만 true
+    const sockaddr_in& endpoint() const { return dst_; }
+
     /**
      * @brief SOME/IP 헤더를 붙여 모터 명령 페이로드를 전송합니다.
      * @param payload "Rspd;Lspd;Rdir;Ldir" 형식의 문자열
@@ -30,8 +111,86 @@ public:
      */
     bool sendMotor(const std::string& payload);
 
+    /**
+     * @brief 임의의 페이로드를 SOME/IP 헤더와 함께 전송합니다. (sendmsg, 복사 없음)
+     */
+    bool sendPayload(const void* payload, size_t len);
+
+    /**
+     * @brief 모터 명령을 고정 레이아웃 바이너리 페이로드로 전송합니다. (힙 할당 없음)
+     *
+     * [0]magic [1]version [2-3]sequence [4-7]timestamp(ms, steady_clock 하위 32비트)
+     * [8-9]right_duty [10-11]left_duty [12]right_dir [13]left_dir [14]flags
+     * [15]steer (int8, -100~100, flags bit0일 때 유효)
+     * @return 전송 성공 시 true
+     */
+    bool sendMotor(const MotorCommand& cmd);
+
+    /**
+     * @brief 모터 명령 여러 개를 sendmmsg 시스템 콜 한 번으로 전송합니다. (테스트/재전송용)
+     * @param n 명령 수 (MAX_BATCH 초과분은 잘림)
+     * @return 실제로 전송된 패킷 수 (오류 시 -1)
+     */
+    int sendBatch(const MotorCommand* cmds, int n);
+
+    /**
+     * @brief 응답 제한 시간 (기본 100ms, 넘으면 lost로 집계)
+     */
+    void setAckTimeoutMs(double ms) { ack_timeout_ns_ = int64_t(ms * 1e6); }
+
+    /**
+     * @brief 소켓에 도착한 응답을 모두 읽어 요청과 짝짓습니다. (non-blocking, 할당 없음)
+     *        제한 시간이 지난 요청은 lost로 넘깁니다. 제어 주기마다 호출하세요.
+     * @return 이번에 읽은 응답 수
+     */
+    int pollResponses();
+
+    SomeipLinkStats linkStats() const;
+    const LatencyStats& rtt() const { return rtt_; }
+
+    /**
+     * @brief RTT p50/p99/max와 손실률 요약 출력
+     */
+    void printLinkStats(const char* tag, FILE* out = stdout) const;
+
 private:
+    bool openSocket(const char* self_ip, int self_port);
+    bool connectTo(const sockaddr_in& dst);
+    bool sendFindService();
+    bool readOffers(int timeout_ms);
+    bool useEndpoint(const sockaddr_in& ep);
+
+    struct AckSlot {
+        uint16_t session = 0;
+        uint8_t state = 0;      // 0: 비어 있음/완료, 1: 응답 대기, 2: 시간 초과(lost)
+        int64_t t_send_ns = 0;     // CLOCK_MONOTONIC (시간 초과 판정)
+        int64_t t_send_rt_ns = 0;  // CLOCK_REALTIME (커널 수신 타임스탬프와 비교)
+    };
+
+    void trackRequest(uint16_t session, int64_t now_ns);
+    void expireRequests(int64_t now_ns);
+
+    void patchHeader(uint8_t* hdr, size_t payload_len);
+    void encodeMotor(uint8_t* p, const MotorCommand& cmd, uint16_t seq) const;
+    bool reportSendError(const char* what);
+
     int sock_;
     sockaddr_in dst_{};
-    uint32_t session_;
+    uint16_t session_;
+    uint8_t hdr_[16];                             // 미리 만든 SOME/IP 헤더 (sendPayload용)
+    uint8_t batch_hdr_[MAX_BATCH][16];            // sendBatch용 헤더 (패킷마다 session이 다름)
+    uint8_t batch_payload_[MAX_BATCH][MOTOR_BIN_SIZE];
+
+    // 응답 추적
+    AckSlot slots_[ACK_SLOTS];
+    int64_t ack_timeout_ns_;
+    SomeipLinkStats stats_;
+    LatencyStats rtt_;      // Pi→TC375→Pi 왕복 시간 (ms)
+
+    // 서비스 검색 (SOME/IP-SD)
+    int sd_sock_;
+    uint16_t sd_session_;
+    std::string sd_self_ip_;
+    int sd_self_port_;
+    sockaddr_in sd_find_dst_{};
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief 단일 생산자 / 단일 소비자(SPSC)용 고정 크기 lock-free 링 버퍼
+ *
+ * - 생산자 스레드는 try_push()만, 소비자 스레드는 pop()/pop_latest()만 호출해야 합니다.
+ * - 슬롯은 생성 시 한 번만 할당되며, 이후 push/pop에서 동적 할당이 없습니다.
+ * - pop_latest()는 쌓여 있는 항목을 모두 소비하고 가장 최신 항목 하나만 넘겨주므로,
+ *   소비자가 느려도 항상 최신 프레임/결과를 받습니다.
+ *
+ * @tparam T 저장할 타입 (move 가능해야 함)
+ * @tparam N 슬롯 개수 (2의 거듭제곱, 실제 저장 가능 개수는 N)
+ */
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing: N은 2의 거듭제곱이어야 합니다.");
+
+public:
+    /**
+     * @brief 항목을 넣습니다. (생산자 전용)
+     * @return 링이 가득 차 있으면 false (항목은 버려짐)
+     */
+    bool try_push(T&& item) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        if (head - tail >= N) return false;
+        m_slots[head & (N - 1)] = std::move(item);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item) {
+        T copy = item;
+        return try_push(std::move(copy));
+    }
+
+    /**
+     * @brief 가장 오래된 항목 하나를 꺼냅니다. (소비자 전용)
+     * @return 비어 있으면 false
+     */
+    bool pop(T& out) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        if (tail == head) return false;
+        out = std::move(m_slots[tail & (N - 1)]);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 쌓인 항목을 모두 버리고 가장 최신 항목만 꺼냅니다. (소비자 전용)
+     * @param skipped (선택) 건너뛴(버려진) 항목 수
+     * @return 비어 있으면 false
+     */
+    bool pop_latest(T& out, size_t* skipped = nullptr) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        if (tail == head) return false;
+        out = std::move(m_slots[(head - 1) & (N - 1)]);
+        m_tail.store(head, std::memory_order_release);
+        if (skipped) *skipped = head - tail - 1;
+        return true;
+    }
+
+    bool empty() const {
+        return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, N> m_slots{};
+    // 생산자/소비자 인덱스를 서로 다른 캐시 라인에 두어 false sharing 방지
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
@@ -0,0 +1,66 @@
+#include "SteeringController.h"
+#include <algorithm>
+#include <cmath>
+
+SteeringController::SteeringController(double kp, double kd, int turn_delta,
+                                       double max_duty_rate, double deriv_tau_s)
+    : m_kp(kp), m_kd(kd), m_turn_delta(turn_delta),
+      m_max_duty_rate(max_duty_rate), m_deriv_tau_s(deriv_tau_s) {
+    reset();
+}
+
+void SteeringController::reset() {
+    m_have_error = false;
+    m_last_error = 0.0;
+    m_last_t_ns = 0;
+    m_deriv = 0.0;
+    m_steer = 0.0;
+    m_right = m_left = 0.0;
+    m_have_output = false;
+}
+
+void SteeringController::updateError(double error, int64_t t_ns, bool line_found) {
+    if (!line_found) {
+        m_have_error = false;   // 다시 찾았을 때 끊긴 구간으로 미분하지 않도록
+        return;
+    }
+    if (m_have_error && t_ns > m_last_t_ns) {
+        double dt = (t_ns - m_last_t_ns) * 1e-9;
+        double raw = (error - m_last_error) / dt;
+        double a = dt / (m_deriv_tau_s + dt);
+        m_deriv += a * (raw - m_deriv);
+    } else if (!m_have_error) {
+        m_deriv = 0.0;
+    }
+    m_have_error = true;
+    m_last_error = error;
+    m_last_t_ns = t_ns;
+    m_steer = std::max(-1.0, std::min(1.0, m_kp * error + m_kd * m_deriv));
+}
+
+SteerOutput SteeringController::update(int base_speed, double dt_s) {
+    double mag = std::fabs(m_steer);
+    double fast = base_speed + mag * m_turn_delta;
+    double slow = base_speed * (1.0 - mag);
+    // steer > 0: 우회전 = 왼쪽 바퀴가 빠름 (build_motor drive_mode 1과 같음)
+    double right = (m_steer > 0.0) ? slow : fast;
+    double left = (m_steer > 0.0) ? fast : slow;
+    right = std::max(0.0, std::min(100.0, right));
+    left = std::max(0.0, std::min(100.0, left));
+
+    if (!m_have_output || base_speed <= 0) {   // ACC 정지는 레이트 제한 없이 즉시
+        m_right = right;
+        m_left = left;
+        m_have_output = true;
+    } else {
+        double step = m_max_duty_rate * dt_s;
+        m_right += std::max(-step, std::min(step, right - m_right));
+        m_left += std::max(-step, std::min(step, left - m_left));
+    }
+
+    SteerOutput out;
+    out.right_duty = (int)std::lround(m_right);
+    out.left_duty = (int)std::lround(m_left);
+    out.steer = m_steer;
+    return out;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief 연속 차동 조향 출력 (SteeringController::update)
+ */
+struct SteerOutput {
+    int right_duty = 0;   // 0~100 (build_motor와 같은 바퀴 순서)
+    int left_duty = 0;
+    double steer = 0.0;   // -1.0 (좌) ~ +1.0 (우), ±1이면 기존 drive_mode ±1과 같은 바퀴 명령
+};
+
+/**
+ * @brief LKAS 오차(LKASResult::error)에 대한 PD 조향 + 레이트 제한 차동 믹스 (--steer-pd)
+ *
+ * - 비전 결과가 올 때마다 updateError()로 오차와 캡처 시각을 넣으면 실제 프레임 간격으로
+ *   미분항을 계산합니다. (미분은 1차 저역 필터 통과)
+ * - 제어 주기마다 update()가 기본 속도와 조향값으로 양쪽 듀티를 만들고, 주기당 듀티 변화를
+ *   max_duty_rate로 제한합니다.
+ * - 믹스: 빠른 바퀴 = base + |steer| * turn_delta, 느린 바퀴 = base * (1 - |steer|)
+ *   (|steer| = 1이면 기존 3단계 조향과 같은 명령 → 연속 모드와 기존 모드가 끝점에서 일치)
+ * - 차선을 잃으면 마지막 조향값을 유지합니다. (기존 drive_mode 유지와 같은 동작)
+ * - 기본 속도가 0(ACC 정지)이면 레이트 제한 없이 바로 0을 냅니다.
+ */
+class SteeringController {
+public:
+    /**
+     * @param kp 비례 게인 (오차 1.0당 steer)
+     * @param kd 미분 게인 (오차 변화율 1.0/s당 steer)
+     * @param turn_delta |steer| = 1일 때 빠른 바퀴에 더하는 듀티 (main.cpp TURN_DELTA)
+     * @param max_duty_rate 바퀴 듀티 변화 한계 (듀티/s)
+     * @param deriv_tau_s 미분항 저역 필터 시정수 (s)
+     */
+    explicit SteeringController(double kp = 0.6, double kd = 0.1, int turn_delta = 16,
+                                double max_duty_rate = 400.0, double deriv_tau_s = 0.05);
+
+    void reset();
+
+    /**
+     * @brief 새 비전 결과 반영
+     * @param error LKASResult::error (-1.0 ~ +1.0, 오른쪽이 +)
+     * @param t_ns 해당 프레임 캡처 시각 (ns, 단조 증가)
+     * @param line_found false이면 조향값 유지
+     */
+    void updateError(double error, int64_t t_ns, bool line_found);
+
+    /**
+     * @brief 제어 주기마다 호출: 레이트 제한한 양쪽 듀티
+     * @param base_speed ACC 기본 속도 명령 (0~100)
+     * @param dt_s 직전 호출 이후 시간 (s)
+     */
+    SteerOutput update(int base_speed, double dt_s);
+
+    double steer() const { return m_steer; }
+
+private:
+    double m_kp, m_kd;
+    int m_turn_delta;
+    double m_max_duty_rate;
+    double m_deriv_tau_s;
+
+    bool m_have_error;
+    double m_last_error;
+    int64_t m_last_t_ns;
+    double m_deriv;          // 필터된 오차 변화율 (1/s)
+    double m_steer;          // 현재 조향 목표 (-1 ~ 1)
+    double m_right, m_left;  // 레이트 제한 중인 듀티 (double로 누적)
+    bool m_have_output;
+};
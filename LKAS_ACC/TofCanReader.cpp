@@ -7,10 +7,34 @@
 #include <net/if.h>
 #include <fcntl.h>
 #include <cerrno>
+#include <ctime>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <linux/can/raw.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>   // scm_timestamping
 
-TofCanReader::TofCanReader() : m_sock_fd(-1) {
-    m_tof_can_id = 0x200;
-    m_obstacle_can_id = 0x300; 
+static const int RX_BATCH = 16;   // recvmmsg 한 번에 받을 최대 프레임 수
+
+static int64_t clock_ns(clockid_t id) {
+    timespec ts;
+    clock_gettime(id, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+TofCanReader::TofCanReader() :
+    m_sock_fd(-1),
+    m_epoll_fd(-1),
+    m_stop_fd(-1),
+    m_rx_cpu(-1),
+    m_frames(0),
+    m_batches(0),
+    m_max_batch(0),
+    m_rx_delay(0.01, 1000)   // 10us 단위, 10ms까지
+{
+    m_tof_can_id = TOF_CAN_ID;
+    m_obstacle_can_id = OBSTACLE_CAN_ID;
 }
 
 TofCanReader::~TofCanReader() {
@@ -18,6 +42,7 @@ TofCanReader::~TofCanReader() {
 }
 
 void TofCanReader::close() {
+    stop();
     if (m_sock_fd != -1) {
         ::close(m_sock_fd);
         m_sock_fd = -1;
@@ -33,12 +58,31 @@ bool TofCanReader::open(const std::string& interface_name) {
     }
     struct sockaddr_can addr;
     struct ifreq ifr;
-    strcpy(ifr.ifr_name, interface_name.c_str());
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
     if (ioctl(m_sock_fd, SIOCGIFINDEX, &ifr) < 0) {
         perror("[ERR] TofCanReader: 'can0' 인터페이스를 찾을 수 없습니다.");
         close();
         return false;
     }
+    // 커널 필터: ToF/장애물 ID만 소켓 큐에 들어오도록 (다른 ID는 깨우지도 않음)
+    struct can_filter filters[2];
+    filters[0].can_id = m_tof_can_id;
+    filters[0].can_mask = CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_SFF_MASK;
+    filters[1].can_id = m_obstacle_can_id;
+    filters[1].can_mask = CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_SFF_MASK;
+    if (setsockopt(m_sock_fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters, sizeof(filters)) < 0) {
+        perror("[ERR] TofCanReader: CAN_RAW_FILTER 설정 실패");
+        close();
+        return false;
+    }
+    // 커널 수신 타임스탬프 (소프트웨어: 드라이버가 프레임을 넘긴 시각)
+    int ts_flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(m_sock_fd, SOL_SOCKET, SO_TIMESTAMPING, &ts_flags, sizeof(ts_flags)) < 0) {
+        perror("[WARN] TofCanReader: SO_TIMESTAMPING 설정 실패 (수신 시각 = 읽은 시각)");
+    }
+
+    memset(&addr, 0, sizeof(addr));
     addr.can_family = AF_CAN;
     addr.can_ifindex = ifr.ifr_ifindex;
     if (bind(m_sock_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
@@ -67,24 +111,27 @@ CanData TofCanReader::readMessages() {
 
     while ((nbytes = read(m_sock_fd, &frame, sizeof(struct can_frame))) > 0) {
         
-        if (nbytes < sizeof(struct can_frame)) {
+        if (nbytes < (int)sizeof(struct can_frame)) {
             std::cerr << "[WARN] TofCanReader: 불완전한 CAN 프레임 수신" << std::endl;
             continue;
         }
 
         // 1. ToF 센서 ID 확인
         if (frame.can_id == m_tof_can_id) {
-            if (frame.can_dlc >= 2) {
-                dist_mm = frame.data[0] | (frame.data[1] << 8);
+            if (frame.can_dlc >= can_db::TofDistance::min_dlc) {
+                dist_mm = (int)can_db::TofDistance::raw(frame.data);
+                m_tof_hist.push(clock_ns(CLOCK_MONOTONIC), dist_mm);
             }
         }
         // 2. 장애물/표지판 ID 확인
         else if (frame.can_id == m_obstacle_can_id) {
-            if (frame.can_dlc >= 1) {
-                if (frame.data[0] == 0x01) {
+            if (frame.can_dlc >= can_db::DetectClass::min_dlc) {
+                uint8_t cls = (uint8_t)can_db::DetectClass::raw(frame.data);
+                m_obstacle_hist.push(clock_ns(CLOCK_MONOTONIC), cls);
+                if (cls == can_db::CLASS_BOX) {
                     result_data.obstacle_detected = true; 
                 } 
-                else if (frame.data[0] == 0x02) { // ★ 우회전 신호
+                else if (cls == can_db::CLASS_SIGN_A) { // ★ 우회전 신호
                     result_data.sign_turn_right = true;
                 }
             }
@@ -94,4 +141,177 @@ CanData TofCanReader::readMessages() {
     result_data.distance_mm = dist_mm;
     
     return result_data;
-}
\ No newline at end of file
+}
+// ===== 이벤트 기반 수신 스레드 =====
+
+bool TofCanReader::start(int cpu) {
+    if (m_sock_fd < 0 || m_rx_thread.joinable()) return false;
+
+    m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    m_stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epoll_fd < 0 || m_stop_fd < 0) {
+        perror("[ERR] TofCanReader: epoll/eventfd 생성 실패");
+        stop();
+        return false;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = m_sock_fd;
+    epoll_event ev_stop{};
+    ev_stop.events = EPOLLIN;
+    ev_stop.data.fd = m_stop_fd;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_sock_fd, &ev) < 0 ||
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_stop_fd, &ev_stop) < 0) {
+        perror("[ERR] TofCanReader: epoll_ctl 실패");
+        stop();
+        return false;
+    }
+    m_rx_cpu = cpu;
+    m_rx_thread = std::thread(&TofCanReader::rxLoop, this);
+    return true;
+}
+
+void TofCanReader::stop() {
+    if (m_rx_thread.joinable()) {
+        uint64_t one = 1;
+        if (write(m_stop_fd, &one, sizeof(one)) < 0) perror("[WARN] TofCanReader: eventfd write");
+        m_rx_thread.join();
+    }
+    if (m_epoll_fd >= 0) { ::close(m_epoll_fd); m_epoll_fd = -1; }
+    if (m_stop_fd >= 0) { ::close(m_stop_fd); m_stop_fd = -1; }
+}
+
+void TofCanReader::handleFrame(const struct can_frame& frame, int64_t rx_ns, TofSnapshot& snap) {
+    if (frame.can_id == m_tof_can_id) {
+        if (frame.can_dlc >= can_db::TofDistance::min_dlc) {
+            snap.distance_mm = (int)can_db::TofDistance::raw(frame.data);
+            snap.tof_rx_ns = rx_ns;
+            snap.tof_count++;
+            m_tof_hist.push(rx_ns, snap.distance_mm);
+        }
+    }
+    else if (frame.can_id == m_obstacle_can_id) {
+        if (frame.can_dlc >= can_db::DetectClass::min_dlc) {
+            uint8_t cls = (uint8_t)can_db::DetectClass::raw(frame.data);
+            m_obstacle_hist.push(rx_ns, cls);
+            if (cls == can_db::CLASS_BOX) snap.obstacle_count++;
+            else if (cls == can_db::CLASS_SIGN_A) snap.sign_right_count++; // ★ 우회전 신호
+        }
+    }
+}
+
+void TofCanReader::rxLoop() {
+    if (m_rx_cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(m_rx_cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    // recvmmsg 버퍼는 스레드 시작 시 한 번만 준비 (수신 중 할당 없음)
+    struct can_frame frames[RX_BATCH];
+    iovec iov[RX_BATCH];
+    alignas(cmsghdr) char ctrl[RX_BATCH][CMSG_SPACE(sizeof(scm_timestamping))];
+    mmsghdr msgs[RX_BATCH];
+
+    TofSnapshot snap = m_snapshot.load();
+    epoll_event events[2];
+    bool running = true;
+    while (running) {
+        int n = epoll_wait(m_epoll_fd, events, 2, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("[ERR] TofCanReader: epoll_wait");
+            break;
+        }
+        for (int e = 0; e < n; e++) {
+            if (events[e].data.fd == m_stop_fd) running = false;
+        }
+
+        // 소켓 큐가 빌 때까지 배치로 수신 (edge/level 관계없이 한 번 깨면 모두 처리)
+        for (;;) {
+            for (int i = 0; i < RX_BATCH; i++) {
+                iov[i].iov_base = &frames[i];
+                iov[i].iov_len = sizeof(frames[i]);
+                memset(&msgs[i], 0, sizeof(msgs[i]));
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+                msgs[i].msg_hdr.msg_control = ctrl[i];
+                msgs[i].msg_hdr.msg_controllen = sizeof(ctrl[i]);
+            }
+            int got = recvmmsg(m_sock_fd, msgs, RX_BATCH, MSG_DONTWAIT, nullptr);
+            if (got <= 0) {
+                if (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                    perror("[WARN] TofCanReader: recvmmsg");
+                break;
+            }
+
+            // 커널 타임스탬프(CLOCK_REALTIME) → CLOCK_MONOTONIC 환산용 오프셋
+            int64_t mono_now = clock_ns(CLOCK_MONOTONIC);
+            int64_t real_now = clock_ns(CLOCK_REALTIME);
+            for (int i = 0; i < got; i++) {
+                if (msgs[i].msg_len < sizeof(struct can_frame)) {
+                    std::cerr << "[WARN] TofCanReader: 불완전한 CAN 프레임 수신" << std::endl;
+                    continue;
+                }
+                int64_t rx_ns = mono_now;
+                msghdr& mh = msgs[i].msg_hdr;
+                for (cmsghdr* cm = CMSG_FIRSTHDR(&mh); cm; cm = CMSG_NXTHDR(&mh, cm)) {
+                    if (cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_TIMESTAMPING) continue;
+                    scm_timestamping tss;
+                    memcpy(&tss, CMSG_DATA(cm), sizeof(tss));
+                    const timespec& ts = tss.ts[0];   // 소프트웨어 타임스탬프
+                    if (ts.tv_sec != 0 || ts.tv_nsec != 0) {
+                        int64_t real_rx = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+                        rx_ns = mono_now - (real_now - real_rx);
+                    }
+                }
+                handleFrame(frames[i], rx_ns, snap);
+                m_rx_delay.add((mono_now - rx_ns) / 1e6);
+            }
+            m_snapshot.store(snap);
+            m_frames += got;
+            m_batches++;
+            if (got > m_max_batch) m_max_batch = got;
+            if (got < RX_BATCH) break;
+        }
+    }
+}
+
+// ===== ID별 이력 조회 =====
+
+const CanHistory<TofCanReader::HISTORY_SIZE>* TofCanReader::history(canid_t id) const {
+    if (id == m_tof_can_id) return &m_tof_hist;
+    if (id == m_obstacle_can_id) return &m_obstacle_hist;
+    return nullptr;
+}
+
+bool TofCanReader::latest(canid_t id, CanSample& out, double* age_ms) const {
+    const CanHistory<HISTORY_SIZE>* h = history(id);
+    if (!h || !h->latest(out)) return false;
+    if (age_ms) *age_ms = (clock_ns(CLOCK_MONOTONIC) - out.rx_ns) / 1e6;
+    return true;
+}
+
+int TofCanReader::recent(canid_t id, int window_ms, CanSample* out, int max_out) const {
+    const CanHistory<HISTORY_SIZE>* h = history(id);
+    if (!h) return 0;
+    return h->recent(clock_ns(CLOCK_MONOTONIC), (int64_t)window_ms * 1000000, out, max_out);
+}
+
+double TofCanReader::rateHz(canid_t id, int window_ms) const {
+    const CanHistory<HISTORY_SIZE>* h = history(id);
+    if (!h) return 0.0;
+    return h->rateHz(clock_ns(CLOCK_MONOTONIC), (int64_t)window_ms * 1000000);
+}
+
+void TofCanReader::printStats(FILE* out) const {
+    TofSnapshot s = m_snapshot.load();
+    fprintf(out, "[CAN] frames=%llu batches=%llu (avg %.2f, max %d/recvmmsg) tof=%u obstacle=%u sign=%u\n",
+            (unsigned long long)m_frames, (unsigned long long)m_batches,
+            m_batches ? (double)m_frames / m_batches : 0.0, m_max_batch,
+            s.tof_count, s.obstacle_count, s.sign_right_count);
+    fprintf(out, "[CAN] rate(last 1s) 0x%03X=%.1fHz 0x%03X=%.1fHz\n",
+            (unsigned)m_tof_can_id, rateHz(m_tof_can_id), (unsigned)m_obstacle_can_id, rateHz(m_obstacle_can_id));
+    m_rx_delay.print("can rx->pub", out);
+}
@@ -2,31 +2,122 @@
 
 #include <string>
 #include <linux/can.h> // canid_t를 사용하기 위해 포함
-#include <atomic>      
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include "SeqLock.h"
+#include "CanHistory.h"
+#include "CanSignals.h"
+#include "LatencyStats.h"
 
 // 1. 반환 타입을 위한 구조체 정의
 struct CanData {
-    int distance_mm = -1;       
-    bool obstacle_detected = false; 
+    int distance_mm = -1;
+    bool obstacle_detected = false;
     bool sign_turn_right = false; // ★ 우회전 표지판 감지 플래그
 };
 
+/**
+ * @brief 수신 스레드가 게시하는 최신 센서 상태 (TofCanReader::snapshot)
+ *
+ * 장애물/표지판은 이벤트라 최신 값만 두면 놓칠 수 있으므로 누적 횟수로 게시합니다.
+ * (소비자는 이전에 본 횟수와 비교해 새 이벤트를 판단)
+ */
+struct TofSnapshot {
+    int distance_mm = -1;           // 최근 ToF 거리 (-1: 아직 수신 없음)
+    uint32_t tof_count = 0;         // 받은 ToF 프레임 수
+    uint32_t obstacle_count = 0;    // 장애물 신호(0x300, data[0]=0x01) 누적 횟수
+    uint32_t sign_right_count = 0;  // 우회전 표지판(0x300, data[0]=0x02) 누적 횟수
+    int64_t tof_rx_ns = 0;          // 최근 ToF 프레임 커널 수신 시각 (CLOCK_MONOTONIC ns)
+};
+
 class TofCanReader {
 public:
+    static const canid_t TOF_CAN_ID = can_db::TOF_ID;
+    static const canid_t OBSTACLE_CAN_ID = can_db::DETECT_ID;
+    static const size_t HISTORY_SIZE = 64;   // ID별 이력 슬롯 수
+
     TofCanReader();
     ~TofCanReader();
 
+    /**
+     * @brief CAN_RAW 소켓을 열고 ToF(0x200)/장애물(0x300) ID만 커널 필터로 받도록 설정합니다.
+     *        (SO_TIMESTAMPING으로 커널 수신 타임스탬프 요청)
+     */
     bool open(const std::string& interface_name);
     void close();
 
     /**
      * @brief CAN 버스의 모든 메시지(ToF, Obstacle, Sign)를 읽고 파싱합니다. (논-블로킹)
+     *        start()로 수신 스레드를 돌리는 중에는 호출하지 마세요.
      * @return CanData 구조체
      */
-    CanData readMessages(); 
+    CanData readMessages();
+
+    /**
+     * @brief 수신 스레드 시작: epoll_wait로 잠들었다가 프레임이 오면 recvmmsg로 한 번에 받아
+     *        snapshot()에 게시합니다. (카메라/제어 주기와 무관하게 도착 즉시 반영)
+     * @param cpu 0 이상이면 해당 CPU에 고정
+     */
+    bool start(int cpu = -1);
+
+    /**
+     * @brief 수신 스레드 종료 (eventfd로 epoll_wait를 깨움)
+     */
+    void stop();
+
+    /**
+     * @brief 최신 센서 상태 (seqlock, 시스템 콜 없음, O(1) - 제어 루프에서 매 주기 호출)
+     */
+    TofSnapshot snapshot() const { return m_snapshot.load(); }
+
+    // ----- ID별 타임스탬프 이력 조회 (lock-free, 시스템 콜은 clock_gettime뿐) -----
+
+    /**
+     * @brief 해당 ID의 가장 최근 프레임
+     * @param age_ms (선택) 지금까지 경과 시간 (ms)
+     * @return 수신 이력이 없거나 모르는 ID이면 false
+     */
+    bool latest(canid_t id, CanSample& out, double* age_ms = nullptr) const;
+
+    /**
+     * @brief 최근 window_ms 안에 받은 프레임 (최신 것부터, 최대 HISTORY_SIZE개)
+     * @return out에 채운 개수
+     */
+    int recent(canid_t id, int window_ms, CanSample* out, int max_out) const;
+
+    /**
+     * @brief 최근 window_ms 동안의 수신 빈도 (Hz)
+     */
+    double rateHz(canid_t id, int window_ms = 1000) const;
+
+    /**
+     * @brief 수신 통계 출력 (프레임 수, recvmmsg 배치 크기, 커널 수신 → 게시 지연)
+     *        stop() 이후에 호출하세요.
+     */
+    void printStats(FILE* out = stdout) const;
 
 private:
+    void rxLoop();
+    void handleFrame(const struct can_frame& frame, int64_t rx_ns, TofSnapshot& snap);
+    const CanHistory<HISTORY_SIZE>* history(canid_t id) const;
+
     int m_sock_fd;
     canid_t m_tof_can_id;
-    canid_t m_obstacle_can_id; 
-};
\ No newline at end of file
+    canid_t m_obstacle_can_id;
+
+    // 수신 스레드
+    int m_epoll_fd;
+    int m_stop_fd;                  // eventfd (stop 신호)
+    std::thread m_rx_thread;
+    int m_rx_cpu;
+    SeqLock<TofSnapshot> m_snapshot;
+    CanHistory<HISTORY_SIZE> m_tof_hist;
+    CanHistory<HISTORY_SIZE> m_obstacle_hist;
+
+    // 통계 (수신 스레드만 기록)
+    uint64_t m_frames;
+    uint64_t m_batches;
+    int m_max_batch;
+    LatencyStats m_rx_delay;        // 커널 수신 타임스탬프 → 게시 (ms)
+};
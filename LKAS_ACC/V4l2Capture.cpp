@@ -0,0 +1,341 @@
+#include "V4l2Capture.h"
+#include <iostream>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/videodev2.h>
+
+using namespace std;
+
+// EINTR이면 다시 시도하는 ioctl
+static int xioctl(int fd, unsigned long req, void* arg) {
+    int r;
+    do { r = ioctl(fd, req, arg); } while (r < 0 && errno == EINTR);
+    return r;
+}
+
+static size_t frame_bytes(V4l2PixFmt fmt, int bytesperline, int height) {
+    return (fmt == V4l2PixFmt::NV12) ? (size_t)bytesperline * height * 3 / 2
+                                     : (size_t)bytesperline * height;
+}
+
+void V4l2Frame::toBGR(cv::Mat& dst) const {
+    cv::cvtColor(image, dst, (format == V4l2PixFmt::NV12) ? cv::COLOR_YUV2BGR_NV12
+                                                          : cv::COLOR_YUV2BGR_YUYV);
+}
+
+V4l2Capture::V4l2Capture() :
+    m_fd(-1),
+    m_streaming(false),
+    m_width(0), m_height(0),
+    m_bytesperline(0),
+    m_format(V4l2PixFmt::YUYV),
+    m_file_base(nullptr),
+    m_file_size(0),
+    m_frame_size(0),
+    m_file_frames(0),
+    m_file_next(0),
+    m_file_period(0)
+{
+}
+
+V4l2Capture::~V4l2Capture() {
+    close();
+}
+
+bool V4l2Capture::open(const string& device, int width, int height, V4l2PixFmt fmt,
+                       int num_buffers, bool export_dmabuf) {
+    close();
+
+    m_fd = ::open(device.c_str(), O_RDWR | O_NONBLOCK);
+    if (m_fd < 0) {
+        perror("[ERR] V4l2Capture: 장치 열기 실패");
+        return false;
+    }
+
+    v4l2_capability cap;
+    memset(&cap, 0, sizeof(cap));
+    if (xioctl(m_fd, VIDIOC_QUERYCAP, &cap) < 0) {
+        perror("[ERR] V4l2Capture: VIDIOC_QUERYCAP 실패");
+        close();
+        return false;
+    }
+    uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+        cerr << "[ERR] V4l2Capture: " << device << "는 single-planar 스트리밍 캡처를 지원하지 않습니다.\n";
+        close();
+        return false;
+    }
+
+    // 포맷 설정 (드라이버가 조정한 값을 다시 읽어 사용)
+    v4l2_format f;
+    memset(&f, 0, sizeof(f));
+    f.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    f.fmt.pix.width = width;
+    f.fmt.pix.height = height;
+    f.fmt.pix.pixelformat = (fmt == V4l2PixFmt::NV12) ? V4L2_PIX_FMT_NV12 : V4L2_PIX_FMT_YUYV;
+    f.fmt.pix.field = V4L2_FIELD_NONE;
+    if (xioctl(m_fd, VIDIOC_S_FMT, &f) < 0) {
+        perror("[ERR] V4l2Capture: VIDIOC_S_FMT 실패");
+        close();
+        return false;
+    }
+    if (f.fmt.pix.pixelformat != ((fmt == V4l2PixFmt::NV12) ? V4L2_PIX_FMT_NV12 : V4L2_PIX_FMT_YUYV)) {
+        cerr << "[ERR] V4l2Capture: 요청한 픽셀 포맷을 드라이버가 지원하지 않습니다.\n";
+        close();
+        return false;
+    }
+    m_format = fmt;
+    m_width = f.fmt.pix.width;
+    m_height = f.fmt.pix.height;
+    m_bytesperline = f.fmt.pix.bytesperline;
+    if (m_bytesperline == 0) m_bytesperline = (fmt == V4l2PixFmt::NV12) ? m_width : m_width * 2;
+    if (m_width != width || m_height != height) {
+        cerr << "[WARN] V4l2Capture: 해상도 조정됨 " << width << "x" << height
+             << " -> " << m_width << "x" << m_height << "\n";
+    }
+
+    // 버퍼 요청 + mmap
+    v4l2_requestbuffers req;
+    memset(&req, 0, sizeof(req));
+    req.count = max(2, num_buffers);
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(m_fd, VIDIOC_REQBUFS, &req) < 0 || req.count < 2) {
+        perror("[ERR] V4l2Capture: VIDIOC_REQBUFS 실패");
+        close();
+        return false;
+    }
+
+    m_buffers.resize(req.count);
+    for (uint32_t i = 0; i < req.count; i++) {
+        v4l2_buffer buf;
+        memset(&buf, 0, sizeof(buf));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (xioctl(m_fd, VIDIOC_QUERYBUF, &buf) < 0) {
+            perror("[ERR] V4l2Capture: VIDIOC_QUERYBUF 실패");
+            close();
+            return false;
+        }
+        m_buffers[i].length = buf.length;
+        m_buffers[i].start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, buf.m.offset);
+        if (m_buffers[i].start == MAP_FAILED) {
+            m_buffers[i].start = nullptr;
+            perror("[ERR] V4l2Capture: mmap 실패");
+            close();
+            return false;
+        }
+        if (m_buffers[i].length < frame_bytes(m_format, m_bytesperline, m_height)) {
+            cerr << "[ERR] V4l2Capture: 드라이버 버퍼가 프레임보다 작습니다.\n";
+            close();
+            return false;
+        }
+
+        if (export_dmabuf) {
+            v4l2_exportbuffer exp;
+            memset(&exp, 0, sizeof(exp));
+            exp.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            exp.index = i;
+            exp.flags = O_RDONLY | O_CLOEXEC;
+            if (xioctl(m_fd, VIDIOC_EXPBUF, &exp) < 0) {
+                perror("[WARN] V4l2Capture: VIDIOC_EXPBUF 실패 (DMABUF 없이 계속)");
+            } else {
+                m_buffers[i].dmabuf_fd = exp.fd;
+            }
+        }
+
+        if (xioctl(m_fd, VIDIOC_QBUF, &buf) < 0) {
+            perror("[ERR] V4l2Capture: VIDIOC_QBUF 실패");
+            close();
+            return false;
+        }
+    }
+
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(m_fd, VIDIOC_STREAMON, &type) < 0) {
+        perror("[ERR] V4l2Capture: VIDIOC_STREAMON 실패");
+        close();
+        return false;
+    }
+    m_streaming = true;
+    return true;
+}
+
+bool V4l2Capture::openFile(const string& path, int width, int height, V4l2PixFmt fmt, double fps) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror("[ERR] V4l2Capture: 파일 열기 실패");
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        perror("[ERR] V4l2Capture: fstat 실패");
+        ::close(fd);
+        return false;
+    }
+
+    m_format = fmt;
+    m_width = width;
+    m_height = height;
+    m_bytesperline = (fmt == V4l2PixFmt::NV12) ? width : width * 2;
+    m_frame_size = frame_bytes(fmt, m_bytesperline, height);
+    m_file_frames = (size_t)st.st_size / m_frame_size;
+    if (m_file_frames == 0) {
+        cerr << "[ERR] V4l2Capture: 파일이 한 프레임(" << m_frame_size << " bytes)보다 작습니다.\n";
+        ::close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // 매핑은 fd를 닫아도 유지됨
+    if (p == MAP_FAILED) {
+        perror("[ERR] V4l2Capture: 파일 mmap 실패");
+        return false;
+    }
+    m_file_base = (uint8_t*)p;
+    m_file_size = st.st_size;
+    m_file_next = 0;
+    m_file_period = (fps > 0.0)
+        ? chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(1.0 / fps))
+        : chrono::steady_clock::duration(0);
+    m_file_due = chrono::steady_clock::now();
+    return true;
+}
+
+void V4l2Capture::close() {
+    if (m_fd >= 0) {
+        if (m_streaming) {
+            v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            xioctl(m_fd, VIDIOC_STREAMOFF, &type);
+            m_streaming = false;
+        }
+        for (auto& b : m_buffers) {
+            if (b.dmabuf_fd >= 0) ::close(b.dmabuf_fd);
+            if (b.start) munmap(b.start, b.length);
+        }
+        m_buffers.clear();
+
+        // 드라이버 버퍼 해제
+        v4l2_requestbuffers req;
+        memset(&req, 0, sizeof(req));
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_MMAP;
+        xioctl(m_fd, VIDIOC_REQBUFS, &req);
+
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (m_file_base) {
+        munmap(m_file_base, m_file_size);
+        m_file_base = nullptr;
+    }
+}
+
+void V4l2Capture::fillFrame(V4l2Frame& frame, uint8_t* base) const {
+    frame.format = m_format;
+    if (m_format == V4l2PixFmt::NV12) {
+        frame.image = cv::Mat(m_height * 3 / 2, m_width, CV_8UC1, base, m_bytesperline);
+        frame.luma = cv::Mat(m_height, m_width, CV_8UC1, base, m_bytesperline);
+        frame.chroma = cv::Mat(m_height / 2, m_width / 2, CV_8UC2,
+                               base + (size_t)m_bytesperline * m_height, m_bytesperline);
+    } else {
+        frame.image = cv::Mat(m_height, m_width, CV_8UC2, base, m_bytesperline);
+        frame.luma = cv::Mat();
+        frame.chroma = cv::Mat();
+    }
+}
+
+bool V4l2Capture::grab(V4l2Frame& frame, int timeout_ms) {
+    if (m_file_base) {
+        // 가짜 장치: 파일의 다음 프레임을 fps에 맞춰 넘김
+        if (m_file_period.count() > 0) {
+            this_thread::sleep_until(m_file_due);
+            m_file_due += m_file_period;
+        }
+        size_t n = m_file_next++;
+        fillFrame(frame, m_file_base + (n % m_file_frames) * m_frame_size);
+        frame.index = -1;
+        frame.dmabuf_fd = -1;
+        frame.sequence = (uint32_t)n;
+        frame.timestamp = chrono::steady_clock::now();
+        return true;
+    }
+    if (m_fd < 0) return false;
+
+    pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int r = poll(&pfd, 1, timeout_ms);
+    if (r <= 0) return false; // 시간 초과 또는 오류
+
+    return dequeue(frame);
+}
+
+bool V4l2Capture::grabLatest(V4l2Frame& frame, int timeout_ms, int* drained) {
+    if (drained) *drained = 0;
+    if (!grab(frame, timeout_ms)) return false;
+    if (m_fd < 0) return true; // 파일 재생: 드라이버 큐 없음
+
+    // 이미 완료된 버퍼가 더 있으면 (논-블로킹 DQBUF) 오래된 것을 돌려주고 최신 것만 유지
+    V4l2Frame newer;
+    while (dequeue(newer)) {
+        release(frame);
+        frame = newer;
+        if (drained) (*drained)++;
+    }
+    return true;
+}
+
+// 논-블로킹 DQBUF (완료된 버퍼가 없으면 false)
+bool V4l2Capture::dequeue(V4l2Frame& frame) {
+    v4l2_buffer buf;
+    memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(m_fd, VIDIOC_DQBUF, &buf) < 0) {
+        if (errno != EAGAIN) perror("[WARN] V4l2Capture: VIDIOC_DQBUF 실패");
+        return false;
+    }
+
+    fillFrame(frame, (uint8_t*)m_buffers[buf.index].start);
+    frame.index = buf.index;
+    frame.dmabuf_fd = m_buffers[buf.index].dmabuf_fd;
+    frame.sequence = buf.sequence;
+    // 드라이버 타임스탬프가 CLOCK_MONOTONIC이면 steady_clock과 같은 기준 (Linux)
+    if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        frame.timestamp = chrono::steady_clock::time_point(
+            chrono::duration_cast<chrono::steady_clock::duration>(
+                chrono::seconds(buf.timestamp.tv_sec) + chrono::microseconds(buf.timestamp.tv_usec)));
+    } else {
+        frame.timestamp = chrono::steady_clock::now();
+    }
+    return true;
+}
+
+void V4l2Capture::release(V4l2Frame& frame) {
+    frame.image = cv::Mat();
+    frame.luma = cv::Mat();
+    frame.chroma = cv::Mat();
+    if (frame.index < 0 || m_fd < 0) return; // 파일 재생 또는 이미 반환됨
+
+    v4l2_buffer buf;
+    memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = frame.index;
+    if (xioctl(m_fd, VIDIOC_QBUF, &buf) < 0) {
+        perror("[WARN] V4l2Capture: VIDIOC_QBUF 실패");
+    }
+    frame.index = -1;
+}
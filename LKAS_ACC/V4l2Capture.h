@@ -0,0 +1,123 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+
+// 드라이버에 요청할 픽셀 포맷
+enum class V4l2PixFmt {
+    YUYV,   // packed 4:2:2 (Y0 U Y1 V)
+    NV12,   // Y 평면 + UV interleave 평면 (4:2:0)
+};
+
+/**
+ * @brief 드라이버 버퍼 하나를 가리키는 프레임 (복사 없음)
+ *
+ * grab()이 채우고 release()로 드라이버에 돌려줄 때까지만 유효합니다.
+ * cv::Mat들은 mmap된 드라이버 버퍼를 직접 가리키는 뷰이므로 읽기 전용으로 사용하세요.
+ */
+struct V4l2Frame {
+    V4l2PixFmt format = V4l2PixFmt::YUYV;
+    cv::Mat image;    // YUYV: CV_8UC2 (H x W) / NV12: CV_8UC1 (H*3/2 x W) - cvtColor 입력용
+    cv::Mat luma;     // NV12: Y 평면 CV_8UC1 (H x W), YUYV: 비어 있음
+    cv::Mat chroma;   // NV12: UV 평면 CV_8UC2 (H/2 x W/2), YUYV: 비어 있음
+    int index = -1;   // 드라이버 버퍼 번호 (release용)
+    int dmabuf_fd = -1; // VIDIOC_EXPBUF로 내보낸 DMABUF fd (없으면 -1)
+    uint32_t sequence = 0;                  // 드라이버 프레임 번호 (건너뛴 프레임 확인용)
+    std::chrono::steady_clock::time_point timestamp; // 드라이버 캡처 시각 (CLOCK_MONOTONIC)
+
+    /**
+     * @brief BGR로 변환합니다. (dst 크기가 같으면 재할당 없음)
+     */
+    void toBGR(cv::Mat& dst) const;
+};
+
+/**
+ * @brief V4L2 mmap 스트리밍 캡처 (OpenCV VideoCapture 대체)
+ *
+ * - 드라이버 버퍼를 mmap하고 cv::Mat 뷰로 넘기므로 캡처 경로에 복사/색 변환이 없습니다.
+ * - export_dmabuf=true이면 버퍼마다 DMABUF fd도 내보냅니다. (GPU/ISP로 넘길 때 사용)
+ * - openFile()은 raw YUYV/NV12 파일을 mmap해 같은 인터페이스로 재생합니다. (카메라 없는 테스트용)
+ *   (예: ffmpeg -i in.mp4 -s 320x240 -pix_fmt yuyv422 -f rawvideo lane.yuyv)
+ * - grab()은 캡처 스레드에서, release()는 다른 스레드에서 호출해도 됩니다.
+ * - single-planar 캡처 노드(uvcvideo, vivid, unicam 등)만 지원합니다.
+ */
+class V4l2Capture {
+public:
+    V4l2Capture();
+    ~V4l2Capture();
+
+    /**
+     * @brief V4L2 장치를 열고 스트리밍을 시작합니다.
+     * @param device 장치 경로 (예: "/dev/video0")
+     * @param width 요청 폭 (드라이버가 조정할 수 있음 → width()로 확인)
+     * @param height 요청 높이
+     * @param fmt YUYV 또는 NV12
+     * @param num_buffers 드라이버 버퍼 수 (2 이상)
+     * @param export_dmabuf true이면 VIDIOC_EXPBUF로 DMABUF fd 내보내기
+     */
+    bool open(const std::string& device, int width, int height, V4l2PixFmt fmt,
+              int num_buffers = 4, bool export_dmabuf = false);
+
+    /**
+     * @brief raw 프레임 파일을 가짜 장치로 엽니다. (끝에 도달하면 처음부터 반복)
+     * @param fps 재생 속도 (0이면 대기 없이 최대 속도)
+     */
+    bool openFile(const std::string& path, int width, int height, V4l2PixFmt fmt, double fps = 30.0);
+
+    void close();
+    bool isOpened() const { return m_fd >= 0 || m_file_base != nullptr; }
+
+    /**
+     * @brief 다음 프레임을 꺼냅니다. (드라이버 버퍼를 빌려옴)
+     * @param timeout_ms 프레임 대기 최대 시간
+     * @return 시간 초과/오류 시 false
+     */
+    bool grab(V4l2Frame& frame, int timeout_ms = 1000);
+
+    /**
+     * @brief 드라이버 큐에 쌓인 프레임 중 가장 최신 것만 꺼냅니다. (latest-frame-wins)
+     *
+     * 첫 프레임을 기다린 뒤, 이미 완료된 버퍼가 더 있으면 오래된 것을 바로 드라이버에 돌려주고
+     * 최신 버퍼만 남깁니다. 버퍼 수(num_buffers)를 2로 두면 큐 지연이 최대 1프레임입니다.
+     * @param drained (선택) 버려진 오래된 프레임 수
+     */
+    bool grabLatest(V4l2Frame& frame, int timeout_ms = 1000, int* drained = nullptr);
+
+    /**
+     * @brief grab()으로 빌린 버퍼를 드라이버에 돌려줍니다. (이후 frame의 Mat 뷰는 무효)
+     */
+    void release(V4l2Frame& frame);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    V4l2PixFmt format() const { return m_format; }
+
+private:
+    struct Buffer {
+        void* start = nullptr;
+        size_t length = 0;
+        int dmabuf_fd = -1;
+    };
+
+    void fillFrame(V4l2Frame& frame, uint8_t* base) const;
+    bool dequeue(V4l2Frame& frame);
+
+    int m_fd;
+    std::vector<Buffer> m_buffers;
+    bool m_streaming;
+    int m_width, m_height;
+    int m_bytesperline;
+    V4l2PixFmt m_format;
+
+    // 파일 재생용
+    uint8_t* m_file_base;
+    size_t m_file_size;
+    size_t m_frame_size;
+    size_t m_file_frames;
+    size_t m_file_next;
+    std::chrono::steady_clock::duration m_file_period;
+    std::chrono::steady_clock::time_point m_file_due;
+};
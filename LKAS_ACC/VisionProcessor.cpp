@@ -4,15 +4,33 @@
 using namespace cv;
 using namespace std;
 
+static const double LINE_MIN_PIXELS = 1e3;   // 이보다 적으면 차선 없음 (전체 해상도 기준)
+static const double CONF_FULL_PIXELS = 2e3;  // 이 이상이면 픽셀 양으로는 신뢰도 1.0
+static const double CONF_SE_MAX = 0.1;       // 중심 표준오차가 오차 단위로 이 값이면 신뢰도 0
+static const double BAND_MIN_PIXELS = 150.0; // 밴드 하나에 이보다 적으면 그 밴드는 무시 (전체 해상도 기준)
+static const double TRACK_CONF_MIN = 0.5;    // 이 신뢰도 이상일 때만 추적 창을 좁힘
+static const double TRACK_MARGIN_RATIO = 0.1; // 추적 창 좌우 여유 (프레임 폭 대비, 320px → 32px)
+
 VisionProcessor::VisionProcessor() : 
     m_headless(false),
     m_hmin(0), m_hmax(179), 
     m_smin(0), m_smax(80), 
     m_vmin(200), m_vmax(255),
+    m_ymin(180), m_ymax(255), m_uvmax(40),
     m_alpha(0.30),
     m_deadband(0.05),
     m_kp(0.6),
-    m_ema_error(0.0) 
+    m_ema_error(0.0),
+    m_use_kernel(true),
+    m_verify_kernel(false),
+    m_verify_mismatch(0),
+    m_centroid_mode(CentroidMode::FULL),
+    m_band_count(4),
+    m_lookahead_weight(0.0),
+    m_tracking(false),
+    m_track_locked(false),
+    m_track_lo(0), m_track_hi(0),
+    m_track_margin(0)
 {
     // lkas_someip.cpp의 파라미터와 동일하게 초기화
 }
@@ -28,6 +46,10 @@ void VisionProcessor::init_gui(bool headless) {
         createTrackbar("S max","LKAS Trackbars",&m_smax,255);
         createTrackbar("V min","LKAS Trackbars",&m_vmin,255);
         createTrackbar("V max","LKAS Trackbars",&m_vmax,255);
+        // YUV 입력(processFrameYUV)용
+        createTrackbar("Y min","LKAS Trackbars",&m_ymin,255);
+        createTrackbar("Y max","LKAS Trackbars",&m_ymax,255);
+        createTrackbar("UV max","LKAS Trackbars",&m_uvmax,255);
         
         // 메인 뷰와 마스크 윈도우 생성
         namedWindow("view", WINDOW_AUTOSIZE);
@@ -35,34 +57,184 @@ void VisionProcessor::init_gui(bool headless) {
     }
 }
 
+void VisionProcessor::setCentroidMode(CentroidMode mode, int factor) {
+    factor = max(1, factor);
+    m_centroid_mode = mode;
+    m_sampling = LaneSampling();
+    if (mode == CentroidMode::ROW_SAMPLED) {
+        // 샘플 행끼리는 인접하지 않으므로 가로 방향(3, 5) 모폴로지만 적용
+        m_sampling.row_step = factor;
+        m_sampling.vertical = false;
+    } else if (mode == CentroidMode::DOWNSCALED) {
+        // 축소 격자에 맞춰 커널도 축소 (1/4 이하에서는 OPEN 생략)
+        m_sampling.row_step = factor;
+        m_sampling.col_step = factor;
+        m_sampling.open_radius = (factor >= 4) ? 0 : 1;
+        m_sampling.close_radius = max(1, 2 / factor);
+    }
+}
+
+void VisionProcessor::setHsvThreshold(const LaneThreshold& th) {
+    m_hmin = th.hmin; m_hmax = th.hmax;
+    m_smin = th.smin; m_smax = th.smax;
+    m_vmin = th.vmin; m_vmax = th.vmax;
+}
+
+void VisionProcessor::setBandCount(int k) {
+    m_band_count = min(max(k, 1), LKAS_MAX_BANDS);
+}
+
+void VisionProcessor::setTracking(bool enable) {
+    m_tracking = enable;
+    m_track_locked = false;
+}
+
 LKASResult VisionProcessor::processFrame(Mat& frame) {
     
-    LKASResult result;
-    
     // 1. ROI: 하단 50%
     int y0 = frame.rows * 0.5;
     Rect roiRect(0, y0, frame.cols, frame.rows - y0);
     
-    // 2. HSV & Threshold
-    static Mat hsv, mask, roiMask; // (static으로 선언하여 매번 생성 방지)
-    cvtColor(frame, hsv, COLOR_BGR2HSV);
-    inRange(hsv, Scalar(m_hmin, m_smin, m_vmin), 
-                 Scalar(m_hmax, m_smax, m_vmax), mask);
-
-    // 3. ROI 마스크 및 노이즈 제거
-    roiMask = mask(roiRect).clone(); // ROI 영역만 복사
-    morphologyEx(roiMask, roiMask, MORPH_OPEN,  getStructuringElement(MORPH_RECT, Size(3,3)));
-    morphologyEx(roiMask, roiMask, MORPH_CLOSE, getStructuringElement(MORPH_RECT, Size(5,5)));
+    // 2~3. HSV 임계값 + 노이즈 제거 + 중심점 모멘트
+    LaneScan scan;
+    if (m_use_kernel && frame.type() == CV_8UC3) {
+        // 추적 중이면 이전 중심점 주변 창만 처리
+        int x0, x1;
+        trackingWindow(frame.cols, x0, x1);
+
+        // ROI 행만 처리하는 고속 커널 (할당 없음)
+        LaneThreshold th;
+        th.hmin = m_hmin; th.hmax = m_hmax;
+        th.smin = m_smin; th.smax = m_smax;
+        th.vmin = m_vmin; th.vmax = m_vmax;
+        LaneMoments km;
+        m_kernel.process(frame.ptr<uint8_t>(y0) + x0 * 3, frame.step, x1 - x0, roiRect.height, th, km, m_sampling);
+        scanFromKernel(km, x0, x1, scan);
+        if (trackingMissed(scan, frame.cols)) {
+            x0 = 0;
+            x1 = frame.cols;
+            m_kernel.process(frame.ptr<uint8_t>(y0), frame.step, x1, roiRect.height, th, km, m_sampling);
+            scanFromKernel(km, x0, x1, scan);
+        }
+
+        if (m_verify_kernel && m_centroid_mode == CentroidMode::FULL && x1 - x0 == frame.cols) {
+            verifyKernel(frame, roiRect, km);
+        }
+    } else {
+        Moments m = computeMaskOpenCV(frame, roiRect, m_roiMask);
+        scan.mask = m_roiMask;
+        scan.m00 = m.m00;
+        scan.m10 = m.m10;
+
+        // 신뢰도 계산용 행별 합
+        m_refRowCount.assign(scan.mask.rows, 0);
+        m_refRowSum.assign(scan.mask.rows, 0);
+        for (int y = 0; y < scan.mask.rows; y++) {
+            const uint8_t* p = scan.mask.ptr<uint8_t>(y);
+            for (int x = 0; x < scan.mask.cols; x++) {
+                if (p[x]) { m_refRowCount[y]++; m_refRowSum[y] += x; }
+            }
+        }
+        scan.rowCount = m_refRowCount.data();
+        scan.rowSum = m_refRowSum.data();
+        scan.rows = scan.mask.rows;
+        scan.x1 = frame.cols;
+    }
+
+    return evaluate(scan, frame.cols, roiRect.height);
+}
+
+LKASResult VisionProcessor::processFrameYUV(const Mat& luma, const Mat& chroma, LaneYuvLayout layout) {
+    const int cols = luma.cols;
+
+    // 1. ROI: 하단 50% (NV12 크로마 행이 맞도록 짝수 행에서 시작)
+    int y0 = (luma.rows / 2) & ~1;
+    int roi_rows = luma.rows - y0;
+
+    // 추적 창도 크로마 쌍에 맞춰 짝수 x에서 시작
+    int x0, x1;
+    trackingWindow(cols, x0, x1);
+    x0 &= ~1;
+
+    // 2~3. Y / 크로마 거리 임계값 + 노이즈 제거 + 중심점 모멘트 (HSV 변환 없음)
+    LaneYuvThreshold th;
+    th.ymin = m_ymin; th.ymax = m_ymax;
+    th.chroma_max = m_uvmax;
+    LaneMoments km;
+    LaneScan scan;
+    for (;;) {
+        if (layout == LaneYuvLayout::YUYV) {
+            m_kernel.processYUV(layout, luma.ptr<uint8_t>(y0) + x0 * 2, luma.step, nullptr, 0,
+                                x1 - x0, roi_rows, th, km, m_sampling);
+        } else {
+            m_kernel.processYUV(layout, luma.ptr<uint8_t>(y0) + x0, luma.step,
+                                chroma.ptr<uint8_t>(y0 / 2) + x0, chroma.step,
+                                x1 - x0, roi_rows, th, km, m_sampling);
+        }
+        scanFromKernel(km, x0, x1, scan);
+        if (!trackingMissed(scan, cols)) break;
+        x0 = 0;   // 추적 창에서 놓침 → 같은 프레임에서 ROI 전체를 다시 처리
+        x1 = cols;
+    }
+    return evaluate(scan, cols, roi_rows);
+}
+
+void VisionProcessor::trackingWindow(int cols, int& x0, int& x1) const {
+    x0 = 0;
+    x1 = cols;
+    if (m_tracking && m_track_locked) {
+        x0 = max(0, m_track_lo - m_track_margin);
+        x1 = min(cols, m_track_hi + m_track_margin);
+    }
+}
+
+bool VisionProcessor::trackingMissed(const LaneScan& scan, int cols) {
+    // 창이 이미 ROI 전체이거나 창 안에서 찾았으면 그대로 사용
+    if (scan.x1 - scan.x0 >= cols || scan.m00 > LINE_MIN_PIXELS) return false;
+    // 창 밖으로 빠르게 움직였거나 창이 좁혀진 뒤 놓침: 차선 없음(line_found=false)은 ROI 전체로만 판단
+    // (main.cpp는 우회전 대기 중 line_found=false를 교차로 입구로 보고 HARD_RIGHT_TURN으로 전이)
+    m_track_locked = false;
+    return true;
+}
+
+void VisionProcessor::scanFromKernel(const LaneMoments& km, int x0, int x1, LaneScan& scan) {
+    scan.mask = Mat(m_kernel.rows(), m_kernel.cols(), CV_8UC1, (void*)m_kernel.mask());
+
+    // 샘플링 시에는 샘플 하나가 (row_step x col_step) 픽셀을 대표
+    scan.row_step = m_sampling.row_step;
+    scan.area = (double)m_sampling.row_step * m_sampling.col_step;
+    scan.m00 = (double)km.m00 * scan.area;
+    scan.m10 = ((double)km.m10 + (double)x0 * km.m00) * scan.area; // 창 좌표 → 프레임 좌표
+    scan.rowCount = m_kernel.rowCount();
+    scan.rowSum = m_kernel.rowSum();
+    scan.rows = m_kernel.rows();
+    scan.x0 = x0;
+    scan.x1 = x1;
+}
+
+LKASResult VisionProcessor::evaluate(const LaneScan& scan, int cols, int roi_rows) {
+
+    LKASResult result;
 
     // 4. 중심점(Centroid) → 오차 계산
-    Moments m = moments(roiMask, true);
-    result.line_found = (m.m00 > 1e3); // (픽셀이 1000개 이상일 때만 유효)
+    result.line_found = (scan.m00 > LINE_MIN_PIXELS); // (픽셀이 1000개 이상일 때만 유효)
     
-    double cx = result.line_found ? (m.m10 / m.m00) : (frame.cols / 2.0);
+    double cx = result.line_found ? (scan.m10 / scan.m00) : (cols / 2.0);
     result.center_x = (int)cx;
+    result.confidence = result.line_found
+        ? estimateConfidence(scan.rowCount, scan.rowSum, scan.rows, scan.m00, cx, scan.x0, cols) : 0.0;
+    result.search_x0 = scan.x0;
+    result.search_x1 = scan.x1;
+
+    // 밴드별 중심점 + 곡선 피팅 (이미 구한 행별 합만 사용)
+    fitBands(scan.rowCount, scan.rowSum, scan.rows, scan.row_step, scan.area, roi_rows, scan.x0, cols, result);
+    updateTracking(result, cols);
     
     // -1.0 ~ +1.0 사이의 오차
-    double e = (cx - (frame.cols / 2.0)) / (frame.cols / 2.0);
+    double e = (cx - (cols / 2.0)) / (cols / 2.0);
+    if (result.line_found && result.bands_found >= 2) {
+        e = (1.0 - m_lookahead_weight) * e + m_lookahead_weight * result.lookahead_error;
+    }
     
     // 5. EMA 필터 (오차 스무딩)
     m_ema_error = m_alpha * e + (1.0 - m_alpha) * m_ema_error;
@@ -83,18 +255,171 @@ LKASResult VisionProcessor::processFrame(Mat& frame) {
     }
 
     if (!m_headless) {
-        imshow("mask(roi)", roiMask);
+        imshow("mask(roi)", scan.mask);
     }
     
     return result;
 }
 
+double VisionProcessor::estimateConfidence(const uint32_t* rowCount, const uint32_t* rowSum, int rows,
+                                           double m00_full, double cx, int x_offset, int cols) const {
+    // (1) 픽셀 양: 판정 기준(1000)의 두 배 이상이면 1.0
+    double mass = min(1.0, m00_full / CONF_FULL_PIXELS);
+
+    // (2) 행별 중심의 흩어짐 → 중심 추정의 표준오차 (행 수가 적을수록 커짐)
+    double w = 0.0, var = 0.0;
+    int hit_rows = 0;
+    for (int y = 0; y < rows; y++) {
+        if (rowCount[y] == 0) continue;
+        double rc = (double)rowSum[y] / rowCount[y] + x_offset;
+        var += rowCount[y] * (rc - cx) * (rc - cx);
+        w += rowCount[y];
+        hit_rows++;
+    }
+    if (hit_rows == 0) return 0.0;
+    double se = sqrt(var / w / hit_rows) / (cols / 2.0); // 오차(-1~1) 단위
+
+    return mass * max(0.0, 1.0 - se / CONF_SE_MAX);
+}
+
+void VisionProcessor::fitBands(const uint32_t* rowCount, const uint32_t* rowSum, int rows,
+                               int row_step, double area, int roi_rows, int x_offset, int cols,
+                               LKASResult& result) const {
+    const int K = m_band_count;
+    double cnt[LKAS_MAX_BANDS] = {};
+    double sum[LKAS_MAX_BANDS] = {};
+
+    // 샘플 행 i는 ROI 행 i*row_step → 밴드 (i*row_step*K / roi_rows)
+    for (int i = 0; i < rows; i++) {
+        int b = (int)((int64_t)i * row_step * K / roi_rows);
+        b = min(b, K - 1);
+        cnt[b] += rowCount[i];
+        sum[b] += rowSum[i];
+    }
+
+    // 가중 최소제곱 정규방정식 (가중치 = 밴드 픽셀 수)
+    double half = cols / 2.0;
+    double S[5] = {}, T[3] = {};
+    result.bands_found = 0;
+    for (int b = 0; b < K; b++) {
+        // 밴드 0 = 가장 아래 (ROI 행 순서와 반대)
+        int r = K - 1 - b;
+        result.band_cx[b] = -1;
+        if (cnt[r] * area < BAND_MIN_PIXELS) continue;
+
+        double bx = sum[r] / cnt[r] + x_offset;
+        double e = (bx - half) / half;
+        double v = (b + 0.5) / K;
+        double w = cnt[r];
+        double vp = 1.0;
+        for (int p = 0; p < 5; p++) { S[p] += w * vp; vp *= v; }
+        T[0] += w * e; T[1] += w * e * v; T[2] += w * e * v * v;
+        result.band_cx[b] = (int)bx;
+        result.bands_found++;
+    }
+    for (int b = K; b < LKAS_MAX_BANDS; b++) result.band_cx[b] = -1;
+
+    double c0 = 0.0, c1 = 0.0, c2 = 0.0;
+    bool fitted = false;
+    if (result.bands_found >= 3) {
+        // 2차: | S0 S1 S2 | |c0|   |T0|
+        //      | S1 S2 S3 | |c1| = |T1|
+        //      | S2 S3 S4 | |c2|   |T2|
+        double det = S[0] * (S[2] * S[4] - S[3] * S[3])
+                   - S[1] * (S[1] * S[4] - S[3] * S[2])
+                   + S[2] * (S[1] * S[3] - S[2] * S[2]);
+        if (fabs(det) > 1e-9 * S[0] * S[0] * S[0]) {
+            c0 = (T[0] * (S[2] * S[4] - S[3] * S[3])
+                - S[1] * (T[1] * S[4] - S[3] * T[2])
+                + S[2] * (T[1] * S[3] - S[2] * T[2])) / det;
+            c1 = (S[0] * (T[1] * S[4] - T[2] * S[3])
+                - T[0] * (S[1] * S[4] - S[3] * S[2])
+                + S[2] * (S[1] * T[2] - T[1] * S[2])) / det;
+            c2 = (S[0] * (S[2] * T[2] - S[3] * T[1])
+                - S[1] * (S[1] * T[2] - T[1] * S[2])
+                + T[0] * (S[1] * S[3] - S[2] * S[2])) / det;
+            fitted = true;
+        }
+    }
+    if (!fitted && result.bands_found >= 2) {
+        // 직선: | S0 S1 | |c0| = |T0|
+        //       | S1 S2 | |c1|   |T1|
+        double det = S[0] * S[2] - S[1] * S[1];
+        if (fabs(det) > 1e-9 * S[0] * S[0]) {
+            c0 = (T[0] * S[2] - S[1] * T[1]) / det;
+            c1 = (S[0] * T[1] - S[1] * T[0]) / det;
+            fitted = true;
+        }
+    }
+    if (!fitted && result.bands_found >= 1) {
+        c0 = T[0] / S[0];
+    }
+
+    result.lookahead_error = max(-1.0, min(1.0, c0 + c1 + c2));
+    result.heading = c1;
+    result.curvature = 2.0 * c2;
+}
+
+void VisionProcessor::updateTracking(const LKASResult& result, int cols) {
+    if (!m_tracking) return;
+
+    if (result.line_found && result.confidence >= TRACK_CONF_MIN) {
+        // 획득/유지: 중심점과 밴드 중심점을 모두 덮는 최소 창 (곡선 대응)
+        m_track_locked = true;
+        m_track_lo = m_track_hi = result.center_x;
+        for (int b = 0; b < m_band_count; b++) {
+            if (result.band_cx[b] < 0) continue;
+            m_track_lo = min(m_track_lo, result.band_cx[b]);
+            m_track_hi = max(m_track_hi, result.band_cx[b]);
+        }
+        m_track_margin = max(8, (int)(cols * TRACK_MARGIN_RATIO));
+    } else if (m_track_locked) {
+        // 놓침/신뢰도 낮음: 같은 중심에서 창을 두 배로 넓힘
+        m_track_margin *= 2;
+        if (m_track_lo - m_track_margin <= 0 && m_track_hi + m_track_margin >= cols) {
+            m_track_locked = false; // 창이 ROI 전체 → 다음 프레임은 전체 탐색(재획득)
+        }
+    }
+}
+
+Moments VisionProcessor::computeMaskOpenCV(const Mat& frame, const Rect& roiRect, Mat& roiMask) {
+    // HSV & Threshold (전체 프레임)
+    cvtColor(frame, m_hsv, COLOR_BGR2HSV);
+    inRange(m_hsv, Scalar(m_hmin, m_smin, m_vmin), 
+                   Scalar(m_hmax, m_smax, m_vmax), m_mask);
+
+    // ROI 마스크 및 노이즈 제거
+    m_mask(roiRect).copyTo(roiMask); // ROI 영역만 복사
+    morphologyEx(roiMask, roiMask, MORPH_OPEN,  getStructuringElement(MORPH_RECT, Size(3,3)));
+    morphologyEx(roiMask, roiMask, MORPH_CLOSE, getStructuringElement(MORPH_RECT, Size(5,5)));
+
+    return moments(roiMask, true);
+}
+
+void VisionProcessor::verifyKernel(const Mat& frame, const Rect& roiRect, const LaneMoments& km) {
+    Moments ref = computeMaskOpenCV(frame, roiRect, m_refMask);
+    Mat kmask(m_kernel.rows(), m_kernel.cols(), CV_8UC1, (void*)m_kernel.mask());
+    int diff_px = countNonZero(kmask != m_refMask);
+    if (diff_px != 0 || (double)km.m00 != ref.m00 || (double)km.m10 != ref.m10) {
+        m_verify_mismatch++;
+        cerr << "[WARN] LaneKernel mismatch #" << m_verify_mismatch
+             << ": diff_px=" << diff_px
+             << " m00=" << km.m00 << "/" << ref.m00
+             << " m10=" << km.m10 << "/" << ref.m10 << endl;
+    }
+}
+
 void VisionProcessor::visualize(Mat& vis, const LKASResult& result) {
     if (m_headless) return;
     
     // ROI 영역 표시
     Rect roiRect(0, vis.rows * 0.5, vis.cols, vis.rows * 0.5);
     rectangle(vis, roiRect, Scalar(0,255,255), 1);
+    if (result.search_x1 - result.search_x0 < vis.cols) {
+        // 추적 창 표시
+        rectangle(vis, Rect(result.search_x0, roiRect.y, result.search_x1 - result.search_x0, roiRect.height),
+                  Scalar(255,128,0), 1);
+    }
     
     // 중앙선 표시
     line(vis, Point(vis.cols/2, 0), Point(vis.cols/2, vis.rows), Scalar(0,255,0), 1);
@@ -103,6 +428,14 @@ void VisionProcessor::visualize(Mat& vis, const LKASResult& result) {
     if (result.line_found) {
         Point p(result.center_x, (int)(vis.rows * 0.75)); // ROI의 중앙
         circle(vis, p, 4, Scalar(0,0,255), -1);
+
+        // 밴드별 중심점
+        int band_h = (vis.rows - roiRect.y) / m_band_count;
+        for (int b = 0; b < m_band_count; b++) {
+            if (result.band_cx[b] < 0) continue;
+            int by = vis.rows - band_h * b - band_h / 2;
+            circle(vis, Point(result.band_cx[b], by), 3, Scalar(255,0,255), -1);
+        }
     }
 
     // 상태 텍스트 표시
@@ -113,6 +446,8 @@ void VisionProcessor::visualize(Mat& vis, const LKASResult& result) {
     putText(vis, action, Point(8,18), FONT_HERSHEY_SIMPLEX, 0.55, Scalar(0,255,255), 2);
     putText(vis, format("mode=%d  e=%.3f", result.drive_mode, result.error),
             Point(8,40), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255,255,0), 1);
+    putText(vis, format("look=%.3f  curv=%.3f  bands=%d", result.lookahead_error, result.curvature, result.bands_found),
+            Point(8,60), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255,255,0), 1);
     
     // (ACC 시각화는 main.cpp에서 별도 처리)
 }
\ No newline at end of file
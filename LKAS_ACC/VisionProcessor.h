@@ -1,6 +1,10 @@
 #pragma once
 
 #include <opencv2/opencv.hpp>
+#include "LaneKernel.h"
+
+// 다중 밴드 스캔의 최대 밴드 수
+static const int LKAS_MAX_BANDS = 8;
 
 // LKAS 처리 결과를 담을 구조체
 struct LKASResult {
@@ -8,6 +12,29 @@ struct LKASResult {
     bool line_found = false; // 차선 감지 여부
     double error = 0.0;    // -1.0 ~ +1.0 사이의 오차
     int center_x = 0;     // 이미지 상의 차선 중심 x좌표
+    double confidence = 0.0; // 0.0 ~ 1.0 중심점 신뢰도 (픽셀 양 + 행별 중심의 흩어짐)
+
+    // 다중 밴드 스캔 (ROI를 K개 가로 띠로 나눔, 밴드 0 = 가장 아래)
+    // 곡선 피팅 좌표: v = 0 (ROI 하단) ~ 1 (ROI 상단), 오차 e(v) = c0 + c1*v + c2*v^2
+    int bands_found = 0;             // 중심점을 찾은 밴드 수
+    int band_cx[LKAS_MAX_BANDS] = {}; // 밴드별 중심 x좌표 (못 찾으면 -1)
+    double lookahead_error = 0.0;    // ROI 상단(v=1)에서의 오차 (-1.0 ~ +1.0, 미리 보기)
+    double heading = 0.0;            // ROI 하단에서의 기울기 de/dv
+    double curvature = 0.0;          // d^2e/dv^2 (2차 피팅, 밴드 3개 미만이면 0)
+
+    // 이번 프레임에서 실제로 처리한 ROI 가로 구간 [search_x0, search_x1) (추적 모드)
+    int search_x0 = 0;
+    int search_x1 = 0;
+
+    // 이 결과를 만든 프레임의 나이 (판단 시점 - 캡처 시각, ms). 제어 스레드가 채움
+    double frame_age_ms = 0.0;
+};
+
+// 중심점 추정 방식 (정확도 ↔ 프레임당 CPU 시간)
+enum class CentroidMode {
+    FULL,           // ROI 전체 픽셀 (기본, 기존 moments()와 동일)
+    ROW_SAMPLED,    // N행마다 1행 (가로 방향 모폴로지만 적용)
+    DOWNSCALED,     // 1/N 다운스케일 격자 (N = 2 또는 4 권장)
 };
 
 class VisionProcessor {
@@ -27,6 +54,17 @@ public:
      */
     LKASResult processFrame(cv::Mat& frame);
 
+    /**
+     * @brief 카메라 YUV 버퍼를 그대로 받아 LKAS 로직을 처리합니다. (BGR/HSV 변환 없음)
+     *
+     * 차선 = Y가 [Y min, Y max] 안이고 |U-128| + |V-128| <= UV max (밝고 무채색)
+     * @param luma YUYV: packed CV_8UC2 (H x W) / NV12: Y 평면 CV_8UC1 (H x W)
+     * @param chroma NV12: UV 평면 CV_8UC2 (H/2 x W/2), YUYV면 빈 Mat
+     * @param layout YUYV 또는 NV12
+     * @return LKASResult 구조체
+     */
+    LKASResult processFrameYUV(const cv::Mat& luma, const cv::Mat& chroma, LaneYuvLayout layout);
+
     /**
      * @brief 시각화 이미지(vis)에 LKAS 정보를 그립니다.
      * @param vis 시각화할 Mat 객체 (frame.clone())
@@ -34,15 +72,170 @@ public:
      */
     void visualize(cv::Mat& vis, const LKASResult& result);
 
+    /**
+     * @brief ROI 전용 고속 커널(LaneKernel) 사용 여부 (기본: 사용)
+     * @param enable false이면 기존 OpenCV 경로(cvtColor/inRange/morphologyEx/moments) 사용
+     */
+    void setFastKernel(bool enable) { m_use_kernel = enable; }
+
+    /**
+     * @brief 매 프레임 고속 커널 결과를 기존 OpenCV 경로와 비트 단위로 비교합니다. (디버그용)
+     * @param enable true이면 불일치 시 경고 출력 (처리 시간은 두 배 이상)
+     */
+    void setVerifyKernel(bool enable) { m_verify_kernel = enable; }
+
+    /**
+     * @brief setVerifyKernel(true) 이후 마스크/모멘트가 OpenCV 경로와 달랐던 프레임 수
+     */
+    uint64_t verifyMismatches() const { return m_verify_mismatch; }
+
+    /**
+     * @brief HSV 임계값 설정 (트랙바와 같은 값, 테스트/벤치마크용)
+     */
+    void setHsvThreshold(const LaneThreshold& th);
+
+    /**
+     * @brief 고속 커널의 임계값 판정 방식 설정
+     * @param mode AUTO(기본): H 범위가 전체(0~179)면 HSV 변환 없이 밝기/채도 컬러 게이트,
+     *             H 범위를 좁혔을 때만 HSV 계산. HSV: 항상 HSV 계산
+     */
+    void setThresholdMode(LaneThresholdMode mode) { m_kernel.setThresholdMode(mode); }
+
+    /**
+     * @brief 중심점 추정 방식 설정 (고속 커널 사용 시에만 적용)
+     * @param mode FULL / ROW_SAMPLED / DOWNSCALED
+     * @param factor ROW_SAMPLED: N행마다 1행, DOWNSCALED: 1/N 축소 (1 이상)
+     */
+    void setCentroidMode(CentroidMode mode, int factor = 2);
+
+    /**
+     * @brief 다중 밴드 스캔의 밴드 수 설정 (기본: 4)
+     * @param k 1 ~ LKAS_MAX_BANDS (1이면 곡선 피팅 없음)
+     */
+    void setBandCount(int k);
+
+    /**
+     * @brief 조향 판단에 섞을 미리 보기 오차 비중 (기본: 0, 기존 동작)
+     * @param w 0.0 ~ 1.0, 판단 오차 = (1-w)*중심점 오차 + w*lookahead_error
+     */
+    void setLookaheadWeight(double w) { m_lookahead_weight = w; }
+
+    /**
+     * @brief 연속 조향(SteeringController, --steer-pd)의 비례 게인 (오차 1.0당 조향값)
+     */
+    double steeringKp() const { return m_kp; }
+
+    /**
+     * @brief 추적 모드 설정 (기본: 끔, 고속 커널 사용 시에만 적용)
+     *
+     * 차선을 찾으면 다음 프레임은 이전 중심점(밴드 중심점 포함) 주변 창만 처리합니다.
+     * 신뢰도가 낮으면 창을 두 배씩 넓히고, 창이 ROI 전체가 되면 추적을 풉니다.
+     * 창 안에서 차선을 놓치면 같은 프레임에서 전체 ROI를 다시 탐색하므로,
+     * line_found=false는 항상 전체 ROI 기준입니다.
+     */
+    void setTracking(bool enable);
+
 private:
+    // 임계값 + 모폴로지 단계의 결과 (BGR / YUV 입력 공통)
+    struct LaneScan {
+        cv::Mat mask;                   // ROI 마스크 (표시용)
+        double m00 = 0.0, m10 = 0.0;    // 전체 해상도 환산 모멘트 (프레임 x좌표)
+        const uint32_t* rowCount = nullptr; // 샘플 행별 픽셀 수 / x좌표 합 (x0 기준)
+        const uint32_t* rowSum = nullptr;
+        int rows = 0;                   // 샘플 행 수
+        int row_step = 1;               // 샘플 행 하나가 대표하는 ROI 행 수
+        double area = 1.0;              // 샘플 하나가 대표하는 픽셀 수
+        int x0 = 0, x1 = 0;             // 처리한 가로 구간
+    };
+
+    /**
+     * @brief 이번 프레임에서 처리할 가로 구간 (추적 중이 아니면 전체)
+     */
+    void trackingWindow(int cols, int& x0, int& x1) const;
+
+    /**
+     * @brief 좁힌 추적 창에서 차선을 놓쳤는지 확인합니다. (놓쳤으면 추적을 풀고 true)
+     *
+     * true이면 호출한 쪽이 같은 프레임에서 ROI 전체를 다시 처리해 그 결과로 판단합니다.
+     */
+    bool trackingMissed(const LaneScan& scan, int cols);
+
+    /**
+     * @brief 고속 커널 결과를 LaneScan으로 정리합니다.
+     */
+    void scanFromKernel(const LaneMoments& km, int x0, int x1, LaneScan& scan);
+
+    /**
+     * @brief 중심점/신뢰도/밴드 피팅/EMA/판단 (입력 형식과 무관한 공통 후단)
+     */
+    LKASResult evaluate(const LaneScan& scan, int cols, int roi_rows);
+
+    /**
+     * @brief 기존 OpenCV 경로로 ROI 마스크와 모멘트를 계산합니다. (기준 구현)
+     */
+    cv::Moments computeMaskOpenCV(const cv::Mat& frame, const cv::Rect& roiRect, cv::Mat& roiMask);
+
+    /**
+     * @brief 고속 커널 결과와 기준 구현 결과를 비교하고 불일치 시 경고를 출력합니다.
+     */
+    void verifyKernel(const cv::Mat& frame, const cv::Rect& roiRect, const LaneMoments& km);
+
+    /**
+     * @brief 중심점 신뢰도 계산
+     * @param rowCount 샘플 행별 차선 픽셀 수
+     * @param rowSum 샘플 행별 차선 픽셀 x좌표 합
+     * @param m00_full 전체 해상도 환산 차선 픽셀 수
+     * @param cx 중심점 x좌표
+     * @param x_offset 행별 x좌표의 기준 (처리 창의 시작 x)
+     */
+    double estimateConfidence(const uint32_t* rowCount, const uint32_t* rowSum, int rows,
+                              double m00_full, double cx, int x_offset, int cols) const;
+
+    /**
+     * @brief 행별 합을 K개 밴드로 묶어 밴드별 중심점을 구하고 직선/2차 곡선을 피팅합니다.
+     * @param row_step 샘플 행 하나가 대표하는 ROI 행 수
+     * @param area 샘플 하나가 대표하는 픽셀 수 (전체 해상도 환산용)
+     * @param roi_rows ROI 높이 (픽셀)
+     * @param x_offset 행별 x좌표의 기준 (처리 창의 시작 x)
+     */
+    void fitBands(const uint32_t* rowCount, const uint32_t* rowSum, int rows,
+                  int row_step, double area, int roi_rows, int x_offset, int cols,
+                  LKASResult& result) const;
+
+    /**
+     * @brief 이번 결과로 다음 프레임의 추적 창을 갱신합니다.
+     */
+    void updateTracking(const LKASResult& result, int cols);
+
     bool m_headless;
     
     // LKAS 파라미터 (lkas_someip.cpp에서 가져옴)
     int m_hmin, m_hmax, m_smin, m_smax, m_vmin, m_vmax;
+    int m_ymin, m_ymax, m_uvmax;   // YUV 입력용 (Y 범위, 크로마 거리 최대값)
     double m_alpha;
     double m_deadband;
-    double m_kp;
+    double m_kp;        // 연속 조향 비례 게인 (steeringKp, 3단계 판단에는 쓰지 않음)
     
     // EMA 필터링을 위한 내부 변수
     double m_ema_error; 
+
+    // ROI 전용 고속 커널 (버퍼 재사용)
+    LaneKernel m_kernel;
+    bool m_use_kernel;
+    bool m_verify_kernel;
+    uint64_t m_verify_mismatch;
+    CentroidMode m_centroid_mode;
+    LaneSampling m_sampling;
+    std::vector<uint32_t> m_refRowCount, m_refRowSum;
+    int m_band_count;
+    double m_lookahead_weight;
+
+    // 추적 모드: 다음 프레임에서 처리할 창 = [m_track_lo - margin, m_track_hi + margin)
+    bool m_tracking;
+    bool m_track_locked;
+    int m_track_lo, m_track_hi;
+    int m_track_margin;
+
+    // 기존 OpenCV 경로용 버퍼 (프레임마다 재할당 방지)
+    cv::Mat m_hsv, m_mask, m_roiMask, m_refMask;
 };
\ No newline at end of file
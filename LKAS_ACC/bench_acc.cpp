@@ -0,0 +1,221 @@
+/**
+ * @file bench_acc.cpp
+ * @brief ToF 기록을 재생해 ACC 속도 명령의 부드러움을 비교합니다.
+ *        (거리 비례 제어 computeBaseSpeed vs 칼만 추정 + 헤드웨이 간격 제어 computeGapSpeed)
+ *
+ * - 10ms 제어 주기마다 그 시각까지 수신된 ToF 샘플만 반영해 두 제어기의 명령을 계산
+ * - 명령 변화량(평균/RMS/최대), 방향 반전 횟수, 정지 주기 비율, 첫 정지 시각을 출력
+ * - 합성 궤적(참값이 있음)에서는 RangeTracker의 거리/변화율 오차도 출력
+ * - RangeTracker::update() 한 번의 처리 시간(ns)
+ * - 갑자기 나타난 물체(1.5m → 0.1m 계단): 칼만 게이트가 거르는 동안에도 첫 근접 샘플에서
+ *   간격 제어 명령이 0인지 확인 (아니면 종료 코드 1)
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o bench_acc bench_acc.cpp ACCController.cpp RangeTracker.cpp -std=c++17
+ *
+ * [ToF 기록 방법]
+ * ./lkas_main --tof-log tof.csv ...   (rx_ns,distance_mm 한 줄씩)
+ *
+ * [실행 방법]
+ * ./bench_acc [tof.csv ...]
+ * 파일을 주지 않으면 합성 궤적(접근 → 정지 → 앞 물체 이탈, 측정 잡음/튀는 값/수신 지터/누락 포함)을 사용합니다.
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "ACCController.h"
+#include "RangeTracker.h"
+
+using namespace std;
+
+static const int64_t TICK_NS = 10 * 1000000LL;   // main.cpp CTRL_TICK_MS
+
+struct TofRecord {
+    int64_t rx_ns;
+    int distance_mm;
+    double truth_m;      // 합성 궤적만 (기록 파일은 NAN)
+    double truth_rate;
+};
+
+static bool load_csv(const string& path, vector<TofRecord>& out) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) { perror(("[ERR] " + path).c_str()); return false; }
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        long long ns;
+        int mm;
+        if (sscanf(line, "%lld,%d", &ns, &mm) == 2) out.push_back({ns, mm, NAN, NAN});
+    }
+    fclose(f);
+    return !out.empty();
+}
+
+// 합성 궤적: 2.0m에서 0.6m/s로 접근 → 0.55m에서 2초 정지 → 앞 물체가 0.4m/s로 멀어짐
+static vector<TofRecord> synth_trace() {
+    mt19937 rng(1234);
+    normal_distribution<double> noise(0.0, 0.015);        // ToF 잡음 15mm
+    normal_distribution<double> jitter(0.0, 2e6);          // 수신 지터 2ms
+    uniform_real_distribution<double> u(0.0, 1.0);
+
+    vector<TofRecord> out;
+    const double approach = (2.0 - 0.55) / 0.6;
+    for (int64_t t = 0; t < 8000000000LL; t += 20000000LL) { // 50Hz
+        double ts = t * 1e-9;
+        double r, v;
+        if (ts < approach) { r = 2.0 - 0.6 * ts; v = -0.6; }
+        else if (ts < approach + 2.0) { r = 0.55; v = 0.0; }
+        else { r = 0.55 + 0.4 * (ts - approach - 2.0); v = 0.4; }
+
+        if (u(rng) < 0.03) continue;                       // 프레임 누락
+        double meas = r + noise(rng);
+        if (u(rng) < 0.02) meas = u(rng) < 0.5 ? 0.05 : 4.0; // 튀는 값 (반사/다중 경로)
+        int64_t rx = t + (int64_t)fabs(jitter(rng));
+        out.push_back({rx, (int)lround(meas * 1000), r, v});
+    }
+    return out;
+}
+
+struct CmdStats {
+    int ticks = 0, stop_ticks = 0, reversals = 0, max_delta = 0;
+    double sum_abs = 0, sum_sq = 0, first_stop_s = -1;
+    int last = -1, last_dir = 0;
+
+    void add(int cmd, double t_s) {
+        ticks++;
+        if (cmd == 0) {
+            stop_ticks++;
+            if (first_stop_s < 0) first_stop_s = t_s;
+        }
+        if (last >= 0) {
+            int d = cmd - last;
+            sum_abs += abs(d);
+            sum_sq += double(d) * d;
+            max_delta = max(max_delta, abs(d));
+            int dir = (d > 0) - (d < 0);
+            if (dir != 0) {
+                if (last_dir != 0 && dir != last_dir) reversals++;
+                last_dir = dir;
+            }
+        }
+        last = cmd;
+    }
+    void print(const char* name) const {
+        int n = max(1, ticks - 1);
+        printf("  %-10s |d|=%5.2f  rms(d)=%5.2f  max(d)=%3d  reversals=%4d  stop=%5.1f%%  first_stop=%.2fs\n",
+               name, sum_abs / n, sqrt(sum_sq / n), max_delta, reversals,
+               100.0 * stop_ticks / max(1, ticks), first_stop_s);
+    }
+};
+
+static void replay(const string& name, const vector<TofRecord>& rec) {
+    ACCController p_ctrl, gap_ctrl;
+    RangeTracker tracker;
+    CmdStats p_stats, gap_stats;
+    double raw_err2 = 0, est_err2 = 0, rate_err2 = 0;
+    int truth_n = 0;
+
+    const int64_t t0 = rec.front().rx_ns;
+    const int64_t t_end = rec.back().rx_ns;
+    size_t k = 0;
+    int last_mm = 5000;
+    for (int64_t now = t0; now <= t_end; now += TICK_NS) {
+        const TofRecord* newest = nullptr;
+        while (k < rec.size() && rec[k].rx_ns <= now) {
+            tracker.update(rec[k].rx_ns, rec[k].distance_mm / 1000.0);
+            newest = &rec[k];
+            last_mm = rec[k].distance_mm;
+            k++;
+        }
+        RangeEstimate est = tracker.estimate(now);
+        double t_s = (now - t0) * 1e-9;
+        p_stats.add(p_ctrl.computeBaseSpeed(last_mm / 1000.0), t_s);
+        gap_stats.add(gap_ctrl.computeGapSpeed(est, last_mm / 1000.0, TICK_NS * 1e-9), t_s);
+
+        if (newest && !std::isnan(newest->truth_m) && est.valid) {
+            raw_err2 += pow(newest->distance_mm / 1000.0 - newest->truth_m, 2);
+            est_err2 += pow(tracker.estimate(newest->rx_ns).range_m - newest->truth_m, 2);
+            rate_err2 += pow(est.rate_mps - newest->truth_rate, 2);
+            truth_n++;
+        }
+    }
+
+    printf("[%s] %zu samples, %.1fs, %d ticks\n", name.c_str(), rec.size(), (t_end - t0) * 1e-9, p_stats.ticks);
+    p_stats.print("P(dist)");
+    gap_stats.print("gap+KF");
+    printf("  tracker    updates=%u rejected=%u restarts=%u\n",
+           tracker.updates(), tracker.rejected(), tracker.restarts());
+    if (truth_n > 0) {
+        printf("  range rms err: raw %.1fmm -> filtered %.1fmm, rate rms err %.3fm/s\n",
+               1000 * sqrt(raw_err2 / truth_n), 1000 * sqrt(est_err2 / truth_n), sqrt(rate_err2 / truth_n));
+    }
+}
+
+// 1.5m에서 주행하다 0.1m 물체가 갑자기 나타남: 첫 근접 샘플을 받은 주기의 명령이 0이어야 함
+// (필터 추정만 보면 게이트가 max_rejects 샘플 동안 튀는 값으로 걸러 계속 주행)
+static bool step_check() {
+    ACCController ctrl;
+    RangeTracker tracker;
+    const int64_t sample_ns = 20000000LL;            // 50Hz
+    const int64_t step_ns = 3000000000LL;            // 3초 주행 후 계단
+    int cmd_before = 0, cmd_first_close = -1;
+    int64_t next_sample = 0;
+    double last_m = 1.5;
+    for (int64_t now = 0; now <= step_ns + 10 * sample_ns; now += TICK_NS) {
+        bool close_now = false;
+        while (next_sample <= now) {
+            last_m = (next_sample < step_ns) ? 1.5 : 0.1;
+            tracker.update(next_sample, last_m);
+            close_now = last_m < 1.0;
+            next_sample += sample_ns;
+        }
+        int cmd = ctrl.computeGapSpeed(tracker.estimate(now), last_m, TICK_NS * 1e-9);
+        if (!close_now && now < step_ns) cmd_before = cmd;
+        if (close_now && cmd_first_close < 0) cmd_first_close = cmd;
+    }
+    bool ok = cmd_before > 0 && cmd_first_close == 0;
+    printf("[%s] step 1.5m -> 0.1m: cmd before=%d, at first close sample=%d (tracker rejected=%u)\n",
+           ok ? "PASS" : "FAIL", cmd_before, cmd_first_close, tracker.rejected());
+    return ok;
+}
+
+static void bench_update(const vector<TofRecord>& rec) {
+    RangeTracker tracker;
+    const int repeat = 2000;
+    volatile double sink = 0;
+    auto t0 = chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        tracker.reset();
+        int64_t off = (int64_t)r * 100000000000LL;
+        for (const TofRecord& s : rec) tracker.update(s.rx_ns + off, s.distance_mm / 1000.0);
+        sink = sink + tracker.estimate(rec.back().rx_ns + off).range_m;
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / (repeat * rec.size());
+    printf("[TIME] RangeTracker::update %.1f ns/sample\n", ns);
+}
+
+int main(int argc, char** argv) {
+    bool ok = step_check();
+    if (argc < 2) {
+        vector<TofRecord> rec = synth_trace();
+        replay("synthetic", rec);
+        bench_update(rec);
+        return ok ? 0 : 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        vector<TofRecord> rec;
+        if (!load_csv(argv[i], rec)) {
+            cerr << "[ERR] No ToF samples in " << argv[i] << "\n";
+            return 1;
+        }
+        replay(argv[i], rec);
+        if (i == argc - 1) bench_update(rec);
+    }
+    return ok ? 0 : 1;
+}
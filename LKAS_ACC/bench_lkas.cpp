@@ -0,0 +1,184 @@
+/**
+ * @file bench_lkas.cpp
+ * @brief 녹화 프레임으로 LKAS 중심점 추정 방식(FULL / 행 샘플링 / 다운스케일 / 추적 창)을 비교합니다.
+ *
+ * - 모든 프레임을 320x240으로 맞춘 뒤 방식마다 별도의 VisionProcessor(headless)로 처리
+ * - FULL(전체 해상도) 결과 대비 LKASResult::error 편차, line_found 일치율,
+ *   평균 confidence, 프레임당 처리 시간(us)을 출력합니다.
+ * - 추적 방식이 같은 샘플링의 전체 탐색보다 차선을 더 잃은 프레임이 있으면 실패(종료 코드 1)합니다.
+ * - 시간 측정 전에 FULL 방식의 고속 커널(LaneKernel) 마스크/모멘트를 기존 OpenCV 경로와 비트 단위로
+ *   비교합니다. (컬러 게이트 / HSV 강제 / H 범위를 좁힌 HSV, 하나라도 다르면 종료 코드 1)
+ *   NEON / AVX2 / SSE2 빌드(-march 옵션)마다 실행해 확인합니다.
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o bench_lkas bench_lkas.cpp VisionProcessor.cpp LaneKernel.cpp -std=c++17 `pkg-config --cflags --libs opencv4`
+ *
+ * [실행 방법]
+ * ./bench_lkas <video.mp4 | 이미지 폴더> [반복 횟수]
+ * (예: ./bench_lkas ../PC/Detection.v2-v2.yolov8/valid/images 5)
+ * 폴더를 주면 폴더 안의 .jpg 파일을 이름 순서대로 사용합니다.
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <opencv2/opencv.hpp>
+
+#include "VisionProcessor.h"
+
+using namespace std;
+using namespace cv;
+
+struct Variant {
+    const char* name;
+    CentroidMode mode;
+    int factor;
+    bool track;
+    int base;   // 추적 방식: 같은 샘플링의 전체 탐색 방식 번호 (line_found 비교용), 아니면 -1
+};
+
+static bool load_frames(const string& src, vector<Mat>& frames) {
+    Mat img;
+    struct stat st;
+    if (stat(src.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        // 폴더: 안의 .jpg 파일
+        vector<string> files;
+        glob(src + "/*.jpg", files, false);
+        for (const auto& f : files) {
+            img = imread(f, IMREAD_COLOR);
+            if (img.empty()) continue;
+            resize(img, img, Size(320, 240));
+            frames.push_back(img.clone());
+        }
+    } else {
+        VideoCapture cap(src);
+        if (!cap.isOpened()) return false;
+        while (cap.read(img)) {
+            resize(img, img, Size(320, 240));
+            frames.push_back(img.clone());
+        }
+    }
+    return !frames.empty();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "usage: " << argv[0] << " <video | image_dir> [repeat]\n";
+        return 1;
+    }
+    int repeat = (argc >= 3) ? max(1, atoi(argv[2])) : 3;
+
+    vector<Mat> frames;
+    if (!load_frames(argv[1], frames)) {
+        cerr << "[ERR] No frames loaded from " << argv[1] << "\n";
+        return 1;
+    }
+    cout << "[INFO] " << frames.size() << " frames (320x240), repeat=" << repeat << "\n";
+
+    // 고속 커널 ↔ OpenCV 경로 (cvtColor + inRange + morphologyEx + moments) 비트 단위 비교
+    struct VerifyCase {
+        const char* name;
+        LaneThresholdMode mode;
+        int hmin, hmax;
+    };
+    const VerifyCase verify_cases[] = {
+        {"color-gate", LaneThresholdMode::AUTO, 0, 179},   // H 전체 → HSV 변환 없는 컬러 게이트
+        {"hsv",        LaneThresholdMode::HSV,  0, 179},   // 같은 임계값을 HSV 계산 경로로
+        {"hsv-hue",    LaneThresholdMode::AUTO, 0, 90},    // H 범위를 좁힘 → 색상까지 계산
+    };
+    int verify_fail = 0;
+    for (const VerifyCase& c : verify_cases) {
+        VisionProcessor vp;
+        vp.init_gui(true);
+        LaneThreshold th;
+        th.hmin = c.hmin;
+        th.hmax = c.hmax;
+        vp.setHsvThreshold(th);
+        vp.setThresholdMode(c.mode);
+        vp.setVerifyKernel(true);
+        for (auto& f : frames) vp.processFrame(f);
+        printf("[%s] kernel vs OpenCV (%s): %llu / %zu frames differ\n", vp.verifyMismatches() ? "FAIL" : "PASS",
+               c.name, (unsigned long long)vp.verifyMismatches(), frames.size());
+        if (vp.verifyMismatches()) verify_fail = 1;
+    }
+
+    const Variant variants[] = {
+        {"full",     CentroidMode::FULL,        1, false, -1},
+        {"row/2",    CentroidMode::ROW_SAMPLED, 2, false, -1},
+        {"row/4",    CentroidMode::ROW_SAMPLED, 4, false, -1},
+        {"down/2",   CentroidMode::DOWNSCALED,  2, false, -1},
+        {"down/4",   CentroidMode::DOWNSCALED,  4, false, -1},
+        {"track",    CentroidMode::FULL,        1, true,  0},
+        {"track+r2", CentroidMode::ROW_SAMPLED, 2, true,  1},
+    };
+    const int nv = sizeof(variants) / sizeof(variants[0]);
+
+    // 방식마다 결과 저장 (같은 프레임 순서 → EMA 상태도 같은 조건)
+    vector<vector<LKASResult>> results(nv);
+    vector<double> us_per_frame(nv, 0.0);
+
+    for (int v = 0; v < nv; v++) {
+        double best = 1e30;
+        for (int r = 0; r < repeat; r++) {
+            VisionProcessor vp;
+            vp.init_gui(true);
+            vp.setCentroidMode(variants[v].mode, variants[v].factor);
+            vp.setTracking(variants[v].track);
+            results[v].clear();
+            results[v].reserve(frames.size());
+
+            auto t0 = chrono::steady_clock::now();
+            for (auto& f : frames) {
+                results[v].push_back(vp.processFrame(f));
+            }
+            auto t1 = chrono::steady_clock::now();
+            double us = chrono::duration<double, micro>(t1 - t0).count() / frames.size();
+            best = min(best, us);
+        }
+        us_per_frame[v] = best;
+    }
+
+    printf("%-8s %9s %8s %11s %11s %10s %9s\n",
+           "mode", "us/frame", "speedup", "mean|dErr|", "max|dErr|", "found_agr", "mean_conf");
+    const vector<LKASResult>& ref = results[0];
+    for (int v = 0; v < nv; v++) {
+        double sum_d = 0.0, max_d = 0.0, sum_conf = 0.0;
+        int agree = 0, both = 0, found = 0;
+        for (size_t i = 0; i < frames.size(); i++) {
+            const LKASResult& a = ref[i];
+            const LKASResult& b = results[v][i];
+            if (a.line_found == b.line_found) agree++;
+            if (a.line_found && b.line_found) {
+                double d = fabs(a.error - b.error);
+                sum_d += d;
+                max_d = max(max_d, d);
+                both++;
+            }
+            if (b.line_found) { sum_conf += b.confidence; found++; }
+        }
+        printf("%-8s %9.1f %7.2fx %11.4f %11.4f %9.1f%% %9.3f\n",
+               variants[v].name, us_per_frame[v], us_per_frame[0] / us_per_frame[v],
+               both ? sum_d / both : 0.0, max_d,
+               100.0 * agree / frames.size(), found ? sum_conf / found : 0.0);
+    }
+
+    // 추적 창에서 놓친 프레임은 같은 프레임에서 전체 ROI로 다시 찾으므로, 추적 결과만 차선을 잃는 프레임은
+    // 없어야 함 (우회전 대기 중 line_found=false → HARD_RIGHT_TURN 오작동 방지)
+    int fail = 0;
+    for (int v = 0; v < nv; v++) {
+        if (variants[v].base < 0) continue;
+        int lost = 0;
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (!results[v][i].line_found && results[variants[v].base][i].line_found) lost++;
+        }
+        printf("[%s] %-8s line lost only by tracking: %d frames (vs %s)\n", lost ? "FAIL" : "PASS",
+               variants[v].name, lost, variants[variants[v].base].name);
+        if (lost) fail = 1;
+    }
+    return (fail || verify_fail) ? 1 : 0;
+}
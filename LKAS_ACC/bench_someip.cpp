@@ -0,0 +1,140 @@
+/**
+ * @file bench_someip.cpp
+ * @brief SomeipSender 전송 경로의 호출당 비용과 힙 할당 횟수를 측정합니다.
+ *
+ * - 루프백(127.0.0.1)의 수신 소켓으로 N번 전송하고 방식별로 평균 ns/전송, 전송당 할당 수를 출력합니다.
+ *   legacy   : 예전 구현 (매번 vector 생성 + memcpy + sendto, 비교 기준)
+ *   text     : sendMotor(string) (문자열은 미리 만들어 둠 → sendmsg iovec)
+ *   binary   : sendMotor(MotorCommand) (스택 직렬화 → sendmsg iovec)
+ *   batch x8 : sendBatch() 8개씩 sendmmsg (패킷당 비용으로 환산)
+ * - 할당 수는 전역 operator new를 바꿔 세므로 binary/text/batch는 0이어야 합니다.
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o bench_someip bench_someip.cpp SomeipSender.cpp -std=c++17
+ *
+ * [실행 방법]
+ * ./bench_someip [전송 횟수]
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "SomeipSender.h"
+
+using namespace std;
+
+// ===== 힙 할당 카운터 =====
+static atomic<uint64_t> g_allocs{0};
+
+void* operator new(size_t n) {
+    g_allocs.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// 예전 SomeipSender::sendMotor(string)와 같은 방식 (비교용)
+static bool legacy_send(int sock, const sockaddr_in& dst, uint32_t& session, const string& payload) {
+    vector<uint8_t> pkt(16 + payload.size());
+    auto be32 = [](uint8_t* p, uint32_t v){
+        p[0]=uint8_t(v>>24); p[1]=uint8_t(v>>16); p[2]=uint8_t(v>>8); p[3]=uint8_t(v);
+    };
+    be32(&pkt[0], 0x01000201u);
+    be32(&pkt[4], uint32_t(8 + payload.size()));
+    be32(&pkt[8], (0x1111u << 16) | (session++ & 0xFFFF));
+    pkt[12] = 1; pkt[13] = 1; pkt[14] = 0; pkt[15] = 0;
+    memcpy(&pkt[16], payload.data(), payload.size());
+    return ::sendto(sock, pkt.data(), pkt.size(), 0, (const sockaddr*)&dst, sizeof(dst)) >= 0;
+}
+
+// 수신 소켓 비우기 (버퍼가 차서 커널이 드롭하는 경로를 재지 않도록)
+static size_t drain(int sock) {
+    char buf[256];
+    size_t n = 0;
+    while (recv(sock, buf, sizeof(buf), MSG_DONTWAIT) > 0) n++;
+    return n;
+}
+
+struct Result {
+    double ns_per_send;
+    double allocs_per_send;
+    size_t received;
+};
+
+template <typename F>
+static Result run(int rx, int sends, int per_call, F&& fn) {
+    const int CHUNK = 256;   // 수신 버퍼가 넘치지 않게 CHUNK 전송마다 비움
+    drain(rx);
+    double ns = 0;
+    uint64_t allocs = 0;
+    size_t received = 0;
+    for (int done = 0; done < sends; ) {
+        int calls = min(CHUNK, sends - done) / per_call;
+        if (calls == 0) break;
+        uint64_t a0 = g_allocs.load(memory_order_relaxed);
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < calls; i++) fn();
+        auto t1 = chrono::steady_clock::now();
+        allocs += g_allocs.load(memory_order_relaxed) - a0;
+        ns += chrono::duration<double, nano>(t1 - t0).count();
+        done += calls * per_call;
+        received += drain(rx);
+    }
+    return { ns / sends, double(allocs) / sends, received };
+}
+
+int main(int argc, char** argv) {
+    int sends = (argc > 1) ? atoi(argv[1]) : 200000;
+    if (sends < SomeipSender::MAX_BATCH) sends = SomeipSender::MAX_BATCH;
+
+    // 수신 소켓 (임의 포트)
+    int rx = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    addr.sin_port = 0;
+    socklen_t alen = sizeof(addr);
+    if (rx < 0 || bind(rx, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+        getsockname(rx, (sockaddr*)&addr, &alen) < 0) {
+        perror("[ERR] rx socket");
+        return 1;
+    }
+    int port = ntohs(addr.sin_port);
+
+    SomeipSender tx;
+    if (!tx.open_to("127.0.0.1", "127.0.0.1", port)) return 1;
+    int legacy_sock = socket(AF_INET, SOCK_DGRAM, 0);
+    uint32_t legacy_session = 1;
+
+    MotorCommand cmd;
+    cmd.right_duty = 60; cmd.left_duty = 75;
+    const string text = "60;75;1;1";
+    MotorCommand batch[SomeipSender::MAX_BATCH];
+    for (auto& b : batch) b = cmd;
+
+    printf("[INFO] %d sends per variant -> 127.0.0.1:%d\n", sends, port);
+    printf("%-10s %12s %14s %10s\n", "variant", "ns/send", "allocs/send", "received");
+
+    auto show = [&](const char* name, const Result& r) {
+        printf("%-10s %12.0f %14.3f %10zu\n", name, r.ns_per_send, r.allocs_per_send, r.received);
+    };
+    show("legacy", run(rx, sends, 1, [&]{ legacy_send(legacy_sock, addr, legacy_session, text); }));
+    show("text",   run(rx, sends, 1, [&]{ tx.sendMotor(text); }));
+    show("binary", run(rx, sends, 1, [&]{ tx.sendMotor(cmd); }));
+    show("batch x8", run(rx, sends, SomeipSender::MAX_BATCH,
+                         [&]{ tx.sendBatch(batch, SomeipSender::MAX_BATCH); }));
+
+    close(legacy_sock);
+    close(rx);
+    return 0;
+}
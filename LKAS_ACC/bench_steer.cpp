@@ -0,0 +1,282 @@
+/**
+ * @file bench_steer.cpp
+ * @brief 3단계 조향(drive_mode -1/0/1 + build_motor)과 연속 PD 조향(SteeringController, --steer-pd)을 비교합니다.
+ *
+ * - 폐루프 시뮬레이션 (기본): 경기장형 트랙(직선 2m + 반지름 0.6m 반원)에서 차동 구동 차량을 주행
+ *   카메라 30fps / 캡처→판단 지연 60ms / 전방 0.25m 지점 오차 + 잡음 → VisionProcessor와 같은 EMA/데드밴드
+ *   → 제어 10ms, 전송 100ms(TX_PERIOD_MS) → 모터 1차 지연
+ *   랩 타임, 차선 중심 횡오차(RMS/최대), 차선 이탈 비율, 바퀴 듀티 변화량을 출력합니다.
+ * - 녹화 영상 재생 (인자로 영상/폴더): VisionProcessor 결과를 30fps로 두 방식에 넣어
+ *   명령 부드러움(듀티 변화량, 좌우 반전 횟수, 한쪽 바퀴 0 비율)을 비교합니다.
+ *   (영상 재생은 개루프라 랩 타임/횡오차는 시뮬레이션에서만 측정)
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o bench_steer bench_steer.cpp SteeringController.cpp VisionProcessor.cpp LaneKernel.cpp -std=c++17 `pkg-config --cflags --libs opencv4`
+ *
+ * [실행 방법]
+ * ./bench_steer [video.mp4 | 이미지 폴더] [base_speed]
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <deque>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <opencv2/opencv.hpp>
+
+#include "VisionProcessor.h"
+#include "SteeringController.h"
+
+using namespace std;
+using namespace cv;
+
+// main.cpp와 같은 값
+static const int TURN_DELTA = 16;
+static const double CTRL_DT = 0.010;
+static const int TX_DIV = 10;             // TX_PERIOD_MS / CTRL_TICK_MS
+static const double EMA_ALPHA = 0.30;     // VisionProcessor m_alpha
+static const double DEADBAND = 0.05;      // VisionProcessor m_deadband
+
+// 트랙 / 차량 모델
+static const double TRACK_L = 2.0;        // 직선 길이 (m)
+static const double TRACK_R = 0.6;        // 반원 반지름 (m)
+static const double LANE_HALF_M = 0.20;   // 카메라 화면 반폭에 해당하는 횡거리 (오차 ±1)
+static const double LOOKAHEAD_M = 0.25;
+static const double WHEEL_BASE_M = 0.16;
+static const double VMAX = 1.0;           // 듀티 100일 때 바퀴 속도 (m/s)
+static const double DUTY_DEADZONE = 20;   // 이보다 낮은 듀티는 바퀴가 돌지 않음
+static const double MOTOR_TAU = 0.08;
+static const double CAM_PERIOD = 1.0 / 30;
+static const double CAM_LATENCY = 0.060;
+static const double CAM_NOISE = 0.03;
+
+struct Drive { int right, left; };
+
+static Drive bang_bang(int drive_mode, int base) {
+    // build_motor (App_DriveLaw DriveLaw_Mix와 같은 식)
+    Drive d;
+    if (drive_mode == 0) d = {base, base};
+    else if (drive_mode < 0) d = {base + TURN_DELTA, 0};
+    else d = {0, base + TURN_DELTA};
+    d.right = max(0, min(100, d.right));
+    d.left = max(0, min(100, d.left));
+    return d;
+}
+
+struct CmdStats {
+    long n = 0, zero_wheel = 0, reversals = 0;
+    double sum_abs = 0;
+    Drive last{-1, -1};
+    int last_sign = 0;
+    void add(const Drive& d) {
+        n++;
+        if (d.right == 0 || d.left == 0) zero_wheel++;
+        if (last.right >= 0) sum_abs += abs(d.right - last.right) + abs(d.left - last.left);
+        int diff = d.left - d.right;
+        int sign = (diff > 0) - (diff < 0);
+        if (sign != 0) {
+            if (last_sign != 0 && sign != last_sign) reversals++;
+            last_sign = sign;
+        }
+        last = d;
+    }
+};
+
+// 경기장형 트랙 중심선에서 바깥쪽(+)으로의 부호 있는 거리
+static double outward_offset(double x, double y) {
+    if (fabs(x) <= TRACK_L / 2) return (y >= 0) ? y - TRACK_R : -TRACK_R - y;
+    double cx = (x > 0) ? TRACK_L / 2 : -TRACK_L / 2;
+    return hypot(x - cx, y) - TRACK_R;
+}
+
+struct SimResult {
+    vector<double> laps;
+    double rms_lat = 0, max_lat = 0, lost_pct = 0;
+    bool dnf = false;
+    CmdStats cmd;
+};
+
+/**
+ * @param pd false: 3단계 조향, true: SteeringController
+ */
+static SimResult simulate(bool pd, int base_speed, unsigned seed) {
+    mt19937 rng(seed);
+    normal_distribution<double> noise(0.0, CAM_NOISE);
+
+    // 반시계 방향 주행 (아래 직선 중앙에서 +x 방향으로 출발)
+    double x = 0, y = -TRACK_R, th = 0;
+    double vr = 0, vl = 0;
+    double t = 0, last_cross = 0;
+    bool armed = false;
+
+    double ema = 0;
+    int drive_mode = 0;
+    SteeringController steer;
+    struct Frame { double t_ready, error; bool found; int64_t t_ns; };
+    deque<Frame> pipeline;
+    double next_cam = 0;
+    Drive applied{0, 0};
+
+    SimResult res;
+    double sum_lat2 = 0;
+    long samples = 0, lost = 0;
+    const int LAPS = 3;
+    const double T_MAX = 60.0;
+
+    for (long tick = 0; t < T_MAX && (int)res.laps.size() < LAPS; tick++) {
+        // 카메라: 전방 LOOKAHEAD 지점에서 차선 중심이 오른쪽(+)으로 얼마나 떨어졌는지
+        if (t >= next_cam) {
+            next_cam += CAM_PERIOD;
+            double lx = x + LOOKAHEAD_M * cos(th), ly = y + LOOKAHEAD_M * sin(th);
+            double off = -outward_offset(lx, ly);           // 바깥쪽으로 벗어나면 차선은 왼쪽(-)
+            bool found = fabs(off) < LANE_HALF_M * 1.25;
+            double e = found ? max(-1.0, min(1.0, off / LANE_HALF_M + noise(rng))) : 0.0;
+            pipeline.push_back({t + CAM_LATENCY, e, found, (int64_t)(t * 1e9)});
+        }
+        // 비전 결과 도착 → VisionProcessor EMA/판단 → 제어 스레드
+        while (!pipeline.empty() && pipeline.front().t_ready <= t) {
+            Frame f = pipeline.front();
+            pipeline.pop_front();
+            ema = EMA_ALPHA * f.error + (1 - EMA_ALPHA) * ema;
+            if (f.found) drive_mode = (fabs(ema) >= DEADBAND) ? (ema > 0 ? 1 : -1) : 0;
+            steer.updateError(ema, f.t_ns, f.found);
+            if (!f.found) lost++;
+        }
+
+        SteerOutput so = steer.update(base_speed, CTRL_DT);
+        if (tick % TX_DIV == 0) {
+            applied = pd ? Drive{so.right_duty, so.left_duty} : bang_bang(drive_mode, base_speed);
+            res.cmd.add(applied);
+        }
+
+        // 모터 + 차동 구동 운동학
+        auto wheel = [](int duty) { return duty < DUTY_DEADZONE ? 0.0 : duty / 100.0 * VMAX; };
+        vr += (wheel(applied.right) - vr) * CTRL_DT / MOTOR_TAU;
+        vl += (wheel(applied.left) - vl) * CTRL_DT / MOTOR_TAU;
+        double v = 0.5 * (vr + vl);
+        double w = (vr - vl) / WHEEL_BASE_M;                 // 오른쪽 바퀴가 빠르면 좌회전(+)
+        x += v * cos(th) * CTRL_DT;
+        y += v * sin(th) * CTRL_DT;
+        th += w * CTRL_DT;
+        t += CTRL_DT;
+
+        double lat = outward_offset(x, y);
+        sum_lat2 += lat * lat;
+        res.max_lat = max(res.max_lat, fabs(lat));
+        samples++;
+
+        // 랩: 아래 직선 x = 0을 +x 방향으로 통과
+        if (y < 0 && fabs(y + TRACK_R) < 0.5) {
+            if (x < -0.2) armed = true;
+            if (armed && x >= 0) {
+                res.laps.push_back(t - last_cross);
+                last_cross = t;
+                armed = false;
+            }
+        }
+    }
+    res.dnf = (int)res.laps.size() < LAPS;
+    res.rms_lat = sqrt(sum_lat2 / max(1L, samples));
+    res.lost_pct = 100.0 * lost / max(1.0, t / CAM_PERIOD);
+    return res;
+}
+
+static void print_cmd(const char* name, const CmdStats& c) {
+    printf("  %-10s mean|dDuty|=%6.2f  L/R reversals=%4ld  one-wheel-stopped=%5.1f%%\n",
+           name, c.sum_abs / max(1L, c.n - 1), c.reversals, 100.0 * c.zero_wheel / max(1L, c.n));
+}
+
+static void run_sim(int base_speed) {
+    printf("[SIM] stadium %.1fm + R%.1fm, base=%d, 3 laps, mean of 5 seeds\n", TRACK_L, TRACK_R, base_speed);
+    for (int pd = 0; pd <= 1; pd++) {
+        double lap = 0, rms = 0, maxl = 0, lostp = 0;
+        int laps = 0, dnf = 0;
+        CmdStats cmd;
+        for (unsigned seed = 1; seed <= 5; seed++) {
+            SimResult r = simulate(pd, base_speed, seed);
+            for (double l : r.laps) { lap += l; laps++; }
+            rms += r.rms_lat / 5;
+            maxl = max(maxl, r.max_lat);
+            lostp += r.lost_pct / 5;
+            dnf += r.dnf;
+            cmd.n += r.cmd.n; cmd.sum_abs += r.cmd.sum_abs;
+            cmd.reversals += r.cmd.reversals; cmd.zero_wheel += r.cmd.zero_wheel;
+        }
+        const char* name = pd ? "PD" : "bang-bang";
+        printf("  %-10s lap=%6.2fs  lateral rms=%5.1fmm max=%5.1fmm  line lost=%4.1f%%  DNF=%d/5\n",
+               name, laps ? lap / laps : 0.0, rms * 1000, maxl * 1000, lostp, dnf);
+        print_cmd(name, cmd);
+    }
+}
+
+static bool load_frames(const string& src, vector<Mat>& frames) {
+    Mat img;
+    struct stat st;
+    if (stat(src.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        vector<string> files;
+        glob(src + "/*.jpg", files, false);
+        for (const auto& f : files) {
+            img = imread(f, IMREAD_COLOR);
+            if (img.empty()) continue;
+            resize(img, img, Size(320, 240));
+            frames.push_back(img.clone());
+        }
+    } else {
+        VideoCapture cap(src);
+        if (!cap.isOpened()) return false;
+        while (cap.read(img)) {
+            resize(img, img, Size(320, 240));
+            frames.push_back(img.clone());
+        }
+    }
+    return !frames.empty();
+}
+
+// 녹화 영상: 같은 LKAS 결과 열을 두 방식에 넣어 명령 부드러움만 비교 (개루프)
+static void run_footage(vector<Mat>& frames, int base_speed) {
+    VisionProcessor vp;
+    vp.init_gui(true);
+    vector<LKASResult> results;
+    results.reserve(frames.size());
+    for (auto& f : frames) results.push_back(vp.processFrame(f));
+
+    CmdStats bb, pd;
+    SteeringController steer(vp.steeringKp());
+    int drive_mode = 0;
+    size_t k = 0;
+    const double frames_per_tick = CTRL_DT / CAM_PERIOD;
+    for (long tick = 0; k < results.size(); tick++) {
+        size_t due = (size_t)(tick * frames_per_tick);
+        for (; k <= due && k < results.size(); k++) {
+            const LKASResult& r = results[k];
+            if (r.line_found) drive_mode = r.drive_mode;
+            steer.updateError(r.error, (int64_t)(k * CAM_PERIOD * 1e9), r.line_found);
+        }
+        SteerOutput so = steer.update(base_speed, CTRL_DT);
+        if (tick % TX_DIV == 0) {
+            bb.add(bang_bang(drive_mode, base_speed));
+            pd.add(Drive{so.right_duty, so.left_duty});
+        }
+    }
+    printf("[FOOTAGE] %zu frames @30fps, base=%d\n", frames.size(), base_speed);
+    print_cmd("bang-bang", bb);
+    print_cmd("PD", pd);
+}
+
+int main(int argc, char** argv) {
+    int base_speed = (argc >= 3) ? atoi(argv[2]) : 80;
+    if (argc >= 2) {
+        vector<Mat> frames;
+        if (!load_frames(argv[1], frames)) {
+            cerr << "[ERR] No frames loaded from " << argv[1] << "\n";
+            return 1;
+        }
+        run_footage(frames, base_speed);
+    }
+    run_sim(base_speed);
+    return 0;
+}
@@ -6,11 +6,20 @@
 #include <thread>
 #include <opencv2/opencv.hpp>
 #include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
 
 #include "SomeipSender.h"
 #include "VisionProcessor.h"
 #include "ACCController.h"
+#include "RangeTracker.h"
+#include "SteeringController.h"
 #include "TofCanReader.h" 
+#include "SpscRing.h"
+#include "LatencyStats.h"
+#include "V4l2Capture.h"
+#include "ControlScheduler.h"
 
 using namespace std;
 using namespace cv;
@@ -19,10 +28,23 @@ using namespace cv;
 static const char* PI_IP = "192.168.137.117";
 static const char* CTRL_IP = "192.168.2.30";
 static const int CTRL_PORT = 30509;
+static const int DISCOVER_TIMEOUT_MS = 2000; // --discover: OfferService 대기 시간 (없으면 CTRL_IP 사용)
 static const int CAM_INDEX = 0;
 static const int WIDTH = 320, HEIGHT = 240;
 static const int TX_PERIOD_MS = 100;
 static const int TURN_DELTA = 16;
+static const double STEER_KD = 0.1;          // --steer-pd 미분 게인 (비례 게인은 VisionProcessor::steeringKp)
+static const double STEER_DUTY_RATE = 400.0; // --steer-pd 바퀴 듀티 변화 한계 (듀티/s)
+
+// ===== 파이프라인 설정 =====
+static const int CTRL_TICK_MS = 10;       // 제어 스레드 상태 머신 주기 (= TC375 DRIVE_TASK_PERIOD_MS, TX는 TX_PERIOD_MS마다)
+static const size_t FRAME_RING_SIZE = 4;
+static const size_t LKAS_RING_SIZE = 4;
+static const int STATUS_PERIOD_MS = 100;  // [RUN] 상태 출력 주기
+static const int TOF_STALE_MS = 200;      // 이보다 오래된 ToF 거리는 쓰지 않음 (센서/CAN 끊김 → 정지)
+static const int LKAS_STALE_MS = 150;     // 이보다 오래된 차선 결과는 쓰지 않음 (카메라/비전 멈춤 → 정지, TC375 DRIVE_CMD_STALE_MS 300ms보다 짧게)
+static const int TOF_BATCH = 16;          // 제어 주기마다 RangeTracker에 넣을 새 ToF 샘플 최대 수
+static const int V4L2_QUEUE_DEPTH = 2;    // latest-frame-wins: 드라이버 버퍼 수 (큐 지연 최대 1프레임)
 
 // ===== 회피 및 회전 시간 =====
 static const auto AVOID_TIME1_TURN = chrono::milliseconds(700); 
@@ -40,15 +62,21 @@ static const int AVOID_BASE_SPEED = 90;
 static atomic<bool> g_running{true};
 static void on_sigint(int){ g_running.store(false); cerr << "\n[SYS] SIGINT\n"; }
 
-static string build_motor_cmd(int drive_mode, int base_speed) {
-    // (기존과 동일)
-    int Rspd=0, Lspd=0;
-    int Rdir=1, Ldir=1;
-    if (drive_mode == 0) { Rspd = base_speed; Lspd = base_speed; }
-    else if (drive_mode < 0) { Rspd = base_speed + TURN_DELTA; Lspd = 0; } // -1: 좌회전
-    else { Rspd = 0; Lspd = base_speed + TURN_DELTA; } // 1: 우회전
-    Rspd = max(0, min(100, Rspd)); Lspd = max(0, min(100, Lspd));
-    return to_string(Rspd)+";"+to_string(Lspd)+";"+to_string(Rdir)+";"+to_string(Ldir);
+static MotorCommand build_motor(int drive_mode, int base_speed) {
+    // 0: 직진, -1: 좌회전(오른쪽 바퀴만), 1: 우회전(왼쪽 바퀴만) - TC375와 공유하는 App_DriveLaw.h
+    int32_t Rspd = 0, Lspd = 0;
+    DriveLaw_Mix(drive_mode, base_speed, TURN_DELTA, &Rspd, &Lspd);
+    MotorCommand cmd;
+    cmd.right_duty = (int16_t)Rspd;
+    cmd.left_duty  = (int16_t)Lspd;
+    cmd.right_dir = 1; cmd.left_dir = 1;
+    return cmd;
+}
+
+// 텍스트 페이로드 "Rspd;Lspd;Rdir;Ldir" (--text-payload, 구 펌웨어 호환용)
+static string motor_text(const MotorCommand& cmd) {
+    return to_string(cmd.right_duty)+";"+to_string(cmd.left_duty)+";"
+         + to_string(cmd.right_dir)+";"+to_string(cmd.left_dir);
 }
 
 // ==========================================================
@@ -69,206 +97,559 @@ const char* STATE_NAMES[] = {
 // ==========================================================
 
 
+// ==========================================================
+// ===== 파이프라인 스테이지 간 전달 데이터 =====
+// ==========================================================
+using Clock = chrono::steady_clock;
+
+struct FramePacket {
+    Mat frame;                     // VideoCapture 경로 (BGR)
+    V4l2Frame v4l2;                // V4l2Capture 경로 (드라이버 버퍼 뷰, 비전에서 release)
+    uint32_t seq = 0;
+    Clock::time_point t_capture;   // cap.read() 완료 시각 / V4L2 드라이버 타임스탬프
+};
+
+struct LkasPacket {
+    LKASResult lkas;
+    uint32_t seq = 0;
+    Clock::time_point t_capture;   // 해당 프레임의 캡처 시각
+    Clock::time_point t_vision;    // processFrame() 완료 시각
+};
+
+static double ms_between(Clock::time_point a, Clock::time_point b) {
+    return chrono::duration<double, milli>(b - a).count();
+}
+
+// CanSample::rx_ns와 같은 시간축 (CLOCK_MONOTONIC)
+static int64_t monotonic_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+
 int main(int argc, char** argv) {
     signal(SIGINT, on_sigint);
-    bool headless = (argc > 1 && string(argv[1]) == "--headless");
+    bool headless = false;
+    bool verify_lkas = false;   // 고속 LKAS 커널을 OpenCV 경로와 매 프레임 비교
+    bool opencv_lkas = false;   // 기존 OpenCV 경로만 사용
+    CentroidMode centroid_mode = CentroidMode::FULL; // --row-sample N / --downscale N
+    int centroid_factor = 1;
+    double lookahead_weight = 0.0; // --lookahead W: 조향 판단에 밴드 피팅 미리 보기 오차 반영
+    bool track_lkas = false;    // --track: 이전 차선 위치 주변 창만 처리
+    string v4l2_device;         // --v4l2 DEV: V4l2Capture(mmap) 사용
+    string v4l2_file;           // --v4l2-file PATH: raw YUYV/NV12 파일을 가짜 장치로 재생
+    V4l2PixFmt v4l2_fmt = V4l2PixFmt::YUYV; // --nv12
+    bool v4l2_hsv = false;      // --v4l2-hsv: V4L2 프레임도 BGR 변환 후 HSV 경로로 처리
+    int v4l2_buffers = V4L2_QUEUE_DEPTH; // --v4l2-buffers N
+    int tx_period_ms = TX_PERIOD_MS;  // --tx-period MS (CTRL_TICK_MS의 배수로 맞춤, 최소 10ms)
+    int ctrl_rt_prio = 0;             // --rt-prio P: 제어 스레드 SCHED_FIFO 우선순위 (0 = 사용 안 함)
+    int ctrl_cpu = -1;                // --ctrl-cpu N: 제어 스레드 CPU 고정
+    bool text_payload = false;        // --text-payload: 모터 명령을 기존 텍스트 형식으로 전송
+    bool discover = false;            // --discover: CTRL_IP 대신 SOME/IP-SD로 TC375를 찾아 연결
+    int tof_stale_ms = TOF_STALE_MS;  // --tof-stale-ms MS (0 = 마지막 거리 계속 사용, 예전 동작)
+    bool acc_gap = false;             // --acc-gap: 칼만 거리 추정 + 헤드웨이 간격 제어 (기본: 거리 비례 제어)
+    string tof_log_path;              // --tof-log PATH: ToF 샘플(rx_ns,distance_mm) 기록 (bench_acc 재생용)
+    bool steer_pd = false;            // --steer-pd: 차선 주행 중 3단계 drive_mode 대신 연속 PD 조향
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--headless") headless = true;
+        else if (arg == "--verify-lkas") verify_lkas = true;
+        else if (arg == "--opencv-lkas") opencv_lkas = true;
+        else if (arg == "--row-sample" && i + 1 < argc) {
+            centroid_mode = CentroidMode::ROW_SAMPLED;
+            centroid_factor = atoi(argv[++i]);
+        }
+        else if (arg == "--downscale" && i + 1 < argc) {
+            centroid_mode = CentroidMode::DOWNSCALED;
+            centroid_factor = atoi(argv[++i]);
+        }
+        else if (arg == "--lookahead" && i + 1 < argc) lookahead_weight = atof(argv[++i]);
+        else if (arg == "--track") track_lkas = true;
+        else if (arg == "--v4l2" && i + 1 < argc) v4l2_device = argv[++i];
+        else if (arg == "--v4l2-file" && i + 1 < argc) v4l2_file = argv[++i];
+        else if (arg == "--nv12") v4l2_fmt = V4l2PixFmt::NV12;
+        else if (arg == "--v4l2-hsv") v4l2_hsv = true;
+        else if (arg == "--v4l2-buffers" && i + 1 < argc) v4l2_buffers = atoi(argv[++i]);
+        else if (arg == "--tx-period" && i + 1 < argc) tx_period_ms = atoi(argv[++i]);
+        else if (arg == "--rt-prio" && i + 1 < argc) ctrl_rt_prio = atoi(argv[++i]);
+        else if (arg == "--ctrl-cpu" && i + 1 < argc) ctrl_cpu = atoi(argv[++i]);
+        else if (arg == "--text-payload") text_payload = true;
+        else if (arg == "--discover") discover = true;
+        else if (arg == "--tof-stale-ms" && i + 1 < argc) tof_stale_ms = atoi(argv[++i]);
+        else if (arg == "--acc-gap") acc_gap = true;
+        else if (arg == "--tof-log" && i + 1 < argc) tof_log_path = argv[++i];
+        else if (arg == "--steer-pd") steer_pd = true;
+    }
     
     SomeipSender tx;
     VisionProcessor lkas_module;
     ACCController acc_module;
     VideoCapture cap;
+    V4l2Capture v4l2_cap;
+    const bool use_v4l2 = !v4l2_device.empty() || !v4l2_file.empty();
     TofCanReader tof_reader; 
 
     // ----- 초기화 (기존과 동일) -----
-    if (!tx.open_to(PI_IP, CTRL_IP, CTRL_PORT)) { cerr << "[ERR] SOME/IP fail\n"; return 1; }
+    // TC375는 응답을 항상 CTRL_PORT로 돌려보내므로 로컬 포트도 같게 (RTT/손실 측정용)
+    bool connected = false;
+    if (discover) {
+        // 모든 인터페이스에 바인딩 → FindService 브로드캐스트 → OfferService의 endpoint로 연결
+        if (tx.openDiscovery("0.0.0.0", CTRL_PORT)) connected = tx.findService(DISCOVER_TIMEOUT_MS);
+        if (!connected) cerr << "[WARN] TC375 OfferService 없음 → " << CTRL_IP << " 사용 (Offer 오면 재연결)\n";
+    }
+    if (!connected && !tx.open_to(discover ? "0.0.0.0" : PI_IP, CTRL_IP, CTRL_PORT, CTRL_PORT)) {
+        cerr << "[ERR] SOME/IP fail\n"; return 1;
+    }
     cout << "[INFO] SOME/IP Ready\n";
-    cap.open(CAM_INDEX, CAP_V4L2);
-    if (!cap.isOpened()) { cerr << "[ERR] Camera open FAILED!\n"; return 1; }
+    if (!v4l2_file.empty()) {
+        v4l2_cap.openFile(v4l2_file, WIDTH, HEIGHT, v4l2_fmt);
+    } else if (!v4l2_device.empty()) {
+        v4l2_cap.open(v4l2_device, WIDTH, HEIGHT, v4l2_fmt, v4l2_buffers);
+    } else {
+        cap.open(CAM_INDEX, CAP_V4L2);
+        cap.set(CAP_PROP_BUFFERSIZE, 1); // 드라이버 큐 지연 최소화 (지원하는 백엔드만 적용)
+    }
+    if (!(use_v4l2 ? v4l2_cap.isOpened() : cap.isOpened())) { cerr << "[ERR] Camera open FAILED!\n"; return 1; }
     cout << "[INFO] Camera opened successfully.\n";
     if (!tof_reader.open("can0")) { cerr << "[ERR] CAN fail\n"; return 1; }
+    if (!tof_reader.start()) { cerr << "[ERR] CAN rx thread fail\n"; return 1; }
+    FILE* tof_log = nullptr;
+    if (!tof_log_path.empty()) {
+        tof_log = fopen(tof_log_path.c_str(), "w");
+        if (!tof_log) { perror("[ERR] --tof-log"); return 1; }
+        fprintf(tof_log, "rx_ns,distance_mm\n");
+    }
     cout << "[INFO] CAN Ready\n";
     lkas_module.init_gui(headless);
+    lkas_module.setFastKernel(!opencv_lkas);
+    lkas_module.setVerifyKernel(verify_lkas);
+    lkas_module.setCentroidMode(centroid_mode, centroid_factor);
+    lkas_module.setLookaheadWeight(lookahead_weight);
+    lkas_module.setTracking(track_lkas);
     // -------------------------------
 
-    Mat frame, vis;
-    auto lastTxTime = chrono::steady_clock::now();
-    int last_drive_mode = 0;
-    int last_base_speed = 0;
-    int last_good_tof_mm = 5000;
-    int fail_count = 0;
-    
-    // ===== 2. 초기 상태 및 타이머/래치 지정 =====
-    VehicleState currentState = STATE_LANE_FOLLOWING;
-    LKASResult lkas; 
-    auto m_state_timer = chrono::steady_clock::now(); 
-    bool sign_turn_latch = false; 
-    
-    // ToF 장애물 감지용 변수
-    bool m_is_obstacle_close = false; 
-    auto m_obstacle_timer = chrono::steady_clock::now(); 
+    // ----- 스테이지 간 SPSC 링 -----
+    // 캡처 → 비전 : 최신 프레임만 처리 (오래된 프레임은 pop으로 비우며 V4L2 버퍼 반환)
+    // 비전 → 제어 : 최신 LKAS 결과만 소비 (pop_latest)
+    // CAN  → 제어 : TofCanReader 수신 스레드가 seqlock 스냅샷으로 게시 (이벤트는 누적 횟수)
+    SpscRing<FramePacket, FRAME_RING_SIZE> frame_ring;
+    SpscRing<LkasPacket, LKAS_RING_SIZE> lkas_ring;
 
-    // ★ 신규: 장애물 회피 1회 제한 플래그
-    bool has_avoided_obstacle = false;
+    atomic<uint32_t> dropped_frames{0};
+    atomic<uint32_t> skipped_frames{0};
+    atomic<uint32_t> drained_frames{0};   // 드라이버 큐에서 버린 오래된 프레임
 
-    cout << "[INFO] Starting Main Loop...\n";
+    cout << "[INFO] Starting Pipeline (capture / vision / sensor / control)...\n";
 
-    while (g_running.load()) {
-        // (A) 센서 읽기 (기존과 동일)
-        if (!cap.read(frame) || frame.empty()) {
-            fail_count++;
-            if (fail_count % 10 == 0) {
-                cerr << "[WARN] Camera frame EMPTY! (Retrying... " << fail_count << ")\r" << flush;
+    // ==========================================================
+    // ===== (A) 캡처 스레드: V4L2 read 전용 =====
+    // ==========================================================
+    thread capture_thread([&]() {
+        uint32_t seq = 0;
+        int fail_count = 0;
+        while (g_running.load()) {
+            FramePacket pkt;
+            int drained = 0;
+            bool ok = use_v4l2 ? v4l2_cap.grabLatest(pkt.v4l2, 100, &drained)
+                               : (cap.read(pkt.frame) && !pkt.frame.empty());
+            drained_frames += drained;
+            if (!ok) {
+                fail_count++;
+                if (fail_count % 10 == 0) {
+                    cerr << "[WARN] Camera frame EMPTY! (Retrying... " << fail_count << ")\r" << flush;
+                }
+                this_thread::sleep_for(chrono::milliseconds(10));
+                continue;
             }
-            this_thread::sleep_for(chrono::milliseconds(10));
-            continue; 
-        }
-        if (fail_count > 0) { cerr << "\n[INFO] Camera recovered!\n"; fail_count = 0; }
+            if (fail_count > 0) { cerr << "\n[INFO] Camera recovered!\n"; fail_count = 0; }
 
-        CanData can_data = tof_reader.readMessages();
-        if (can_data.distance_mm >= 0) {
-            last_good_tof_mm = can_data.distance_mm;
-        }
-        if (can_data.sign_turn_right) { 
-            sign_turn_latch = true;
-        }
-        double current_distance_m = last_good_tof_mm / 1000.0;
-        
-        auto now = chrono::steady_clock::now(); 
-        auto elapsed = now - m_state_timer;     
-
-        // (ToF 장애물 감지 로직 - 기존과 동일)
-        if (current_distance_m < OBSTACLE_THRESHOLD_M && current_distance_m > 0.0) {
-            if (!m_is_obstacle_close) {
-                m_is_obstacle_close = true;
-                m_obstacle_timer = now; 
+            // V4L2: 드라이버(커널) 캡처 타임스탬프 → 프레임 나이 = 실제 노출 이후 경과 시간
+            pkt.t_capture = use_v4l2 ? pkt.v4l2.timestamp : Clock::now();
+            pkt.seq = seq++;
+            if (!frame_ring.try_push(std::move(pkt))) {
+                dropped_frames++; // 비전이 밀려 링이 가득 참
+                if (use_v4l2) v4l2_cap.release(pkt.v4l2); // 실패 시 pkt는 그대로 → 버퍼 반환
             }
-        } else {
-            m_is_obstacle_close = false;
         }
+    });
 
+    // ==========================================================
+    // ===== (B) 센서 스레드: TofCanReader::start()에서 시작 (epoll, 프레임 도착 즉시 게시) =====
+    // ==========================================================
 
-        // ==========================================================
-        // ===== 3. 상태 머신(State Machine) =====
-        // ==========================================================
-        switch (currentState) {
-            
-            case STATE_LANE_FOLLOWING: {
-                last_base_speed = acc_module.computeBaseSpeed(current_distance_m);
-                lkas = lkas_module.processFrame(frame);
-                if (lkas.line_found) {
-                    last_drive_mode = lkas.drive_mode;
-                }
-                
-                // ★ 상태 전이 1: 장애물 (1회 제한 조건 추가)
-                auto obstacle_elapsed_time = now - m_obstacle_timer;
-                if (m_is_obstacle_close && obstacle_elapsed_time >= OBSTACLE_DETECT_DURATION && !has_avoided_obstacle) {
-                    cout << "\n[STATE] Obstacle (ToF) DETECTED! (First Time) -> AVOID_1_TURN_LEFT\n";
-                    currentState = STATE_AVOID_1_TURN_LEFT;
-                    m_state_timer = now;     
-                    m_is_obstacle_close = false; // 1회성 트리거
-                    has_avoided_obstacle = true; // ★ 1회 제한 플래그 사용
-                }
-                // 상태 전이 2: 우회전 표지판 (기존과 동일)
-                else if (sign_turn_latch) {
-                    cout << "\n[STATE] Turn Sign DETECTED! -> WAITING_FOR_TURN_OPENING\n";
-                    currentState = STATE_WAITING_FOR_TURN_OPENING;
-                    sign_turn_latch = false; 
-                }
-                break;
+    // ==========================================================
+    // ===== (C) 제어/전송 스레드: 고정 주기 상태 머신 + TX =====
+    // ==========================================================
+    LatencyStats lat_vision, lat_handover, lat_total;
+    LatencyStats lat_age(0.5, 400);   // 판단 시점의 프레임 나이 (히스토그램 출력)
+
+    // 절대 시각 기준 CTRL_TICK_MS 주기, TX는 tx_div 주기마다 (카메라 타이밍과 무관하게 정확한 간격)
+    ControlScheduler ctrl_sched((int64_t)CTRL_TICK_MS * 1000);
+    const uint64_t tx_div = (uint64_t)max(1, tx_period_ms / CTRL_TICK_MS);
+    cout << "[INFO] Control tick " << CTRL_TICK_MS << "ms, TX every " << tx_div * CTRL_TICK_MS << "ms\n";
+
+    thread control_thread([&]() {
+        ctrl_sched.configureThread(ctrl_rt_prio, ctrl_cpu);
+
+        int last_drive_mode = 0;
+        int last_base_speed = 0;
+        int last_good_tof_mm = 5000;
+
+        // ===== 2. 초기 상태 및 타이머/래치 지정 =====
+        VehicleState currentState = STATE_LANE_FOLLOWING;
+        LkasPacket lkas_pkt;
+        bool have_lkas = false;
+        bool age_recorded = false;      // lat_age는 결과마다 처음 판단에 쓰인 시점 한 번만 기록
+        const LKASResult& lkas = lkas_pkt.lkas;
+        auto m_state_timer = Clock::now();
+        bool sign_turn_latch = false;
+
+        // ToF 장애물 감지용 변수
+        bool m_is_obstacle_close = false;
+        auto m_obstacle_timer = Clock::now();
+
+        // ★ 신규: 장애물 회피 1회 제한 플래그
+        bool has_avoided_obstacle = false;
+
+        uint32_t seen_sign_count = 0;   // 처리한 우회전 표지판 이벤트 수
+        bool tof_stale = false;         // ToF 거리가 tof_stale_ms보다 오래됨
+        bool lkas_stale = true;         // 차선 결과가 없거나 LKAS_STALE_MS보다 오래됨 (첫 결과 전까지 정지)
+
+        // --acc-gap / --tof-log: 지난 주기 이후 새로 들어온 ToF 샘플을 순서대로 소비
+        RangeTracker range_tracker;
+        RangeEstimate range_est;
+        int64_t next_tof_index = 0;     // 다음에 소비할 CanSample::index
+        CanSample tof_batch[TOF_BATCH];
+
+        // --steer-pd: 비전 오차 → PD → 레이트 제한 차동 듀티 (차선 주행 상태에서만 사용)
+        SteeringController steering(lkas_module.steeringKp(), STEER_KD, TURN_DELTA, STEER_DUTY_RATE);
+        SteerOutput steer_out;
+
+        uint64_t next_tx_tick = 1;
+        uint64_t next_status_tick = 1;
+
+        ctrl_sched.start();
+        while (g_running.load()) {
+            uint64_t tick = ctrl_sched.waitNextTick();
+            auto now = Clock::now();
+            if (discover) tx.pollDiscovery(); // TC375 재부팅/IP 변경 Offer → 즉시 재연결
+            tx.pollResponses(); // TC375 응답(ack) 수신 → RTT/손실 집계
+
+            // (1) 센서 데이터: 최신 ToF 프레임과 그 나이 / 표지판 이벤트 (lock-free 조회)
+            CanSample tof_sample;
+            double tof_age_ms = 0.0;
+            bool have_tof = tof_reader.latest(TofCanReader::TOF_CAN_ID, tof_sample, &tof_age_ms);
+            if (have_tof) {
+                last_good_tof_mm = tof_sample.value;
+            }
+            bool stale_now = tof_stale_ms > 0 && (!have_tof || tof_age_ms > tof_stale_ms);
+            if (stale_now != tof_stale) {
+                tof_stale = stale_now;
+                if (tof_stale) cerr << "\n[WARN] ToF stale (" << (have_tof ? (int)tof_age_ms : -1) << "ms) -> STOP\n";
+                else cerr << "\n[INFO] ToF recovered\n";
             }
-            
-            // --- 장애물 회피 상태 (★ 버그 수정) ---
-            case STATE_AVOID_1_TURN_LEFT: {
-                last_base_speed = AVOID_BASE_SPEED;
-                last_drive_mode = 1; 
-                if (elapsed >= AVOID_TIME1_TURN) {
-                    cout << "\n[STATE] Avoid: Left Turn Done -> AVOID_2_STRAIGHT\n";
-                    currentState = STATE_AVOID_2_STRAIGHT;
-                    m_state_timer = now; 
+            TofSnapshot tof = tof_reader.snapshot();
+            if (tof.sign_right_count != seen_sign_count) {
+                seen_sign_count = tof.sign_right_count;
+                sign_turn_latch = true;
+            }
+            // 오래된 거리는 버리고 0m로 취급 → ACC 비상 정지 (장애물 회피는 거리 > 0일 때만이라 트리거 안 됨)
+            double current_distance_m = tof_stale ? 0.0 : last_good_tof_mm / 1000.0;
+
+            if (acc_gap || tof_log) {
+                if (have_tof && (int64_t)tof_sample.index >= next_tof_index) {
+                    // recent()는 최신 것부터 → 오래된 것부터 반영
+                    int n = tof_reader.recent(TofCanReader::TOF_CAN_ID, 1000, tof_batch, TOF_BATCH);
+                    for (int k = n - 1; k >= 0; k--) {
+                        if ((int64_t)tof_batch[k].index < next_tof_index) continue;
+                        range_tracker.update(tof_batch[k].rx_ns, tof_batch[k].value / 1000.0);
+                        if (tof_log) fprintf(tof_log, "%lld,%d\n", (long long)tof_batch[k].rx_ns, tof_batch[k].value);
+                    }
+                    next_tof_index = (int64_t)tof_sample.index + 1;
                 }
-                break;
+                if (tof_stale) range_tracker.reset();
+                range_est = range_tracker.estimate(monotonic_ns());
             }
-            case STATE_AVOID_2_STRAIGHT: {
-                last_base_speed = AVOID_BASE_SPEED; 
-                last_drive_mode = 0; // 직진
-                if (elapsed >= AVOID_TIME2_STRAIGHT) {
-                    cout << "\n[STATE] Avoid: Straight Done -> AVOID_3_TURN_RIGHT\n";
-                    currentState = STATE_AVOID_3_TURN_RIGHT;
-                    m_state_timer = now; 
+
+            // (2) 비전 결과: 가장 최신 것만 사용
+            LkasPacket fresh;
+            if (lkas_ring.pop_latest(fresh)) {
+                lkas_pkt = fresh;
+                have_lkas = true;
+                age_recorded = false;
+                if (steer_pd) {
+                    int64_t t_cap_ns = chrono::duration_cast<chrono::nanoseconds>(lkas_pkt.t_capture.time_since_epoch()).count();
+                    steering.updateError(lkas_pkt.lkas.error, t_cap_ns, lkas_pkt.lkas.line_found);
                 }
-                break;
+                lat_vision.add(ms_between(lkas_pkt.t_capture, lkas_pkt.t_vision));
+                lat_handover.add(ms_between(lkas_pkt.t_vision, now));
+            }
+            // 캡처 스레드는 카메라 실패 시 재시도만 하므로, 결과가 끊기면 여기서 정지 (마지막 명령을 계속 보내지 않음)
+            double lkas_age_ms = have_lkas ? ms_between(lkas_pkt.t_capture, now) : -1.0;
+            bool lkas_stale_now = !have_lkas || lkas_age_ms > LKAS_STALE_MS;
+            if (lkas_stale_now != lkas_stale) {
+                lkas_stale = lkas_stale_now;
+                if (lkas_stale) cerr << "\n[WARN] Vision stale (" << (int)lkas_age_ms << "ms) -> STOP\n";
+                else cerr << "\n[INFO] Vision recovered\n";
             }
-            case STATE_AVOID_3_TURN_RIGHT: {
-                last_base_speed = AVOID_BASE_SPEED; 
-                last_drive_mode = -1; 
-                if (elapsed >= AVOID_TIME1_TURN) {
-                    cout << "\n[STATE] Avoid: Right Turn Done -> LANE_FOLLOWING\n";
-                    currentState = STATE_LANE_FOLLOWING;
+            const bool lkas_ok = have_lkas && !lkas_stale;
+
+            auto elapsed = now - m_state_timer;
+
+            // (ToF 장애물 감지 로직 - 기존과 동일)
+            if (current_distance_m < OBSTACLE_THRESHOLD_M && current_distance_m > 0.0) {
+                if (!m_is_obstacle_close) {
+                    m_is_obstacle_close = true;
+                    m_obstacle_timer = now; 
                 }
-                break;
+            } else {
+                m_is_obstacle_close = false;
             }
 
-            // --- 우회전 상태 ---
-            case STATE_WAITING_FOR_TURN_OPENING: {
-                last_base_speed = acc_module.computeBaseSpeed(current_distance_m);
-                lkas = lkas_module.processFrame(frame);
-                if (lkas.line_found) {
-                    last_drive_mode = lkas.drive_mode;
+
+            // ==========================================================
+            // ===== 3. 상태 머신(State Machine) =====
+            // ==========================================================
+            switch (currentState) {
+                
+                case STATE_LANE_FOLLOWING: {
+                    last_base_speed = acc_gap ? acc_module.computeGapSpeed(range_est, current_distance_m, CTRL_TICK_MS / 1000.0)
+                                              : acc_module.computeBaseSpeedMm(tof_stale ? 0 : last_good_tof_mm);
+                    if (lkas_ok && lkas.line_found) {
+                        last_drive_mode = lkas.drive_mode;
+                        lkas_pkt.lkas.frame_age_ms = ms_between(lkas_pkt.t_capture, now);
+                        if (!age_recorded) { lat_age.add(lkas.frame_age_ms); age_recorded = true; }
+                    }
+                    
+                    // ★ 상태 전이 1: 장애물 (1회 제한 조건 추가)
+                    auto obstacle_elapsed_time = now - m_obstacle_timer;
+                    if (m_is_obstacle_close && obstacle_elapsed_time >= OBSTACLE_DETECT_DURATION && !has_avoided_obstacle) {
+                        cout << "\n[STATE] Obstacle (ToF) DETECTED! (First Time) -> AVOID_1_TURN_LEFT\n";
+                        currentState = STATE_AVOID_1_TURN_LEFT;
+                        m_state_timer = now;     
+                        m_is_obstacle_close = false; // 1회성 트리거
+                        has_avoided_obstacle = true; // ★ 1회 제한 플래그 사용
+                    }
+                    // 상태 전이 2: 우회전 표지판 (기존과 동일)
+                    else if (sign_turn_latch) {
+                        cout << "\n[STATE] Turn Sign DETECTED! -> WAITING_FOR_TURN_OPENING\n";
+                        currentState = STATE_WAITING_FOR_TURN_OPENING;
+                        sign_turn_latch = false; 
+                    }
+                    break;
+                }
+                
+                // --- 장애물 회피 상태 (★ 버그 수정) ---
+                case STATE_AVOID_1_TURN_LEFT: {
+                    last_base_speed = AVOID_BASE_SPEED;
+                    last_drive_mode = 1; 
+                    if (elapsed >= AVOID_TIME1_TURN) {
+                        cout << "\n[STATE] Avoid: Left Turn Done -> AVOID_2_STRAIGHT\n";
+                        currentState = STATE_AVOID_2_STRAIGHT;
+                        m_state_timer = now; 
+                    }
+                    break;
+                }
+                case STATE_AVOID_2_STRAIGHT: {
+                    last_base_speed = AVOID_BASE_SPEED; 
+                    last_drive_mode = 0; // 직진
+                    if (elapsed >= AVOID_TIME2_STRAIGHT) {
+                        cout << "\n[STATE] Avoid: Straight Done -> AVOID_3_TURN_RIGHT\n";
+                        currentState = STATE_AVOID_3_TURN_RIGHT;
+                        m_state_timer = now; 
+                    }
+                    break;
+                }
+                case STATE_AVOID_3_TURN_RIGHT: {
+                    last_base_speed = AVOID_BASE_SPEED; 
+                    last_drive_mode = -1; 
+                    if (elapsed >= AVOID_TIME1_TURN) {
+                        cout << "\n[STATE] Avoid: Right Turn Done -> LANE_FOLLOWING\n";
+                        currentState = STATE_LANE_FOLLOWING;
+                        acc_module.setCurrentCommand(AVOID_BASE_SPEED); // 간격 제어가 회피 속도에서 이어서 가감속
+                    }
+                    break;
                 }
 
-                // ★ 우선순위 1: 장애물 감지 (1회 제한 조건 추가)
-                auto obstacle_elapsed_time = now - m_obstacle_timer;
-                 if (m_is_obstacle_close && obstacle_elapsed_time >= OBSTACLE_DETECT_DURATION && !has_avoided_obstacle) {
-                     cout << "\n[STATE] Obstacle (while waiting)! -> AVOID_1_TURN_LEFT\n";
-                     currentState = STATE_AVOID_1_TURN_LEFT;
-                     m_state_timer = now;
-                     m_is_obstacle_close = false; 
-                     sign_turn_latch = false; // (우회전 대기 상태는 취소됨)
-                     has_avoided_obstacle = true; // ★ 1회 제한 플래그 사용
+                // --- 우회전 상태 ---
+                case STATE_WAITING_FOR_TURN_OPENING: {
+                    last_base_speed = acc_gap ? acc_module.computeGapSpeed(range_est, current_distance_m, CTRL_TICK_MS / 1000.0)
+                                              : acc_module.computeBaseSpeedMm(tof_stale ? 0 : last_good_tof_mm);
+                    if (lkas_ok && lkas.line_found) {
+                        last_drive_mode = lkas.drive_mode;
+                        lkas_pkt.lkas.frame_age_ms = ms_between(lkas_pkt.t_capture, now);
+                        if (!age_recorded) { lat_age.add(lkas.frame_age_ms); age_recorded = true; }
+                    }
+
+                    // ★ 우선순위 1: 장애물 감지 (1회 제한 조건 추가)
+                    auto obstacle_elapsed_time = now - m_obstacle_timer;
+                     if (m_is_obstacle_close && obstacle_elapsed_time >= OBSTACLE_DETECT_DURATION && !has_avoided_obstacle) {
+                         cout << "\n[STATE] Obstacle (while waiting)! -> AVOID_1_TURN_LEFT\n";
+                         currentState = STATE_AVOID_1_TURN_LEFT;
+                         m_state_timer = now;
+                         m_is_obstacle_close = false; 
+                         sign_turn_latch = false; // (우회전 대기 상태는 취소됨)
+                         has_avoided_obstacle = true; // ★ 1회 제한 플래그 사용
+                    }
+                    // 우선순위 2: 차선이 사라짐 (기존과 동일)
+                    else if (lkas_ok && !lkas.line_found) {
+                        cout << "\n[STATE] Turn Opening DETECTED! -> HARD_RIGHT_TURN\n";
+                        currentState = STATE_HARD_RIGHT_TURN;
+                        m_state_timer = now; 
+                    }
+                    break;
                 }
-                // 우선순위 2: 차선이 사라짐 (기존과 동일)
-                else if (!lkas.line_found) {
-                    cout << "\n[STATE] Turn Opening DETECTED! -> HARD_RIGHT_TURN\n";
-                    currentState = STATE_HARD_RIGHT_TURN;
-                    m_state_timer = now; 
+                
+                case STATE_HARD_RIGHT_TURN: {
+                    last_base_speed = AVOID_BASE_SPEED; 
+                    last_drive_mode = 1; // 우회전
+                    if (elapsed >= TURN_RIGHT_TIME) {
+                        cout << "\n[STATE] Hard Right Turn Done -> LANE_FOLLOWING\n";
+                        currentState = STATE_LANE_FOLLOWING;
+                        acc_module.setCurrentCommand(AVOID_BASE_SPEED); // 간격 제어가 회피 속도에서 이어서 가감속
+                    }
+                    break;
                 }
-                break;
             }
-            
-            case STATE_HARD_RIGHT_TURN: {
-                last_base_speed = AVOID_BASE_SPEED; 
-                last_drive_mode = 1; // 우회전
-                if (elapsed >= TURN_RIGHT_TIME) {
-                    cout << "\n[STATE] Hard Right Turn Done -> LANE_FOLLOWING\n";
-                    currentState = STATE_LANE_FOLLOWING;
+            // ==========================================================
+
+            // 차선 결과가 오래됨: 모든 상태에서 정지 명령 (회전 모드도 TURN_DELTA가 붙으므로 직진 0으로)
+            if (lkas_stale) {
+                last_base_speed = 0;
+                last_drive_mode = 0;
+                if (acc_gap) acc_module.setCurrentCommand(0); // 복귀 시 0에서 다시 가속
+            }
+
+            // 연속 조향은 차선 주행 상태에서만 (회피/강제 회전은 기존 3단계 명령 그대로)
+            bool lane_steer = steer_pd && !lkas_stale && (currentState == STATE_LANE_FOLLOWING ||
+                                                          currentState == STATE_WAITING_FOR_TURN_OPENING);
+            if (lane_steer) steer_out = steering.update(last_base_speed, CTRL_TICK_MS / 1000.0);
+            else if (steer_pd) steering.reset(); // 복귀 시 이전 듀티에서 레이트 제한하지 않도록
+
+            // (4) 전송: 프레임 타이밍과 무관하게 tx_div 주기마다 가장 최근 판단을 전송
+            if (tick >= next_tx_tick) {
+                MotorCommand cmd = build_motor(last_drive_mode, last_base_speed);
+                if (lane_steer) {
+                    cmd.right_duty = (int16_t)steer_out.right_duty;
+                    cmd.left_duty = (int16_t)steer_out.left_duty;
+                    cmd.steer_valid = true;
+                    cmd.steer = (int8_t)lround(steer_out.steer * 100.0);
+                }
+                if (text_payload) tx.sendMotor(motor_text(cmd));
+                else tx.sendMotor(cmd);
+                auto tx_done = Clock::now();
+                while (next_tx_tick <= tick) next_tx_tick += tx_div; // 건너뛴 주기는 따라잡지 않음
+
+                double total_ms = have_lkas ? ms_between(lkas_pkt.t_capture, tx_done) : 0.0;
+                if (have_lkas) lat_total.add(total_ms);
+
+                // 상태 출력은 STATUS_PERIOD_MS마다 (콘솔 출력이 TX 주기를 흔들지 않도록)
+                if (tick >= next_status_tick) {
+                    next_status_tick = tick + STATUS_PERIOD_MS / CTRL_TICK_MS;
+                    cout << "[RUN] State: " << STATE_NAMES[currentState] 
+                         << " Mode:" << last_drive_mode << " ACC:" << last_base_speed;
+                    if (lane_steer) cout << " Steer:" << (int)lround(steer_out.steer * 100.0) << "%";
+                    cout
+                         << " Dist:" << last_good_tof_mm << "mm" << (tof_stale ? "(stale)" : "")
+                         << (lkas_stale ? " Vision:stale" : "");
+                    if (acc_gap && range_est.valid) {
+                        cout << " Rate:" << (int)(range_est.rate_mps * 1000) << "mm/s"
+                             << " TTC:" << (range_est.ttc_s < 100.0 ? range_est.ttc_s : 99.9) << "s";
+                    }
+                    cout
+                         << " Frame#" << lkas_pkt.seq
+                         << " Lat(cap->tx):" << (int)total_ms << "ms"
+                         << " Age:" << (int)lkas.frame_age_ms << "ms"
+                         << " Drop:" << dropped_frames.load() << "/" << skipped_frames.load()
+                         << "/" << drained_frames.load()
+                         << " Miss:" << ctrl_sched.deadlineMisses()
+                         << " RTT(p99):" << tx.rtt().percentile(0.99) << "ms"
+                         << "\r" << flush;
                 }
-                break;
             }
+            ctrl_sched.endTick();
         }
-        // ==========================================================
-
-
-        // (C) 전송 (기존과 동일)
-        auto tx_now = chrono::steady_clock::now();
-        if (chrono::duration_cast<chrono::milliseconds>(tx_now - lastTxTime).count() >= TX_PERIOD_MS) {
-            string payload = build_motor_cmd(last_drive_mode, last_base_speed);
-            tx.sendMotor(payload);
-            lastTxTime = tx_now;
-            
-            cout << "[RUN] State: " << STATE_NAMES[currentState] 
-                 << " Mode:" << last_drive_mode << " ACC:" << last_base_speed 
-                 << " Dist:" << last_good_tof_mm << "mm\r" << flush;
+    });
+
+    // ==========================================================
+    // ===== (D) 비전 워커 (메인 스레드: HighGUI는 메인 스레드에서만) =====
+    // ==========================================================
+    Mat vis;
+    Mat v4l2_bgr; // V4L2 경로의 BGR 변환 버퍼 (재사용)
+    FramePacket pkt, next;
+    while (g_running.load()) {
+        // 최신 프레임만 처리: 오래된 프레임은 건너뛰되 드라이버 버퍼는 반드시 반환
+        bool have = false;
+        while (frame_ring.pop(next)) {
+            if (have) {
+                skipped_frames++;
+                if (use_v4l2) v4l2_cap.release(pkt.v4l2);
+            }
+            pkt = std::move(next);
+            have = true;
+        }
+        if (!have) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+            continue;
         }
 
-        // (D) 시각화 (기존 코드 로직과 100% 동일)
+        LkasPacket out;
+        if (use_v4l2 && !v4l2_hsv) {
+            // 드라이버 버퍼의 Y/UV를 그대로 임계값 처리 (복사/색 변환 없음)
+            const V4l2Frame& f = pkt.v4l2;
+            out.lkas = (f.format == V4l2PixFmt::NV12)
+                ? lkas_module.processFrameYUV(f.luma, f.chroma, LaneYuvLayout::NV12)
+                : lkas_module.processFrameYUV(f.image, Mat(), LaneYuvLayout::YUYV);
+            if (!headless) pkt.v4l2.toBGR(v4l2_bgr); // 시각화할 때만 변환
+            v4l2_cap.release(pkt.v4l2);
+            pkt.frame = v4l2_bgr;
+        } else {
+            if (use_v4l2) {
+                pkt.v4l2.toBGR(v4l2_bgr);
+                v4l2_cap.release(pkt.v4l2);
+                pkt.frame = v4l2_bgr;
+            }
+            out.lkas = lkas_module.processFrame(pkt.frame);
+        }
+        out.seq = pkt.seq;
+        out.t_capture = pkt.t_capture;
+        out.t_vision = Clock::now();
+        LKASResult shown = out.lkas;
+        // 가득 차면 이번 결과는 버려짐 (SPSC라 생산자가 오래된 항목을 꺼낼 수 없음).
+        // 제어 스레드가 10ms마다 pop_latest로 비우므로 가득 차는 것은 제어 스레드가 멈췄을 때뿐
+        lkas_ring.try_push(std::move(out));
+
+        // 시각화
         if (!headless) {
-            lkas_module.visualize(vis, lkas);
+            vis = pkt.frame;
+            lkas_module.visualize(vis, shown);
             imshow("view", vis);
-            if (waitKey(1) == 27) break;
+            if (waitKey(1) == 27) g_running.store(false);
         }
     }
 
-    tx.sendMotor("0;0;1;1");
+    capture_thread.join();
+    tof_reader.stop();
+    control_thread.join();
+
+    MotorCommand stop_cmd; // 0;0;1;1
+    if (text_payload) tx.sendMotor(motor_text(stop_cmd));
+    else tx.sendMotor(stop_cmd);
     cout << "\n[SYS] Stopped.\n";
+    lat_vision.print("cap->vision");
+    lat_handover.print("vision->ctrl");
+    lat_total.print("cap->tx");
+    lat_age.print("age@decision");
+    lat_age.printHistogram("age@decision", 5.0);
+    ctrl_sched.printStats("control");
+    ctrl_sched.wakeJitter().printHistogram("tick jitter", 0.1);
+    tx.pollResponses();
+    tx.printLinkStats("TC375");
+    tof_reader.printStats();
+    if (tof_log) fclose(tof_log);
+    cout << "[LAT] frames dropped(ring full)=" << dropped_frames.load()
+         << " skipped(stale)=" << skipped_frames.load()
+         << " drained(driver queue)=" << drained_frames.load() << "\n";
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,272 @@
+/**
+ * @file test_CanSignals.cpp
+ * @brief CanSignals.h 신호 테이블 단위 테스트 + vcan 수신 테스트 + 디코드 처리량 벤치마크
+ *
+ * - 단위 테스트 (CAN 장치 없이):
+ *   1. can_db 신호가 기존 손코딩 레이아웃(0x200 LE 거리, 0x300 클래스 + BE 너비)과 모든 값에서 같은지
+ *   2. 여러 시작 비트/길이/바이트 순서/부호 신호를 비트 단위 참조 구현(DBC 규칙)과 비교
+ *   3. 부호 확장, 배율(std::ratio) 반올림, 다른 신호 비트 보존
+ * - --vcan IFACE: 가상 CAN으로 0x200/0x300/관계없는 ID를 보내고 TofCanReader(필터, epoll 스레드,
+ *   스냅샷/이력)가 올바르게 받는지 확인
+ * - --bench N: 테이블 디코더와 손코딩 디코더의 프레임당 처리 시간 비교
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o test_CanSignals test_CanSignals.cpp TofCanReader.cpp -std=c++17 -pthread
+ *
+ * [vcan 준비]
+ * sudo modprobe vcan
+ * sudo ip link add dev vcan0 type vcan
+ * sudo ip link set up vcan0
+ *
+ * [실행 방법]
+ * ./test_CanSignals [--vcan vcan0] [--bench 10000000]
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <linux/can/raw.h>
+
+#include "CanSignals.h"
+#include "TofCanReader.h"
+
+using namespace std;
+
+static int g_failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { g_failures++; cerr << "[FAIL] " << msg << " (" #cond ")\n"; } \
+} while (0)
+
+// ===== 비트 단위 참조 구현 (DBC 규칙 그대로, 느리지만 명확) =====
+static void ref_set_bit(uint8_t* d, int b, int v) {
+    if (v) d[b / 8] |= uint8_t(1u << (b % 8));
+    else d[b / 8] &= uint8_t(~(1u << (b % 8)));
+}
+static int ref_get_bit(const uint8_t* d, int b) { return (d[b / 8] >> (b % 8)) & 1; }
+
+// Motorola: MSB(START)부터 바이트 안에서 아래로, 바이트 끝(비트 0)이면 다음 바이트의 비트 7로
+static int moto_next(int b) { return (b % 8 == 0) ? b + 15 : b - 1; }
+
+static uint64_t ref_raw(const uint8_t* d, int start, int len, ByteOrder order) {
+    uint64_t v = 0;
+    if (order == ByteOrder::Intel) {
+        for (int i = 0; i < len; i++) v |= uint64_t(ref_get_bit(d, start + i)) << i;
+    } else {
+        int b = start;
+        for (int i = len - 1; i >= 0; i--, b = moto_next(b)) v |= uint64_t(ref_get_bit(d, b)) << i;
+    }
+    return v;
+}
+
+static void ref_encode(uint8_t* d, int start, int len, ByteOrder order, uint64_t v) {
+    if (order == ByteOrder::Intel) {
+        for (int i = 0; i < len; i++) ref_set_bit(d, start + i, (v >> i) & 1);
+    } else {
+        int b = start;
+        for (int i = len - 1; i >= 0; i--, b = moto_next(b)) ref_set_bit(d, b, (v >> i) & 1);
+    }
+}
+
+template <typename Sig, int START>
+static void check_against_reference(mt19937_64& rng, const char* name) {
+    for (int it = 0; it < 20000; it++) {
+        uint8_t a[8], b[8];
+        uint64_t bg = rng();
+        memcpy(a, &bg, 8);
+        memcpy(b, &bg, 8);
+        uint64_t v = rng() & Sig::mask;
+
+        Sig::encodeRaw(a, (typename Sig::raw_type)v);
+        ref_encode(b, START, Sig::length, Sig::order, v);
+        if (memcmp(a, b, 8) != 0) {
+            CHECK(false, name << " encode != reference (v=" << v << ")");
+            return;
+        }
+        uint64_t got = uint64_t(Sig::raw(a)) & Sig::mask;
+        if (got != ref_raw(a, START, Sig::length, Sig::order)) {
+            CHECK(false, name << " decode != reference (v=" << v << ")");
+            return;
+        }
+    }
+}
+
+static void unit_tests() {
+    using namespace can_db;
+
+    // 1. 기존 손코딩 레이아웃과 비교 (모든 16비트 값)
+    for (uint32_t v = 0; v <= 0xFFFF; v++) {
+        uint8_t d[8] = {};
+        TofDistance::encodeRaw(d, v);
+        bool same = d[0] == (v & 0xFF) && d[1] == (v >> 8) && d[2] == 0;
+        int old_decode = d[0] | (d[1] << 8);   // TofCanReader의 기존 파싱
+        if (!same || TofDistance::raw(d) != v || old_decode != (int)v) {
+            CHECK(false, "TofDistance layout v=" << v);
+            break;
+        }
+
+        uint8_t e[8] = {};
+        DetectClass::encodeRaw(e, CLASS_SIGN_A);
+        DetectWidth::encodeRaw(e, v);
+        // Send_Detect2.cpp의 기존 인코딩: [0] 클래스, [1] 상위, [2] 하위
+        same = e[0] == CLASS_SIGN_A && e[1] == ((v >> 8) & 0xFF) && e[2] == (v & 0xFF) && e[3] == 0;
+        if (!same || DetectWidth::raw(e) != v || DetectClass::raw(e) != CLASS_SIGN_A) {
+            CHECK(false, "DetectMsg layout v=" << v);
+            break;
+        }
+    }
+    CHECK(TofDistance::min_dlc == 2, "TofDistance min_dlc");
+    CHECK(DetectClass::min_dlc == 1, "DetectClass min_dlc");
+    CHECK(DetectWidth::min_dlc == 3, "DetectWidth min_dlc");
+
+    // 2. 참조 구현과 비교 (바이트 경계에 걸친 신호, 64비트 신호 포함)
+    mt19937_64 rng(42);
+    check_against_reference<CanSignal<1, 0, 1, ByteOrder::Intel>, 0>(rng, "intel 0/1");
+    check_against_reference<CanSignal<1, 3, 11, ByteOrder::Intel>, 3>(rng, "intel 3/11");
+    check_against_reference<CanSignal<1, 13, 29, ByteOrder::Intel>, 13>(rng, "intel 13/29");
+    check_against_reference<CanSignal<1, 0, 64, ByteOrder::Intel>, 0>(rng, "intel 0/64");
+    check_against_reference<CanSignal<1, 7, 8, ByteOrder::Motorola>, 7>(rng, "moto 7/8");
+    check_against_reference<CanSignal<1, 4, 10, ByteOrder::Motorola>, 4>(rng, "moto 4/10");
+    check_against_reference<CanSignal<1, 23, 20, ByteOrder::Motorola>, 23>(rng, "moto 23/20");
+    check_against_reference<CanSignal<1, 7, 64, ByteOrder::Motorola>, 7>(rng, "moto 7/64");
+    check_against_reference<CanSignal<1, 61, 3, ByteOrder::Motorola, true>, 61>(rng, "moto 61/3 signed");
+
+    // 3. 부호 확장 / 배율 / 다른 비트 보존
+    using Temp = CanSignal<0x10, 8, 12, ByteOrder::Intel, true, std::ratio<1, 10>>;  // 0.1도 단위
+    uint8_t t[8];
+    memset(t, 0xA5, sizeof(t));
+    Temp::encode(t, -12.3);
+    CHECK(Temp::raw(t) == -123, "signed raw -123");
+    CHECK(Temp::decode(t) > -12.31 && Temp::decode(t) < -12.29, "scaled decode -12.3");
+    // 비트 8~19만 바뀌어야 함: [0] 그대로, [2] 상위 니블 그대로, [3..7] 그대로
+    CHECK(t[0] == 0xA5 && (t[2] & 0xF0) == 0xA0 && t[3] == 0xA5 && t[7] == 0xA5,
+          "neighbour bits preserved");
+    Temp::encode(t, 204.7);
+    CHECK(Temp::raw(t) == 2047, "signed max 2047");
+    Temp::encodeRaw(t, 2048);   // 12비트 범위 초과 → 잘려서 -2048
+    CHECK(Temp::raw(t) == -2048, "signed wrap -2048");
+
+    using Motor = CanSignal<0x11, 7, 16, ByteOrder::Motorola, true>;
+    uint8_t m[8] = {};
+    Motor::encodeRaw(m, -2);
+    CHECK(m[0] == 0xFF && m[1] == 0xFE && Motor::raw(m) == -2, "motorola signed -2");
+}
+
+// ===== vcan 수신 테스트 =====
+static int open_raw(const string& ifname) {
+    int s = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (s < 0) { perror("[ERR] socket"); return -1; }
+    ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname.c_str(), IFNAMSIZ - 1);
+    if (ioctl(s, SIOCGIFINDEX, &ifr) < 0) { perror("[ERR] SIOCGIFINDEX"); close(s); return -1; }
+    sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (bind(s, (sockaddr*)&addr, sizeof(addr)) < 0) { perror("[ERR] bind"); close(s); return -1; }
+    return s;
+}
+
+static void vcan_test(const string& ifname) {
+    using namespace can_db;
+    TofCanReader reader;
+    if (!reader.open(ifname) || !reader.start()) {
+        CHECK(false, "TofCanReader open/start on " << ifname);
+        return;
+    }
+    int tx = open_raw(ifname);
+    if (tx < 0) { CHECK(false, "tx socket"); return; }
+
+    const int N = 200;
+    can_frame f;
+    for (int i = 0; i < N; i++) {
+        TofMsg::init(f);
+        TofDistance::encodeRaw(f.data, 100 + i);
+        CHECK(write(tx, &f, sizeof(f)) == sizeof(f), "write tof");
+
+        can_frame other;                    // 필터로 걸러져야 하는 ID
+        memset(&other, 0, sizeof(other));
+        other.can_id = 0x123;
+        other.can_dlc = 8;
+        CHECK(write(tx, &other, sizeof(other)) == sizeof(other), "write other");
+    }
+    DetectMsg::init(f);
+    DetectClass::encodeRaw(f.data, CLASS_SIGN_A);
+    DetectWidth::encodeRaw(f.data, 123);
+    CHECK(write(tx, &f, sizeof(f)) == sizeof(f), "write sign");
+    DetectClass::encodeRaw(f.data, CLASS_BOX);
+    CHECK(write(tx, &f, sizeof(f)) == sizeof(f), "write box");
+
+    this_thread::sleep_for(chrono::milliseconds(100));
+    reader.stop();
+
+    TofSnapshot s = reader.snapshot();
+    CHECK(s.tof_count == (uint32_t)N, "tof_count " << s.tof_count);
+    CHECK(s.distance_mm == 100 + N - 1, "latest distance " << s.distance_mm);
+    CHECK(s.sign_right_count == 1 && s.obstacle_count == 1, "sign/obstacle counts");
+    CanSample last;
+    double age = -1;
+    CHECK(reader.latest(TofCanReader::TOF_CAN_ID, last, &age) && last.value == 100 + N - 1 && age >= 0,
+          "history latest");
+    reader.printStats();
+    close(tx);
+}
+
+// ===== 처리량 벤치마크 =====
+static void bench(long n) {
+    using namespace can_db;
+    vector<can_frame> frames(1024);
+    mt19937 rng(7);
+    for (auto& f : frames) {
+        DetectMsg::init(f);
+        DetectClass::encodeRaw(f.data, rng() % 4);
+        DetectWidth::encodeRaw(f.data, rng() & 0xFFFF);
+    }
+
+    auto run = [&](const char* name, auto&& fn) {
+        uint64_t sum = 0;
+        auto t0 = chrono::steady_clock::now();
+        for (long i = 0; i < n; i++) sum += fn(frames[i & 1023]);
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / n;
+        printf("%-12s %6.2f ns/frame  %8.1f Mframes/s  (checksum %llu)\n",
+               name, ns, 1e3 / ns, (unsigned long long)sum);
+    };
+    run("hand-coded", [](const can_frame& f) {
+        return uint64_t(f.data[0]) + ((f.data[1] << 8) | f.data[2]);
+    });
+    run("table", [](const can_frame& f) {
+        return uint64_t(DetectClass::raw(f.data)) + DetectWidth::raw(f.data);
+    });
+}
+
+int main(int argc, char** argv) {
+    string vcan;
+    long bench_n = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--vcan" && i + 1 < argc) vcan = argv[++i];
+        else if (arg == "--bench" && i + 1 < argc) bench_n = atol(argv[++i]);
+    }
+
+    unit_tests();
+    cout << (g_failures ? "[FAIL]" : "[PASS]") << " signal table unit tests\n";
+
+    if (!vcan.empty()) {
+        int before = g_failures;
+        vcan_test(vcan);
+        cout << (g_failures == before ? "[PASS]" : "[FAIL]") << " " << vcan << " receive test\n";
+    }
+    if (bench_n > 0) bench(bench_n);
+    return g_failures ? 1 : 0;
+}
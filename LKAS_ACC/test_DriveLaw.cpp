@@ -0,0 +1,129 @@
+/**
+ * @file test_DriveLaw.cpp
+ * @brief App_DriveLaw.h(고정소수점, TC375와 공유)를 double 기준 구현과 전수 비교합니다.
+ *
+ * - ACC: 거리 0~65535mm 전체에서 ACCController::computeBaseSpeed(double) vs computeBaseSpeedMm(정수)
+ *   → 차이는 1 이하, 그리고 double 값이 정수 경계(잘림 직전) 근처인 곳에서만 허용
+ * - DRIVELAW_ACC_DEFAULTS(TC375)와 ACCController 파라미터 변환값이 같은지
+ * - 차동 믹스: drive_mode -3~3, base -50~300, turn_delta 0~40 전체에서 기존 build_motor와 완전 일치
+ * - ClampI/MinI/MaxI: 범위 전체에서 std::clamp/min/max와 일치
+ * - 호출당 처리 시간 (double vs 고정소수점)
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o test_DriveLaw test_DriveLaw.cpp ACCController.cpp -std=c++17
+ * (C 컴파일 확인: gcc -std=c99 -Wall -Wextra -fsyntax-only -x c ../iLLD_TC375_ADS_FreeRTOS_Basic/App/App_DriveLaw.h)
+ *
+ * [실행 방법]
+ * ./test_DriveLaw
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "ACCController.h"
+
+using namespace std;
+
+static int g_failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { if (g_failures++ < 10) cerr << "[FAIL] " << msg << " (" #cond ")\n"; } \
+} while (0)
+
+// 잘리기 전 double 명령 값 (ACCController::computeBaseSpeed + scaleSpeedToCommand와 같은 식)
+static double ref_command_raw(double d_m) {
+    double target = 0.8 + 0.4 * (d_m - 1.2);
+    target = max(0.0, min(1.0, target));
+    return 40 + (target / 1.0) * 60;
+}
+
+static void test_acc() {
+    ACCController acc;
+    const DriveLawAccParams fw = DRIVELAW_ACC_DEFAULTS;
+    CHECK(memcmp(&fw, &acc.fixedParams(), sizeof(fw)) == 0, "DRIVELAW_ACC_DEFAULTS != ACCController params");
+
+    int exact = 0, off_by_one = 0;
+    for (int mm = 0; mm <= 65535; mm++) {
+        int ref = acc.computeBaseSpeed(mm / 1000.0);
+        int fx = acc.computeBaseSpeedMm(mm);
+        if (fx == ref) { exact++; continue; }
+        double raw = ref_command_raw(mm / 1000.0);
+        double frac = raw - floor(raw);
+        bool boundary = fx == ref - 1 && frac < 0.1;
+        CHECK(boundary, "ACC mm=" << mm << " ref=" << ref << " fx=" << fx << " raw=" << raw);
+        off_by_one++;
+    }
+    printf("[ACC] 0..65535mm: exact %d, off-by-one at step boundary %d\n", exact, off_by_one);
+
+    CHECK(acc.computeBaseSpeedMm(0) == 0 && acc.computeBaseSpeedMm(399) == 0, "stop distance");
+    CHECK(acc.computeBaseSpeedMm(400) == acc.computeBaseSpeed(0.4), "stop edge");
+    CHECK(acc.computeBaseSpeedMm(-5) == 0, "negative distance");
+}
+
+// 기존 main.cpp build_motor의 믹스
+static void ref_mix(int drive_mode, int base_speed, int turn_delta, int& r, int& l) {
+    int Rspd = 0, Lspd = 0;
+    if (drive_mode == 0) { Rspd = base_speed; Lspd = base_speed; }
+    else if (drive_mode < 0) { Rspd = base_speed + turn_delta; Lspd = 0; }
+    else { Rspd = 0; Lspd = base_speed + turn_delta; }
+    r = max(0, min(100, Rspd));
+    l = max(0, min(100, Lspd));
+}
+
+static void test_mix() {
+    long n = 0;
+    for (int mode = -3; mode <= 3; mode++)
+        for (int base = -50; base <= 300; base++)
+            for (int delta = 0; delta <= 40; delta++) {
+                int r, l;
+                int32_t fr, fl;
+                ref_mix(mode, base, delta, r, l);
+                DriveLaw_Mix(mode, base, delta, &fr, &fl);
+                CHECK(fr == r && fl == l, "mix mode=" << mode << " base=" << base << " delta=" << delta);
+                n++;
+            }
+    printf("[MIX] %ld combinations\n", n);
+}
+
+static void test_clamp() {
+    long n = 0;
+    for (int lo = -20; lo <= 20; lo += 5)
+        for (int hi = lo; hi <= 120; hi += 7)
+            for (int v = -1000; v <= 1000; v++) {
+                CHECK(DriveLaw_ClampI(v, lo, hi) == clamp(v, lo, hi), "clamp " << v << " " << lo << " " << hi);
+                CHECK(DriveLaw_MinI(v, hi) == min(v, hi) && DriveLaw_MaxI(v, lo) == max(v, lo), "min/max " << v);
+                n++;
+            }
+    printf("[CLAMP] %ld values\n", n);
+}
+
+static void bench() {
+    ACCController acc;
+    const int N = 20 * 65536;
+    volatile long sink = 0;
+    auto t0 = chrono::steady_clock::now();
+    long s = 0;
+    for (int i = 0; i < N; i++) s += acc.computeBaseSpeed((i & 0xFFFF) / 1000.0);
+    auto t1 = chrono::steady_clock::now();
+    long s2 = 0;
+    for (int i = 0; i < N; i++) s2 += acc.computeBaseSpeedMm(i & 0xFFFF);
+    auto t2 = chrono::steady_clock::now();
+    sink = s + s2;
+    (void)sink;
+    printf("[TIME] double %.2f ns/call, fixed %.2f ns/call\n",
+           chrono::duration<double, nano>(t1 - t0).count() / N,
+           chrono::duration<double, nano>(t2 - t1).count() / N);
+}
+
+int main() {
+    test_acc();
+    test_mix();
+    test_clamp();
+    bench();
+    cout << (g_failures ? "[FAIL] " : "[PASS] ") << g_failures << " failures\n";
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,249 @@
+/**
+ * @file test_someip.cpp
+ * @brief SomeipSender 응답(ack) 추적 / RTT / 손실 집계 확인용 테스트 프로그램
+ *
+ * - 기본: 같은 프로세스 안에 TC375 대역(stand-in)을 띄워 확인합니다.
+ *   (127.0.0.2:30509에서 요청을 받아 TC375 send_someip_response처럼 [14]=0x80으로 바꿔
+ *    보낸 쪽 IP의 30509 포트로 돌려보냄, drop% 확률로 응답 생략, 0~delay_ms 랜덤 지연,
+ *    delay_ms가 ack 제한 시간(50ms)보다 크면 일부는 late로 집계됨)
+ *   대역이 버린/보낸 수와 SomeipSender 집계(lost-late, acked+late)가 일치하는지 검사합니다.
+ * - --discover: IP를 주지 않고 SOME/IP-SD FindService → OfferService로 대역을 찾아 연결하고,
+ *   중간에 대역이 재부팅 Offer를 보냈을 때 pollDiscovery()가 받는지도 검사합니다.
+ *   (Offer는 TC375 SOMEIPSD_SendOfferService와 같은 바이트 배열)
+ * - --ecu IP --self IP: 실제 TC375로 보내 RTT/손실만 출력합니다. (모터 정지 명령 0;0;1;1 전송)
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o test_someip test_someip.cpp SomeipSender.cpp -std=c++17 -pthread
+ *
+ * [실행 방법]
+ * ./test_someip [전송 수] [drop%] [delay_ms] [--discover]
+ * ./test_someip 1000 --ecu 192.168.2.30 --self 192.168.2.10
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <deque>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <poll.h>
+
+#include "SomeipSender.h"
+
+using namespace std;
+
+static const int SOMEIP_PORT = 30509;
+static const int SD_PORT = 30490;
+static const int PERIOD_MS = 10;            // 제어 주기와 같게
+static const double ACK_TIMEOUT_MS = 50.0;
+
+// TC375 SOMEIP_Callback/send_someip_response 대역
+struct EcuStandIn {
+    int sock = -1;
+    int sd_sock = -1;
+    in_addr ip{};
+    atomic<bool> running{true};
+    atomic<bool> reboot_offer{false};   // true로 바꾸면 브로드캐스트 Offer 한 번 (재부팅 흉내)
+    atomic<uint64_t> received{0}, echoed{0}, dropped{0}, finds{0};
+
+    static int bind_udp(const char* ip, int port) {
+        int s = socket(AF_INET, SOCK_DGRAM, 0);
+        int on = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = inet_addr(ip);
+        a.sin_port = htons(port);
+        if (s < 0 || bind(s, (sockaddr*)&a, sizeof(a)) < 0) {
+            perror("[ERR] stand-in bind");
+            if (s >= 0) close(s);
+            return -1;
+        }
+        return s;
+    }
+
+    bool open(const char* addr) {
+        ip.s_addr = inet_addr(addr);
+        sock = bind_udp(addr, SOMEIP_PORT);
+        sd_sock = bind_udp(addr, SD_PORT);
+        return sock >= 0 && sd_sock >= 0;
+    }
+
+    // SOMEIPSD_SendOfferService와 같은 메시지
+    void send_offer(const sockaddr_in& to) {
+        uint8_t msg[] = {
+            0xFF, 0xFF, 0x81, 0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x01,
+            0x01, 0x01, 0x02, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10,
+            0x01, 0x00, 0x00, 0x10, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0A,
+            0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x09, 0x04, 0x00,
+            0xC0, 0xA8, 0x02, 0x14, 0x00, 0x11, 0x77, 0x2D
+        };
+        memcpy(&msg[48], &ip.s_addr, 4);
+        msg[54] = uint8_t(SOMEIP_PORT >> 8);
+        msg[55] = uint8_t(SOMEIP_PORT);
+        sendto(sd_sock, msg, sizeof(msg), 0, (const sockaddr*)&to, sizeof(to));
+    }
+
+    // SOMEIPSD_Recv_Callback: FindService(엔트리 type 0x00)에 요청자 IP:30490으로 Offer
+    void serve_sd(const sockaddr_in& client_sd) {
+        uint8_t buf[128];
+        for (;;) {
+            sockaddr_in from{};
+            socklen_t flen = sizeof(from);
+            ssize_t n = recvfrom(sd_sock, buf, sizeof(buf), MSG_DONTWAIT, (sockaddr*)&from, &flen);
+            if (n < 0) break;
+            if (n < 25 || buf[0] != 0xFF || buf[1] != 0xFF || buf[24] != 0x00) continue;
+            finds++;
+            from.sin_port = htons(SD_PORT);
+            send_offer(from);
+        }
+        if (reboot_offer.exchange(false)) send_offer(client_sd);
+    }
+
+    // 지연이 전송 주기보다 길어도 밀리지 않도록 응답마다 예정 시각을 두고 보냄
+    void run(int drop_pct, int delay_ms, const sockaddr_in& client_sd) {
+        struct Pending {
+            chrono::steady_clock::time_point due;
+            sockaddr_in to;
+            vector<uint8_t> pkt;
+        };
+        mt19937 rng(1234);
+        uniform_int_distribution<int> pct(0, 99), delay(0, max(0, delay_ms) * 1000);
+        deque<Pending> queue;
+        uint8_t buf[128];
+        while (running.load()) {
+            pollfd pfd[2] = { {sock, POLLIN, 0}, {sd_sock, POLLIN, 0} };
+            poll(pfd, 2, 1);
+            serve_sd(client_sd);
+            for (;;) {
+                sockaddr_in from{};
+                socklen_t flen = sizeof(from);
+                ssize_t n = recvfrom(sock, buf, sizeof(buf), MSG_DONTWAIT, (sockaddr*)&from, &flen);
+                if (n < 0) break;
+                if (n < 16) continue;
+                received++;
+                if (pct(rng) < drop_pct) { dropped++; continue; }
+                buf[14] = 0x80; // response
+                buf[15] = 0x00; // E_OK
+                from.sin_port = htons(SOMEIP_PORT); // TC375는 항상 PN_SERVICE_1로 응답
+                Pending p{chrono::steady_clock::now() + chrono::microseconds(delay(rng)), from,
+                          vector<uint8_t>(buf, buf + n)};
+                auto it = queue.begin();
+                while (it != queue.end() && it->due <= p.due) ++it;
+                queue.insert(it, std::move(p));
+            }
+            auto now = chrono::steady_clock::now();
+            while (!queue.empty() && queue.front().due <= now) {
+                Pending& p = queue.front();
+                sendto(sock, p.pkt.data(), p.pkt.size(), 0, (sockaddr*)&p.to, sizeof(p.to));
+                echoed++;
+                queue.pop_front();
+            }
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    int count = 500, drop_pct = 5, delay_ms = 2;
+    bool discover = false;
+    string ecu_ip, self_ip;
+    int pos = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--ecu" && i + 1 < argc) ecu_ip = argv[++i];
+        else if (arg == "--self" && i + 1 < argc) self_ip = argv[++i];
+        else if (arg == "--discover") discover = true;
+        else if (pos == 0) { count = atoi(argv[i]); pos++; }
+        else if (pos == 1) { drop_pct = atoi(argv[i]); pos++; }
+        else if (pos == 2) { delay_ms = atoi(argv[i]); pos++; }
+    }
+    bool local = ecu_ip.empty();
+
+    EcuStandIn ecu;
+    thread ecu_thread;
+    if (local) {
+        ecu_ip = "127.0.0.2";
+        self_ip = "127.0.0.1";
+        if (!ecu.open(ecu_ip.c_str())) return 1;
+        sockaddr_in client_sd{};   // 재부팅 Offer 대상 (SomeipSender SD 소켓)
+        client_sd.sin_family = AF_INET;
+        client_sd.sin_addr.s_addr = inet_addr(self_ip.c_str());
+        client_sd.sin_port = htons(SD_PORT);
+        ecu_thread = thread([&, client_sd]{ ecu.run(drop_pct, delay_ms, client_sd); });
+        cout << "[INFO] stand-in " << ecu_ip << ":" << SOMEIP_PORT
+             << " drop=" << drop_pct << "% delay=0~" << delay_ms << "ms\n";
+    } else if (self_ip.empty()) {
+        cerr << "[ERR] --ecu 사용 시 --self (RPi IP) 필요\n";
+        return 1;
+    }
+
+    SomeipSender tx;
+    double discover_ms = -1;
+    int reoffers = 0;
+    if (discover) {
+        // 로컬 대역은 브로드캐스트를 못 받으므로 FindService를 대역 IP로 유니캐스트
+        if (!tx.openDiscovery(self_ip.c_str(), SOMEIP_PORT, local ? ecu_ip.c_str() : "255.255.255.255"))
+            return 1;
+        auto t0 = chrono::steady_clock::now();
+        if (!tx.findService(2000)) {
+            cerr << "[ERR] OfferService 수신 실패\n";
+            if (local) { ecu.running.store(false); ecu_thread.join(); }
+            return 1;
+        }
+        discover_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cout << "[INFO] discovered in " << discover_ms << "ms\n";
+    } else if (!tx.open_to(self_ip.c_str(), ecu_ip.c_str(), SOMEIP_PORT, SOMEIP_PORT)) {
+        return 1;
+    }
+    tx.setAckTimeoutMs(ACK_TIMEOUT_MS);
+
+    MotorCommand stop_cmd; // 0;0;1;1 (실제 TC375에서도 안전)
+    auto next = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        if (discover) {
+            if (local && i == count / 2) ecu.reboot_offer.store(true);
+            if (tx.pollDiscovery()) reoffers++;
+        }
+        tx.pollResponses();
+        tx.sendMotor(stop_cmd);
+        next += chrono::milliseconds(PERIOD_MS);
+        this_thread::sleep_until(next);
+    }
+    // 마지막 요청들의 응답/시간 초과까지 대기
+    this_thread::sleep_for(chrono::milliseconds((int)ACK_TIMEOUT_MS * 2 + delay_ms));
+    tx.pollResponses();
+
+    if (local) {
+        ecu.running.store(false);
+        ecu_thread.join();
+        close(ecu.sock);
+        close(ecu.sd_sock);
+    }
+
+    tx.printLinkStats(local ? "stand-in" : "TC375");
+    tx.rtt().printHistogram("rtt", 5.0);
+
+    if (!local) return 0;
+
+    SomeipLinkStats st = tx.linkStats();
+    cout << "[INFO] stand-in received=" << ecu.received << " echoed=" << ecu.echoed
+         << " dropped=" << ecu.dropped << "\n";
+    bool ok = st.sent == (uint64_t)count && st.pending == 0 &&
+              ecu.received == (uint64_t)count &&
+              st.acked + st.late == ecu.echoed &&
+              st.lost - st.late == ecu.dropped;
+    cout << (ok ? "[PASS]" : "[FAIL]") << " ack/loss accounting matches stand-in\n";
+    if (discover) {
+        bool sd_ok = ecu.finds > 0 && reoffers == 1;
+        cout << (sd_ok ? "[PASS]" : "[FAIL]") << " discovery: finds=" << ecu.finds
+             << " reboot re-offers=" << reoffers << "\n";
+        ok = ok && sd_ok;
+    }
+    return ok ? 0 : 1;
+}
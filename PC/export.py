@@ -1,13 +1,82 @@
+import glob
+import sys
+
+import cv2
+import numpy as np
 from ultralytics import YOLO
 
 # 1. 1단계에서 테스트한 'best.pt' 모델 경로
 MODEL_PATH = 'runs/detect/train5/weights/best.pt'
+IMGSZ = 320
+
+# INT8 보정(calibration)에 쓸 이미지 (검증 세트)
+CALIB_IMAGES = 'Detection.v2-v2.yolov8/valid/images/*.jpg'
+CALIB_DATA = 'Detection.v2-v2.yolov8/data.yaml'
 
 # 모델 로드
 model = YOLO(MODEL_PATH)
 
 # 2. ONNX 포맷으로 변환 (imgsz는 학습 때와 동일하게)
-model.export(format='onnx', imgsz=320)
+onnx_path = model.export(format='onnx', imgsz=IMGSZ)
 
 print(f"--- ONNX 변환 완료! ---")
-print(f"{MODEL_PATH}와 같은 폴더에 'best.onnx' 파일이 생성되었습니다.")
\ No newline at end of file
+print(f"{MODEL_PATH}와 같은 폴더에 'best.onnx' 파일이 생성되었습니다.")
+
+
+# 3. INT8 정적 양자화 (ONNX Runtime, QDQ 형식 → Pi의 OpenCV DNN / ONNX Runtime 모두 로드 가능)
+#    입력은 Send_Detect2(YoloPreprocess)와 같게: 왼쪽 위 정렬 letterbox, RGB, 0~1, 1x3x320x320
+from onnxruntime.quantization import (CalibrationDataReader, CalibrationMethod, QuantFormat,
+                                      QuantType, quantize_static)
+from onnxruntime.quantization.shape_inference import quant_pre_process
+import onnx
+
+
+def preprocess(path):
+    img = cv2.imread(path)
+    h, w = img.shape[:2]
+    m = max(h, w)
+    square = np.zeros((m, m, 3), np.uint8)
+    square[:h, :w] = img
+    resized = cv2.resize(square, (IMGSZ, IMGSZ))
+    return cv2.dnn.blobFromImage(resized, 1 / 255., (IMGSZ, IMGSZ), swapRB=True, crop=False)
+
+
+class CalibReader(CalibrationDataReader):
+    def __init__(self, input_name, files):
+        self.input_name = input_name
+        self.files = iter(files)
+
+    def get_next(self):
+        path = next(self.files, None)
+        return None if path is None else {self.input_name: preprocess(path)}
+
+
+calib_files = sorted(glob.glob(CALIB_IMAGES))
+prep_path = onnx_path.replace('.onnx', '_prep.onnx')
+int8_path = onnx_path.replace('.onnx', '_int8.onnx')
+quant_pre_process(onnx_path, prep_path)
+
+# 검출 헤드(model.22)의 Conv 뒤 디코드 부분(DFL, 박스 변환, 점수 sigmoid, concat)은 float로 둡니다.
+# 박스 좌표(0~320)와 점수(0~1)가 한 텐서로 합쳐지므로 같이 양자화하면 점수 해상도가 무너집니다.
+graph = onnx.load(prep_path).graph
+head_nodes = [n.name for n in graph.node if '/model.22/' in n.name and n.op_type != 'Conv']
+input_name = graph.input[0].name
+
+quantize_static(prep_path, int8_path, CalibReader(input_name, calib_files),
+                quant_format=QuantFormat.QDQ,
+                activation_type=QuantType.QInt8, weight_type=QuantType.QInt8,
+                per_channel=True,
+                calibrate_method=CalibrationMethod.MinMax,
+                nodes_to_exclude=head_nodes)
+
+print(f"--- INT8 양자화 완료! (보정 이미지 {len(calib_files)}장) ---")
+print(f"'{int8_path}' 파일이 생성되었습니다.")
+
+
+# 4. (선택) TFLite INT8: python export.py --tflite
+#    ultralytics가 같은 검증 세트로 보정하며, '<이름>_saved_model/<이름>_int8.tflite'가 생성됩니다.
+if '--tflite' in sys.argv:
+    tflite_path = model.export(format='tflite', imgsz=IMGSZ, int8=True, data=CALIB_DATA)
+    print(f"--- TFLite INT8 변환 완료! '{tflite_path}' ---")
+
+print("Pi로 복사 후 비교: ./eval_detector --backend opencv best.onnx --backend opencv best_int8.onnx ...")
@@ -0,0 +1,295 @@
+#include "DetectorBackend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <opencv2/dnn.hpp>
+
+#if defined(DETECTOR_WITH_ONNXRUNTIME)
+#include <onnxruntime_cxx_api.h>
+#endif
+
+#if defined(DETECTOR_WITH_TFLITE)
+#include <tensorflow/lite/interpreter.h>
+#include <tensorflow/lite/kernels/register.h>
+#include <tensorflow/lite/model.h>
+#include <tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h>
+#endif
+
+// [1, C, A] 또는 [C, A] 출력을 DetectorOutput으로 복사
+static void copy_output(const float* src, int channels, int anchors, DetectorOutput& out) {
+    out.channels = channels;
+    out.anchors = anchors;
+    out.data.resize((size_t)channels * anchors);
+    std::memcpy(out.data.data(), src, out.data.size() * sizeof(float));
+}
+
+bool DetectorBackend::inferU8(const uint8_t*, int, int, DetectorOutput&) {
+    std::cerr << "[ERR] " << name() << ": uint8 입력을 지원하지 않음" << std::endl;
+    return false;
+}
+
+// ==========================================================
+// ===== OpenCV DNN =====
+// ==========================================================
+class OpenCvDnnBackend : public DetectorBackend {
+public:
+    bool load(const std::string& model_path, int num_threads) override {
+        try {
+            m_net = cv::dnn::readNet(model_path);
+        } catch (cv::Exception& e) {
+            std::cerr << "[ERR] opencv: 모델 로드 실패 " << model_path << ": " << e.what() << std::endl;
+            return false;
+        }
+        if (m_net.empty()) {
+            std::cerr << "[ERR] opencv: 빈 모델 " << model_path << std::endl;
+            return false;
+        }
+        m_net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        m_net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        if (num_threads > 0) cv::setNumThreads(num_threads);   // cv::dnn은 전역 스레드 풀 사용
+        m_outNames = m_net.getUnconnectedOutLayersNames();
+        return true;
+    }
+
+    bool infer(const float* input, int width, int height, DetectorOutput& out) override {
+        const int sz[4] = {1, 3, height, width};
+        cv::Mat blob(4, sz, CV_32F, const_cast<float*>(input));   // 복사 없이 감쌈
+        m_net.setInput(blob);
+        m_net.forward(m_outs, m_outNames);
+        const cv::Mat& o = m_outs[0];
+        if (o.dims != 3) {
+            std::cerr << "[ERR] opencv: 출력 차원 " << o.dims << " (기대: 1 x C x A)" << std::endl;
+            return false;
+        }
+        copy_output(o.ptr<float>(), o.size[1], o.size[2], out);
+        return true;
+    }
+
+    const char* name() const override { return "opencv"; }
+
+private:
+    cv::dnn::Net m_net;
+    std::vector<std::string> m_outNames;
+    std::vector<cv::Mat> m_outs;
+};
+
+// ==========================================================
+// ===== ONNX Runtime =====
+// ==========================================================
+#if defined(DETECTOR_WITH_ONNXRUNTIME)
+class OnnxRuntimeBackend : public DetectorBackend {
+public:
+    OnnxRuntimeBackend()
+        : m_env(ORT_LOGGING_LEVEL_WARNING, "detector"),
+          m_mem(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)) {}
+
+    bool load(const std::string& model_path, int num_threads) override {
+        try {
+            Ort::SessionOptions opt;
+            opt.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+            if (num_threads > 0) opt.SetIntraOpNumThreads(num_threads);
+            m_session.reset(new Ort::Session(m_env, model_path.c_str(), opt));
+            Ort::AllocatorWithDefaultOptions alloc;
+            m_inName = m_session->GetInputNameAllocated(0, alloc).get();
+            m_outName = m_session->GetOutputNameAllocated(0, alloc).get();
+        } catch (const Ort::Exception& e) {
+            std::cerr << "[ERR] ort: 모델 로드 실패 " << model_path << ": " << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool infer(const float* input, int width, int height, DetectorOutput& out) override {
+        const int64_t shape[4] = {1, 3, height, width};
+        const size_t count = (size_t)3 * width * height;
+        try {
+            Ort::Value in = Ort::Value::CreateTensor<float>(m_mem, const_cast<float*>(input), count, shape, 4);
+            const char* in_names[] = {m_inName.c_str()};
+            const char* out_names[] = {m_outName.c_str()};
+            auto outs = m_session->Run(Ort::RunOptions{nullptr}, in_names, &in, 1, out_names, 1);
+            auto info = outs[0].GetTensorTypeAndShapeInfo();
+            std::vector<int64_t> dims = info.GetShape();
+            if (dims.size() != 3) {
+                std::cerr << "[ERR] ort: 출력 차원 " << dims.size() << " (기대: 1 x C x A)" << std::endl;
+                return false;
+            }
+            copy_output(outs[0].GetTensorData<float>(), (int)dims[1], (int)dims[2], out);
+        } catch (const Ort::Exception& e) {
+            std::cerr << "[ERR] ort: 추론 실패: " << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    const char* name() const override { return "ort"; }
+
+private:
+    Ort::Env m_env;
+    Ort::MemoryInfo m_mem;
+    std::unique_ptr<Ort::Session> m_session;
+    std::string m_inName, m_outName;
+};
+#endif
+
+// ==========================================================
+// ===== TensorFlow Lite + XNNPACK =====
+// ==========================================================
+#if defined(DETECTOR_WITH_TFLITE)
+class TfliteBackend : public DetectorBackend {
+public:
+    ~TfliteBackend() override {
+        m_interp.reset();   // 델리게이트보다 먼저 해제
+        if (m_xnnpack) TfLiteXNNPackDelegateDelete(m_xnnpack);
+    }
+
+    bool load(const std::string& model_path, int num_threads) override {
+        m_model = tflite::FlatBufferModel::BuildFromFile(model_path.c_str());
+        if (!m_model) {
+            std::cerr << "[ERR] tflite: 모델 로드 실패 " << model_path << std::endl;
+            return false;
+        }
+        tflite::ops::builtin::BuiltinOpResolver resolver;
+        if (tflite::InterpreterBuilder(*m_model, resolver)(&m_interp) != kTfLiteOk || !m_interp) {
+            std::cerr << "[ERR] tflite: 인터프리터 생성 실패" << std::endl;
+            return false;
+        }
+        TfLiteXNNPackDelegateOptions xopt = TfLiteXNNPackDelegateOptionsDefault();
+        if (num_threads > 0) xopt.num_threads = num_threads;
+        m_xnnpack = TfLiteXNNPackDelegateCreate(&xopt);
+        if (m_interp->ModifyGraphWithDelegate(m_xnnpack) != kTfLiteOk)
+            std::cerr << "[WARN] tflite: XNNPACK 적용 실패, 기본 커널 사용" << std::endl;
+        if (num_threads > 0) m_interp->SetNumThreads(num_threads);
+        if (m_interp->AllocateTensors() != kTfLiteOk) {
+            std::cerr << "[ERR] tflite: 텐서 할당 실패" << std::endl;
+            return false;
+        }
+
+        // 정수 입력: 0~255 픽셀 → 양자화 값 LUT (float 경로의 lround(u/255 / scale) + zp와 같은 값)
+        const TfLiteTensor* in = m_interp->input_tensor(0);
+        m_u8Input = (in->type == kTfLiteInt8 || in->type == kTfLiteUInt8);
+        if (m_u8Input) {
+            const float inv = 1.0f / in->params.scale;
+            const int lo = (in->type == kTfLiteInt8) ? -128 : 0, hi = lo + 255;
+            for (int u = 0; u < 256; u++) {
+                int q = (int)std::lround(u * (1.0f / 255.0f) * inv) + in->params.zero_point;
+                m_inLut[u] = (uint8_t)std::min(hi, std::max(lo, q));
+            }
+        }
+        return true;
+    }
+
+    bool acceptsU8() const override { return m_u8Input; }
+
+    // 입력은 NHWC (float 또는 int8/uint8 양자화), 출력 [1, C, A]의 박스는 0~1 정규화 좌표
+    // (ultralytics TFLite 내보내기 형식) → 입력 픽셀 좌표로 되돌림
+    bool infer(const float* input, int width, int height, DetectorOutput& out) override {
+        TfLiteTensor* in = m_interp->input_tensor(0);
+        const int plane = width * height;
+        if (!checkInput(in, width, height)) return false;
+        if (in->type == kTfLiteFloat32) {
+            float* dst = in->data.f;
+            for (int i = 0; i < plane; i++)
+                for (int c = 0; c < 3; c++) dst[i * 3 + c] = input[c * plane + i];
+        } else if (in->type == kTfLiteInt8 || in->type == kTfLiteUInt8) {
+            const float inv = 1.0f / in->params.scale;
+            const int zp = in->params.zero_point;
+            const int lo = (in->type == kTfLiteInt8) ? -128 : 0, hi = lo + 255;
+            uint8_t* dst = (in->type == kTfLiteInt8) ? (uint8_t*)in->data.int8 : in->data.uint8;
+            for (int i = 0; i < plane; i++)
+                for (int c = 0; c < 3; c++) {
+                    int q = (int)std::lround(input[c * plane + i] * inv) + zp;
+                    dst[i * 3 + c] = (uint8_t)std::min(hi, std::max(lo, q));
+                }
+        } else {
+            std::cerr << "[ERR] tflite: 지원하지 않는 입력 형식 " << in->type << std::endl;
+            return false;
+        }
+        return invoke(width, height, out);
+    }
+
+    // 정수 입력 모델: uint8 CHW → LUT → NHWC (float 텐서와 요소별 곱셈/반올림 없음)
+    bool inferU8(const uint8_t* input, int width, int height, DetectorOutput& out) override {
+        TfLiteTensor* in = m_interp->input_tensor(0);
+        const int plane = width * height;
+        if (!m_u8Input) return DetectorBackend::inferU8(input, width, height, out);
+        if (!checkInput(in, width, height)) return false;
+        uint8_t* dst = (in->type == kTfLiteInt8) ? (uint8_t*)in->data.int8 : in->data.uint8;
+        for (int i = 0; i < plane; i++)
+            for (int c = 0; c < 3; c++) dst[i * 3 + c] = m_inLut[input[c * plane + i]];
+        return invoke(width, height, out);
+    }
+
+    const char* name() const override { return "tflite"; }
+
+private:
+    bool checkInput(const TfLiteTensor* in, int width, int height) const {
+        if (in->dims->size != 4 || in->dims->data[1] != height || in->dims->data[2] != width) {
+            std::cerr << "[ERR] tflite: 입력 크기가 " << width << "x" << height << "가 아님" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool invoke(int width, int height, DetectorOutput& out) {
+        if (m_interp->Invoke() != kTfLiteOk) {
+            std::cerr << "[ERR] tflite: 추론 실패" << std::endl;
+            return false;
+        }
+
+        const TfLiteTensor* o = m_interp->output_tensor(0);
+        if (o->dims->size != 3) {
+            std::cerr << "[ERR] tflite: 출력 차원 " << o->dims->size << " (기대: 1 x C x A)" << std::endl;
+            return false;
+        }
+        const int channels = o->dims->data[1], anchors = o->dims->data[2];
+        out.channels = channels;
+        out.anchors = anchors;
+        out.data.resize((size_t)channels * anchors);
+        const size_t n = out.data.size();
+        if (o->type == kTfLiteFloat32) {
+            std::memcpy(out.data.data(), o->data.f, n * sizeof(float));
+        } else if (o->type == kTfLiteInt8) {
+            for (size_t i = 0; i < n; i++) out.data[i] = (o->data.int8[i] - o->params.zero_point) * o->params.scale;
+        } else {
+            std::cerr << "[ERR] tflite: 지원하지 않는 출력 형식 " << o->type << std::endl;
+            return false;
+        }
+        const float scale[4] = {(float)width, (float)height, (float)width, (float)height};   // cx, cy, w, h
+        for (int c = 0; c < 4; c++) {
+            float* p = out.data.data() + (size_t)c * anchors;
+            for (int i = 0; i < anchors; i++) p[i] *= scale[c];
+        }
+        return true;
+    }
+
+    std::unique_ptr<tflite::FlatBufferModel> m_model;
+    std::unique_ptr<tflite::Interpreter> m_interp;
+    TfLiteDelegate* m_xnnpack = nullptr;
+    bool m_u8Input = false;
+    uint8_t m_inLut[256];
+};
+#endif
+
+std::unique_ptr<DetectorBackend> createDetectorBackend(const std::string& name) {
+    if (name == "opencv") return std::unique_ptr<DetectorBackend>(new OpenCvDnnBackend());
+#if defined(DETECTOR_WITH_ONNXRUNTIME)
+    if (name == "ort") return std::unique_ptr<DetectorBackend>(new OnnxRuntimeBackend());
+#endif
+#if defined(DETECTOR_WITH_TFLITE)
+    if (name == "tflite") return std::unique_ptr<DetectorBackend>(new TfliteBackend());
+#endif
+    return nullptr;
+}
+
+std::string availableDetectorBackends() {
+    std::string s = "opencv";
+#if defined(DETECTOR_WITH_ONNXRUNTIME)
+    s += " ort";
+#endif
+#if defined(DETECTOR_WITH_TFLITE)
+    s += " tflite";
+#endif
+    return s;
+}
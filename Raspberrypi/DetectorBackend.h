@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 추론 결과 (YOLOv8: [채널 = 4 + 클래스 수, anchor 수], 박스는 네트워크 입력 픽셀 좌표)
+ *
+ * 파이프라인에서 후처리가 이전 프레임 결과를 읽는 동안 다음 추론이 돌 수 있도록
+ * 백엔드 내부 버퍼가 아니라 슬롯마다 가진 이 버퍼로 복사합니다. (재할당 없음)
+ */
+struct DetectorOutput {
+    std::vector<float> data;
+    int channels = 0;
+    int anchors = 0;
+};
+
+/**
+ * @brief 검출기 추론 백엔드 (--backend로 시작 시 선택)
+ *
+ *  - "opencv": cv::dnn (FP32 / QDQ INT8 ONNX), 항상 사용 가능
+ *  - "ort"   : ONNX Runtime CPU (FP32 / QDQ INT8 ONNX), -DDETECTOR_WITH_ONNXRUNTIME 빌드에서만
+ *  - "tflite": TensorFlow Lite + XNNPACK (float / int8 .tflite), -DDETECTOR_WITH_TFLITE 빌드에서만
+ *
+ * 입력은 YoloPreprocess::run() 결과(1x3xHxW, RGB, 0~1)이며, NHWC가 필요한 백엔드는 내부에서 바꿉니다.
+ * 정수 입력 모델을 쓰는 백엔드는 acceptsU8()이 true이고, YoloPreprocess::runU8() 결과를 inferU8()로
+ * 받아 float 텐서 없이 LUT로 바로 양자화합니다. 실패는 false + std::cerr "[ERR]"로 알립니다.
+ */
+class DetectorBackend {
+public:
+    virtual ~DetectorBackend() = default;
+
+    /**
+     * @param model_path 모델 파일
+     * @param num_threads 추론 스레드 수 (0 = 백엔드 기본값)
+     */
+    virtual bool load(const std::string& model_path, int num_threads) = 0;
+
+    /**
+     * @param input 1x3xHxW float 텐서
+     * @param width 입력 폭 (W)
+     * @param height 입력 높이 (H)
+     * @param out 결과 (크기가 같으면 재할당 없음)
+     */
+    virtual bool infer(const float* input, int width, int height, DetectorOutput& out) = 0;
+
+    /**
+     * @brief 모델 입력이 정수(int8/uint8)라 uint8 텐서를 직접 받을 수 있는지 (load() 이후 유효)
+     */
+    virtual bool acceptsU8() const { return false; }
+
+    /**
+     * @param input 1x3xHxW uint8 텐서 (RGB, 0~255)
+     * @param width 입력 폭 (W)
+     * @param height 입력 높이 (H)
+     * @param out 결과 (크기가 같으면 재할당 없음)
+     */
+    virtual bool inferU8(const uint8_t* input, int width, int height, DetectorOutput& out);
+
+    virtual const char* name() const = 0;
+};
+
+/**
+ * @brief 이름으로 백엔드 생성 (이 빌드에 없는 백엔드면 nullptr)
+ */
+std::unique_ptr<DetectorBackend> createDetectorBackend(const std::string& name);
+
+/**
+ * @brief 이 빌드에서 쓸 수 있는 백엔드 이름 목록 (예: "opencv ort")
+ */
+std::string availableDetectorBackends();
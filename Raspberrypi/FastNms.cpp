@@ -0,0 +1,124 @@
+#include "FastNms.h"
+#include <algorithm>
+
+FastNms::FastNms(int capacity, int num_classes)
+    : m_capacity(capacity), m_numClasses(num_classes),
+      m_order(capacity), m_bucket(num_classes + 1), m_keep(capacity),
+      m_arena((size_t)capacity * 10), m_keptCount(0), m_dropped(0) {
+    float* a = m_arena.data();
+    m_x1 = a; a += capacity;
+    m_y1 = a; a += capacity;
+    m_x2 = a; a += capacity;
+    m_y2 = a; a += capacity;
+    m_area = a; a += capacity;
+    m_kx1 = a; a += capacity;
+    m_ky1 = a; a += capacity;
+    m_kx2 = a; a += capacity;
+    m_ky2 = a; a += capacity;
+    m_karea = a;
+}
+
+// n개 박스 중 (x1, y1, x2, y2, area)와 IoU > th인 것이 있는지
+// 분기 없이 끝까지 비교하므로 컴파일러가 벡터화합니다. (NEON / SSE)
+static inline bool any_overlap(const float* x1, const float* y1, const float* x2, const float* y2,
+                               const float* area, int n,
+                               float bx1, float by1, float bx2, float by2, float barea, float th) {
+    int hit = 0;
+    for (int i = 0; i < n; i++) {
+        float iw = std::min(x2[i], bx2) - std::max(x1[i], bx1);
+        float ih = std::min(y2[i], by2) - std::max(y1[i], by1);
+        float inter = (iw > 0.0f && ih > 0.0f) ? iw * ih : 0.0f;
+        float uni = area[i] + barea - inter;
+        // 면적 합이 0이면 NMSBoxes(jaccardDistance)처럼 완전히 겹친 것으로 봄
+        hit |= (inter > th * uni) | (area[i] + barea <= 0.0f);
+    }
+    return hit != 0;
+}
+
+// 후보를 클래스별 버킷으로 (계수 정렬: 버킷 안에서는 입력 순서 유지)
+int FastNms::bucketize(const YoloDetections& det, const NmsParams& params) {
+    const int n = std::min(det.count, m_capacity);
+    m_dropped = det.count - n;
+    const int nb = params.class_aware ? m_numClasses : 1;
+    std::fill(m_bucket.begin(), m_bucket.end(), 0);
+
+    auto bucket_of = [&](int k) -> int {
+        if (!(det.score[k] > params.score_threshold)) return -1;
+        if (!params.class_aware) return 0;
+        int c = det.class_id[k];
+        return (c >= 0 && c < m_numClasses) ? c : -1;
+    };
+    for (int k = 0; k < n; k++) {
+        int b = bucket_of(k);
+        if (b >= 0) m_bucket[b + 1]++;
+    }
+    for (int b = 0; b < nb; b++) m_bucket[b + 1] += m_bucket[b];
+    // m_bucket[b]를 쓰기 위치로 쓰고 나면 m_bucket[b]는 다음 버킷 시작이 되므로 한 칸씩 밀어 복원
+    for (int k = 0; k < n; k++) {
+        int b = bucket_of(k);
+        if (b >= 0) m_order[m_bucket[b]++] = k;
+    }
+    for (int b = nb; b > 0; b--) m_bucket[b] = m_bucket[b - 1];
+    m_bucket[0] = 0;
+    return nb;
+}
+
+// 버킷 하나: 점수 상위 top_k 정렬 → SoA 박스 → 탐욕(또는 Fast) 제거, 남은 후보를 m_keep[out..]에 씀
+int FastNms::suppressBucket(const YoloDetections& det, int begin, int end, const NmsParams& params, int out) {
+    int* ord = m_order.data();
+    const int m = end - begin;
+    const int k = (params.top_k > 0) ? std::min(params.top_k, m) : m;
+    const float* score = det.score.data();
+    std::partial_sort(ord + begin, ord + begin + k, ord + end, [score](int a, int b) {
+        return score[a] > score[b] || (score[a] == score[b] && a < b);
+    });
+
+    for (int j = 0; j < k; j++) {
+        int d = ord[begin + j];
+        float x = (float)det.left[d], y = (float)det.top[d];
+        float w = (float)det.width[d], h = (float)det.height[d];
+        m_x1[j] = x;
+        m_y1[j] = y;
+        m_x2[j] = x + w;
+        m_y2[j] = y + h;
+        m_area[j] = w * h;
+    }
+
+    const float th = params.iou_threshold;
+    int nk = 0;
+    for (int j = 0; j < k; j++) {
+        bool suppressed;
+        if (params.fast)   // 점수가 더 높은 모든 후보(제거된 것 포함)와 비교
+            suppressed = any_overlap(m_x1, m_y1, m_x2, m_y2, m_area, j,
+                                     m_x1[j], m_y1[j], m_x2[j], m_y2[j], m_area[j], th);
+        else               // 이미 남은 후보와만 비교 (NMSBoxes와 같은 탐욕)
+            suppressed = any_overlap(m_kx1, m_ky1, m_kx2, m_ky2, m_karea, nk,
+                                     m_x1[j], m_y1[j], m_x2[j], m_y2[j], m_area[j], th);
+        if (suppressed) continue;
+        m_kx1[nk] = m_x1[j];
+        m_ky1[nk] = m_y1[j];
+        m_kx2[nk] = m_x2[j];
+        m_ky2[nk] = m_y2[j];
+        m_karea[nk] = m_area[j];
+        nk++;
+        m_keep[out++] = ord[begin + j];
+    }
+    return out;
+}
+
+int FastNms::run(const YoloDetections& det, const NmsParams& params) {
+    const int nb = bucketize(det, params);
+    int out = 0;
+    for (int b = 0; b < nb; b++)
+        if (m_bucket[b + 1] > m_bucket[b]) out = suppressBucket(det, m_bucket[b], m_bucket[b + 1], params, out);
+    m_keptCount = out;
+
+    // 클래스별 결과를 합쳐 점수 내림차순으로 (남은 후보는 보통 몇 개뿐)
+    if (nb > 1) {
+        const float* score = det.score.data();
+        std::sort(m_keep.begin(), m_keep.begin() + out, [score](int a, int b) {
+            return score[a] > score[b] || (score[a] == score[b] && a < b);
+        });
+    }
+    return out;
+}
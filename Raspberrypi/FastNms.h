@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "YoloDecoder.h"
+
+/**
+ * @brief FastNms 설정
+ */
+struct NmsParams {
+    float score_threshold = 0.5f;   // 점수가 이 값보다 커야 후보 (NMSBoxes score_threshold)
+    float iou_threshold = 0.45f;    // 먼저 남은 박스와 IoU가 이 값보다 크면 제거
+    bool class_aware = true;        // false: 클래스 무시 (cv::dnn::NMSBoxes와 같은 동작)
+    bool fast = false;              // true: Fast NMS (점수가 더 높은 모든 후보와 비교, 제거된 후보도 제거에 참여)
+    int top_k = 100;                // 클래스(또는 전체)마다 비교에 넣을 최대 후보 수 (0: 제한 없음)
+};
+
+/**
+ * @brief 클래스별 NMS (YoloDetections 입력, 고정 용량 버퍼)
+ *
+ * cv::dnn::NMSBoxes(매 프레임 새 vector<Rect>/vector<float>, 클래스 구분 없는 탐욕 O(n²))를 대신합니다.
+ *  - 후보를 클래스별 버킷으로 나누고 (계수 정렬, anchor 순서 유지)
+ *  - 버킷마다 점수 상위 top_k개만 partial_sort (동점은 앞 후보 우선, NMSBoxes의 stable_sort와 같음)
+ *  - 박스는 x1/y1/x2/y2/면적 float 배열(SoA)로 모아 IoU를 계산합니다. (나눗셈 없이 inter > th * union)
+ *  - 모든 버퍼는 생성자에서 용량만큼 한 번 할당하고, 용량을 넘는 후보는 버리고 dropped()로 셉니다.
+ *
+ * 결과(kept())는 입력 YoloDetections 인덱스이며 점수 내림차순입니다. (NMSBoxes indices와 같은 의미)
+ * class_aware = false, top_k = 0이면 NMSBoxes와 같은 박스를 남깁니다.
+ * (IoU가 임계값과 float 반올림 차이 안쪽으로 같은 경우만 다를 수 있음)
+ */
+class FastNms {
+public:
+    /**
+     * @param capacity 한 번에 받을 최대 후보 수 (anchor 수 이상이면 버려지는 후보 없음)
+     * @param num_classes 클래스 수
+     */
+    explicit FastNms(int capacity = 8400, int num_classes = 3);
+
+    /**
+     * @brief NMS 실행
+     * @return 남은 후보 수
+     */
+    int run(const YoloDetections& det, const NmsParams& params);
+
+    const int* kept() const { return m_keep.data(); }
+    int keptCount() const { return m_keptCount; }
+
+    /**
+     * @brief 마지막 run()에서 용량을 넘어 버린 후보 수
+     */
+    int dropped() const { return m_dropped; }
+
+private:
+    int bucketize(const YoloDetections& det, const NmsParams& params);
+    int suppressBucket(const YoloDetections& det, int begin, int end, const NmsParams& params, int out);
+
+    int m_capacity, m_numClasses;
+    std::vector<int> m_order;           // 버킷별로 모은 후보 인덱스
+    std::vector<int> m_bucket;          // 버킷 시작 위치 (num_classes + 1)
+    std::vector<int> m_keep;            // 결과
+    std::vector<float> m_arena;         // x1, y1, x2, y2, area (정렬 순서) + 남은 박스 x1, y1, x2, y2, area
+    float* m_x1; float* m_y1; float* m_x2; float* m_y2; float* m_area;
+    float* m_kx1; float* m_ky1; float* m_kx2; float* m_ky2; float* m_karea;
+    int m_keptCount;
+    int m_dropped;
+};
@@ -2,6 +2,11 @@
 #include <opencv2/opencv.hpp>
 #include <opencv2/dnn.hpp>
 #include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <csignal>
 
 // --- [CAN 추가] ---
 #include <stdio.h>
@@ -13,6 +18,14 @@
 #include <sys/socket.h>
 #include <linux/can.h>
 #include <linux/can/raw.h>
+
+#include "../LKAS_ACC/CanSignals.h" // 0x300 레이아웃 (TofCanReader와 공유)
+#include "../LKAS_ACC/SpscRing.h"   // 스테이지 간 슬롯 번호 전달 (lock-free)
+#include "../LKAS_ACC/LatencyStats.h"
+#include "YoloPreprocess.h"             // letterbox + blob 변환 (한 번에)
+#include "YoloDecoder.h"                // 출력 텐서 → 후보 (SIMD 클래스 max, 조기 탈락)
+#include "FastNms.h"                    // 클래스별 NMS (고정 버퍼)
+#include "DetectorBackend.h"            // 추론 백엔드 (opencv / ort / tflite)
 // -----------------
 
 
@@ -26,14 +39,14 @@ const float NMS_THRESHOLD = 0.45;
 std::vector<std::string> class_names = {"Box", "Sign_A", "Sign_B"}; 
 
 // --- [CAN 추가] ---
-const uint32_t CAN_ID_OBSTACLE = 0x300;
-const uint8_t DATA_ID_BOX = 0x01;
-const uint8_t DATA_ID_SIGN_A = 0x02;
-const uint8_t DATA_ID_SIGN_B = 0x03;
+const uint32_t CAN_ID_OBSTACLE = can_db::DETECT_ID;
+const uint8_t DATA_ID_BOX = can_db::CLASS_BOX;
+const uint8_t DATA_ID_SIGN_A = can_db::CLASS_SIGN_A;
+const uint8_t DATA_ID_SIGN_B = can_db::CLASS_SIGN_B;
 // -----------------
 
 
-// (draw_label, format_yolo 함수는 이전과 동일)
+// (draw_label 함수는 이전과 동일)
 void draw_label(cv::Mat& input_image, std::string label, int left, int top) {
     int baseLine;
     cv::Size label_size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, &baseLine);
@@ -44,16 +57,6 @@ void draw_label(cv::Mat& input_image, std::string label, int left, int top) {
     cv::putText(input_image, label, cv::Point(left, top + label_size.height), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 255, 255), 1);
 }
 
-cv::Mat format_yolo(const cv::Mat &source) {
-    int col = source.cols;
-    int row = source.rows;
-    int _max = MAX(col, row);
-    cv::Mat result = cv::Mat::zeros(_max, _max, CV_8UC3);
-    source.copyTo(result(cv::Rect(0, 0, col, row)));
-    cv::resize(result, result, cv::Size(INPUT_WIDTH, INPUT_HEIGHT));
-    return result;
-}
-
 // (setup_can_socket 함수는 이전과 동일)
 int setup_can_socket() {
     int s; 
@@ -82,18 +85,14 @@ int setup_can_socket() {
 
 // --- [CAN 수정됨] ---
 // CAN 프레임 전송 함수 (클래스 ID 1바이트 + 너비 2바이트 = 총 3바이트 전송)
+// (레이아웃은 CanSignals.h의 can_db::DetectMsg: [0] 클래스, [1-2] 너비 big-endian)
 void send_can_frame(int s, uint32_t can_id, uint8_t class_data, int width_data) {
     struct can_frame frame;
+    can_db::DetectMsg::init(frame);
     frame.can_id = can_id;
-    frame.can_dlc = 3; // Data Length (3바이트)
-    
-    // 1. 클래스 ID (1바이트)
-    frame.data[0] = class_data;
-    
-    // 2. 너비 값 (int를 2바이트 uint16_t로 변환)
-    uint16_t width = (uint16_t)width_data;
-    frame.data[1] = (width >> 8) & 0xFF; // 상위 바이트 (High Byte)
-    frame.data[2] = width & 0xFF;        // 하위 바이트 (Low Byte)
+
+    can_db::DetectClass::encodeRaw(frame.data, class_data);
+    can_db::DetectWidth::encodeRaw(frame.data, (uint16_t)width_data);
 
     if (write(s, &frame, sizeof(struct can_frame)) != sizeof(struct can_frame)) {
         std::cerr << "오류: CAN 프레임 전송 실패" << std::endl;
@@ -102,133 +101,342 @@ void send_can_frame(int s, uint32_t can_id, uint8_t class_data, int width_data)
 // -----------------
 
 
-int main() {
-    // (카메라, 모델 로드, CAN 소켓 설정은 동일)
-    std::string pipeline = "libcamerasrc ! video/x-raw,width=640,height=480 ! videoconvert ! appsink";
-    cv::VideoCapture cap(pipeline, cv::CAP_GSTREAMER);
+
+
+// ==========================================================
+// ===== 파이프라인 (캡처+전처리 / 추론 / 후처리+CAN / 화면) =====
+// ==========================================================
+// 프레임 N을 추론하는 동안 N+1 캡처/전처리와 N-1 후처리/CAN 전송이 다른 스레드에서 돌아갑니다.
+// 슬롯(프레임, 입력 blob, 출력)은 미리 NUM_SLOTS개 만들어 두고 번호만 링으로 돌립니다.
+// (캡처 → infer_ring → 추론 → post_ring → 후처리 → free_ring → 캡처, 버퍼 재할당 없음)
+// 빈 슬롯이 없으면 캡처가 기다리고, appsink는 최신 1프레임만 유지하므로 오래된 프레임이 쌓이지 않습니다.
+using Clock = std::chrono::steady_clock;
+
+static const int NUM_SLOTS = 3;          // 캡처/추론/후처리가 하나씩 동시에 잡을 수 있는 수
+static const size_t RING_SIZE = 4;       // NUM_SLOTS보다 크게 (push 실패 없음)
+
+struct DetectSlot {
+    cv::Mat frame;                      // 카메라 원본 (후처리에서 그 위에 그림)
+    cv::Mat blob;                       // 네트워크 입력 1x3xHxW float (재사용)
+    std::vector<uint8_t> blob_u8;       // 정수 입력 백엔드용 1x3xHxW uint8 (acceptsU8일 때만)
+    DetectorOutput output;              // 네트워크 출력 (재사용)
+    uint32_t seq = 0;
+    Clock::time_point t_capture;        // cap.read() 완료
+    Clock::time_point t_pre;            // 전처리 완료
+    Clock::time_point t_infer_start;    // forward() 시작
+    Clock::time_point t_infer;          // forward() 완료
+};
+
+struct DisplayPacket {
+    cv::Mat vis;
+    double fps = 0.0;
+};
+
+static std::atomic<bool> g_running{true};
+static void on_sigint(int) { g_running.store(false); }
+
+static double ms_between(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// 전처리: letterbox + 리사이즈 + 1/255 + RGB + CHW를 슬롯 blob에 바로 (기존 format_yolo + blobFromImage와 같은 값)
+// 정수 입력 백엔드(u8)면 1/255 없이 uint8 텐서로 (양자화는 백엔드 LUT가)
+static void preprocess(YoloPreprocess& pre, DetectSlot& s, bool u8) {
+    if (u8) {
+        s.blob_u8.resize(pre.tensorSize());   // 처음 한 번만 할당
+        pre.runU8(s.frame.ptr<uint8_t>(), s.frame.step, s.frame.cols, s.frame.rows, s.blob_u8.data());
+        return;
+    }
+    const int sz[4] = {1, 3, pre.height(), pre.width()};
+    s.blob.create(4, sz, CV_32F);   // 처음 한 번만 할당
+    pre.run(s.frame.ptr<uint8_t>(), s.frame.step, s.frame.cols, s.frame.rows, s.blob.ptr<float>());
+}
+
+static bool infer_slot(DetectorBackend& backend, const YoloPreprocess& pre, DetectSlot& s, bool u8) {
+    return u8 ? backend.inferU8(s.blob_u8.data(), pre.width(), pre.height(), s.output)
+              : backend.infer(s.blob.ptr<float>(), pre.width(), pre.height(), s.output);
+}
+
+// 후처리 상태 (후처리 스레드 또는 --sequential 루프 하나만 사용, 버퍼 재사용)
+struct PostState {
+    YoloDecoder decoder{(int)class_names.size(), CONFIDENCE_THRESHOLD};
+    YoloDetections det;                 // 임계값 통과 후보 (SoA)
+    FastNms nms{8400, (int)class_names.size()};
+    NmsParams nms_params;               // 클래스별 탐욕 NMS (--nms-agnostic / --nms-fast로 변경)
+    FILE* dump = nullptr;               // --dump-candidates: NMS 전 후보 CSV (bench_nms 입력)
+};
+
+// 후처리: 출력 디코드 + NMS + 그리기 + CAN 전송
+static void postprocess(PostState& ps, DetectSlot& s, int can_socket) {
+    cv::Mat& frame = s.frame;
+
+    if (s.output.channels != 4 + (int)class_names.size()) {
+        static bool warned = false;
+        if (!warned) std::cerr << "[ERR] 모델 출력 채널 " << s.output.channels << " != 4 + 클래스 " << class_names.size() << std::endl;
+        warned = true;
+        return;
+    }
+    const int num_detections = s.output.anchors;
+    const float *data = s.output.data.data();
+
+    float max_dim = (float)MAX(frame.cols, frame.rows); // 640
+    float x_factor = max_dim / INPUT_WIDTH; // 640 / 320 = 2.0
+    float y_factor = max_dim / INPUT_HEIGHT; // 640 / 320 = 2.0
+
+    YoloDetections& det = ps.det;
+    ps.decoder.decode(data, num_detections, x_factor, y_factor, det);
+    if (ps.dump) {
+        for (int k = 0; k < det.count; k++)
+            fprintf(ps.dump, "%u,%d,%.9g,%d,%d,%d,%d\n", s.seq, det.class_id[k], det.score[k],
+                    det.left[k], det.top[k], det.width[k], det.height[k]);
+    }
+    const int kept = ps.nms.run(det, ps.nms_params);
+
+    // --- 결과 그리기 및 CAN 전송 ---
+    for (int n = 0; n < kept; n++) {
+        int idx = ps.nms.kept()[n];
+        int class_id = det.class_id[idx];
+        if (class_id >= (int)class_names.size()) continue;
+
+        std::string class_name = class_names[class_id];
+
+        uint8_t can_data_id = 0; // 보낼 CAN 데이터 ID (클래스)
+        if (class_name == "Box") {
+            can_data_id = DATA_ID_BOX;
+        } else if (class_name == "Sign_A") {
+            can_data_id = DATA_ID_SIGN_A;
+        } else if (class_name == "Sign_B") {
+            can_data_id = DATA_ID_SIGN_B;
+        }
+
+        if (can_data_id != 0) {
+            cv::Rect box(det.left[idx], det.top[idx], det.width[idx], det.height[idx]);
+
+            std::string label = cv::format("%.2f", det.score[idx]);
+            label = class_name + ": " + label;
+            cv::rectangle(frame, box, cv::Scalar(0, 255, 0), 2);
+            draw_label(frame, label, box.x, box.y);
+
+            std::cout << "탐지됨: " << class_name
+                      << ", X간격(너비): " << box.width << " 픽셀" << std::endl;
+
+            if (can_socket >= 0) send_can_frame(can_socket, CAN_ID_OBSTACLE, can_data_id, box.width);
+        }
+    }
+}
+
+struct StageStats {
+    LatencyStats read{0.1, 2000};       // cap.read()
+    LatencyStats pre{0.1, 2000};        // YoloPreprocess
+    LatencyStats infer_wait{0.1, 2000}; // 전처리 완료 → forward 시작 (큐 대기)
+    LatencyStats infer{0.1, 5000};      // forward()
+    LatencyStats post{0.1, 2000};       // 디코드 + NMS + CAN
+    LatencyStats total{0.5, 2000};      // cap.read() 완료 → CAN 전송 완료
+};
+
+// 실행: ./Send_Detect2 [--headless] [--sequential] [--no-can] [--frames N] [--cv-threads N] [--video PATH]
+//                      [--nms-agnostic] [--nms-fast] [--dump-candidates PATH]
+//                      [--backend opencv|ort|tflite] [--model PATH] [--infer-threads N]
+// INT8 모델: PC/export.py가 만드는 best_int8.onnx(opencv, ort) / best_int8.tflite(tflite)
+// 처리량 비교(4코어 Pi): 같은 영상으로 --sequential 과 기본(파이프라인) 실행 후 종료 시 fps/스테이지 지연 비교
+//   ./Send_Detect2 --video test.mp4 --headless --no-can --frames 300 --sequential
+//   ./Send_Detect2 --video test.mp4 --headless --no-can --frames 300
+int main(int argc, char** argv) {
+    bool headless = false;
+    bool sequential = false;   // --sequential: 기존처럼 한 스레드에서 순서대로 (비교용)
+    bool use_can = true;       // --no-can: CAN 없이 (벤치마크용)
+    int max_frames = 0;        // --frames N: N프레임 처리 후 종료 (0 = 무한)
+    int cv_threads = -1;       // --cv-threads N: OpenCV 내부 스레드 수 (-1 = 기본값)
+    std::string video_path;    // --video PATH: 카메라 대신 영상 파일 (재현 가능한 측정용)
+    std::string dump_path;     // --dump-candidates PATH: NMS 전 후보 기록 (bench_nms 입력)
+    std::string backend_name = "opencv";   // --backend: 추론 백엔드
+    std::string model_path = "./best.onnx";  // --model: FP32 또는 INT8 모델
+    int infer_threads = 0;     // --infer-threads N: 추론 스레드 수 (0 = 백엔드 기본값)
+    NmsParams nms_params;
+    nms_params.score_threshold = SCORE_THRESHOLD;
+    nms_params.iou_threshold = NMS_THRESHOLD;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") headless = true;
+        else if (arg == "--sequential") sequential = true;
+        else if (arg == "--no-can") use_can = false;
+        else if (arg == "--frames" && i + 1 < argc) max_frames = atoi(argv[++i]);
+        else if (arg == "--cv-threads" && i + 1 < argc) cv_threads = atoi(argv[++i]);
+        else if (arg == "--video" && i + 1 < argc) video_path = argv[++i];
+        else if (arg == "--nms-agnostic") {   // 기존 NMSBoxes처럼 클래스 무시 + 후보 수 제한 없음 (같은 박스를 남김)
+            nms_params.class_aware = false;
+            nms_params.top_k = 0;
+        }
+        else if (arg == "--nms-fast") nms_params.fast = true;
+        else if (arg == "--dump-candidates" && i + 1 < argc) dump_path = argv[++i];
+        else if (arg == "--backend" && i + 1 < argc) backend_name = argv[++i];
+        else if (arg == "--model" && i + 1 < argc) model_path = argv[++i];
+        else if (arg == "--infer-threads" && i + 1 < argc) infer_threads = atoi(argv[++i]);
+    }
+    signal(SIGINT, on_sigint);
+    if (cv_threads >= 0) cv::setNumThreads(cv_threads);
+
+    // appsink는 최신 1프레임만 유지 (파이프라인이 바쁠 때 오래된 프레임이 쌓이지 않도록)
+    std::string pipeline = "libcamerasrc ! video/x-raw,width=640,height=480 ! videoconvert ! appsink drop=true max-buffers=1";
+    cv::VideoCapture cap;
+    if (video_path.empty()) cap.open(pipeline, cv::CAP_GSTREAMER);
+    else cap.open(video_path);
     if (!cap.isOpened()) { std::cerr << "오류: GStreamer" << std::endl; return -1; }
 
-    std::string model_path = "./best.onnx"; 
-    cv::dnn::Net net;
-    try { net = cv::dnn::readNetFromONNX(model_path); }
-    catch (cv::Exception& e) { std::cerr << "오류: ONNX" << e.what() << std::endl; return -1; }
-    std::cout << "'best.onnx' 모델 로드 성공!" << std::endl;
-
-    int can_socket = setup_can_socket();
-    if (can_socket < 0) { std::cerr << "CAN 통신을 시작할 수 없습니다." << std::endl; return -1; }
-
-    cv::Mat frame, blob;
-    std::vector<int> class_ids;
-    std::vector<float> confidences;
-    std::vector<cv::Rect> boxes;
-    cv::TickMeter tm; // FPS용
-
-    while (true) {
-        tm.start(); 
-        cap.read(frame); 
-        if (frame.empty()) break;
-
-        // (전처리, 추론, 후처리(인덱싱)는 동일)
-        cv::Mat input_image = format_yolo(frame);
-        cv::dnn::blobFromImage(input_image, blob, 1./255., cv::Size(INPUT_WIDTH, INPUT_HEIGHT), cv::Scalar(), true, false);
-        net.setInput(blob);
-        std::vector<cv::Mat> outputs;
-        net.forward(outputs, net.getUnconnectedOutLayersNames());
-        const int num_detections = outputs[0].size[2]; 
-        float *data = (float *)outputs[0].data;
-        float *cx_data = data;
-        float *cy_data = data + num_detections;
-        float *w_data = data + 2 * num_detections;
-        float *h_data = data + 3 * num_detections;
-        //float x_factor = frame.cols / INPUT_WIDTH;
-        //float y_factor = frame.rows / INPUT_HEIGHT;
-	//
-	float max_dim = (float)MAX(frame.cols, frame.rows); // 640
-        float x_factor = max_dim / INPUT_WIDTH; // 640 / 320 = 2.0
-        float y_factor = max_dim / INPUT_HEIGHT; // 640 / 320 = 2.0
-
-        class_ids.clear();
-        confidences.clear();
-        boxes.clear();
-
-        for (int i = 0; i < num_detections; ++i) {
-            float max_conf = 0.0;
-            int class_id = -1;
-            for (int j = 0; j < class_names.size(); ++j) {
-                float score = data[(4 + j) * num_detections + i];
-                if (score > max_conf) {
-                    max_conf = score;
-                    class_id = j;
-                }
-            }
-            if (max_conf > CONFIDENCE_THRESHOLD) {
-                confidences.push_back(max_conf);
-                class_ids.push_back(class_id); 
-                float cx = cx_data[i];
-                float cy = cy_data[i];
-                float w =  w_data[i];
-                float h =  h_data[i];
-                int left = (int)((cx - 0.5 * w) * x_factor);
-                int top = (int)((cy - 0.5 * h) * y_factor);
-                int width = (int)(w * x_factor);
-                int height = (int)(h * y_factor); 
-                boxes.push_back(cv::Rect(left, top, width, height));
+    std::unique_ptr<DetectorBackend> backend = createDetectorBackend(backend_name);
+    if (!backend) {
+        std::cerr << "오류: 백엔드 '" << backend_name << "' 없음 (이 빌드: " << availableDetectorBackends() << ")" << std::endl;
+        return -1;
+    }
+    if (!backend->load(model_path, infer_threads)) return -1;
+    const bool u8_input = backend->acceptsU8();
+    std::cout << "'" << model_path << "' 모델 로드 성공! (" << backend->name()
+              << (u8_input ? ", uint8 입력" : "") << ")" << std::endl;
+
+    int can_socket = -1;
+    if (use_can) {
+        can_socket = setup_can_socket();
+        if (can_socket < 0) { std::cerr << "CAN 통신을 시작할 수 없습니다." << std::endl; return -1; }
+    }
+
+    DetectSlot slots[NUM_SLOTS];
+    YoloPreprocess pre((int)INPUT_WIDTH, (int)INPUT_HEIGHT);   // 캡처 스레드(또는 --sequential 루프)만 사용
+    PostState post;                                            // 후처리 스레드(또는 --sequential 루프)만 사용
+    post.nms_params = nms_params;
+    if (!dump_path.empty()) {
+        post.dump = fopen(dump_path.c_str(), "w");
+        if (!post.dump) { perror("[ERR] dump-candidates"); return -1; }
+    }
+    StageStats stats;
+    std::atomic<uint32_t> frames_done{0};
+    auto t_start = Clock::now();
+
+    auto finish_frame = [&](DetectSlot& s) {
+        auto t_done = Clock::now();
+        stats.pre.add(ms_between(s.t_capture, s.t_pre));
+        stats.infer_wait.add(ms_between(s.t_pre, s.t_infer_start));
+        stats.infer.add(ms_between(s.t_infer_start, s.t_infer));
+        stats.post.add(ms_between(s.t_infer, t_done));
+        stats.total.add(ms_between(s.t_capture, t_done));
+        uint32_t n = frames_done.fetch_add(1) + 1;
+        if (max_frames > 0 && (int)n >= max_frames) g_running.store(false);
+    };
+    auto current_fps = [&]() {
+        double sec = ms_between(t_start, Clock::now()) / 1000.0;
+        return sec > 0 ? frames_done.load() / sec : 0.0;
+    };
+    auto read_frame = [&](DetectSlot& s) {
+        auto t0 = Clock::now();
+        if (!cap.read(s.frame) || s.frame.empty()) return false;
+        s.t_capture = Clock::now();
+        stats.read.add(ms_between(t0, s.t_capture));
+        return true;
+    };
+
+    SpscRing<DisplayPacket, 2> display_ring;
+    std::thread capture_thread, infer_thread, post_thread;
+
+    if (sequential) {
+        // 기존 방식: 캡처 → 전처리 → 추론 → 후처리 → 화면을 한 스레드에서 순서대로
+        DetectSlot& s = slots[0];
+        uint32_t seq = 0;
+        while (g_running.load()) {
+            if (!read_frame(s)) break;
+            s.seq = seq++;
+            preprocess(pre, s, u8_input);
+            s.t_pre = s.t_infer_start = Clock::now();
+            if (!infer_slot(*backend, pre, s, u8_input)) break;
+            s.t_infer = Clock::now();
+            postprocess(post, s, can_socket);
+            finish_frame(s);
+            if (!headless) {
+                cv::putText(s.frame, cv::format("FPS: %.2f", current_fps()), cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
+                cv::imshow("YOLOv8 C++ (GStreamer + CAN)", s.frame);
+                if (cv::waitKey(1) == 'q') break;
             }
         }
-        std::vector<int> indices;
-        cv::dnn::NMSBoxes(boxes, confidences, SCORE_THRESHOLD, NMS_THRESHOLD, indices);
-
-        // --- 8. 결과 그리기 및 CAN 전송 (⭐ 수정됨) ---
-        for (int idx : indices) {
-            int class_id = class_ids[idx];
-            if (class_id >= class_names.size()) continue; 
-
-            std::string class_name = class_names[class_id];
-            
-            uint8_t can_data_id = 0; // 보낼 CAN 데이터 ID (클래스)
-
-            // 1. 우리가 찾는 클래스인지 확인
-            if (class_name == "Box") {
-                can_data_id = DATA_ID_BOX;
-            } else if (class_name == "Sign_A") {
-                can_data_id = DATA_ID_SIGN_A;
-            } else if (class_name == "Sign_B") {
-                can_data_id = DATA_ID_SIGN_B;
-            }
+    } else {
+        SpscRing<int, RING_SIZE> free_ring, infer_ring, post_ring;
+        for (int i = 0; i < NUM_SLOTS; i++) free_ring.try_push(i);
+        uint64_t dropped_display = 0;
 
-            // 2. 찾는 클래스가 맞다면 (can_data_id가 0이 아님)
-            if (can_data_id != 0) {
-                cv::Rect box = boxes[idx];
-                
-                // 2-1. 화면에 그리기
-                std::string label = cv::format("%.2f", confidences[idx]); 
-                label = class_name + ": " + label;
-                cv::rectangle(frame, box, cv::Scalar(0, 255, 0), 2);
-                draw_label(frame, label, box.x, box.y);
-
-                // 2-2. 터미널에 너비(width) 출력 (요청 사항 1)
-                std::cout << "탐지됨: " << class_name 
-                          << ", X간격(너비): " << box.width << " 픽셀" << std::endl;
-
-                // 2-3. CAN으로 클래스 ID와 너비(width) 전송 (요청 사항 2)
-                send_can_frame(can_socket, CAN_ID_OBSTACLE, can_data_id, box.width);
+        // (A) 캡처 + 전처리
+        capture_thread = std::thread([&]() {
+            uint32_t seq = 0;
+            while (g_running.load()) {
+                int id;
+                if (!free_ring.pop(id)) { std::this_thread::sleep_for(std::chrono::microseconds(500)); continue; }
+                DetectSlot& s = slots[id];
+                if (!read_frame(s)) { g_running.store(false); break; }
+                s.seq = seq++;
+                preprocess(pre, s, u8_input);
+                s.t_pre = Clock::now();
+                infer_ring.try_push(id);
             }
-        }
+        });
 
-        // (FPS 표시 코드)
-        tm.stop();
-        double fps = tm.getFPS();
-        std::string fps_text = cv::format("FPS: %.2f", fps);
-        cv::putText(frame, fps_text, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
+        // (B) 추론 (백엔드 내부 스레드 풀 사용)
+        infer_thread = std::thread([&]() {
+            while (g_running.load()) {
+                int id;
+                if (!infer_ring.pop(id)) { std::this_thread::sleep_for(std::chrono::microseconds(200)); continue; }
+                DetectSlot& s = slots[id];
+                s.t_infer_start = Clock::now();
+                if (!infer_slot(*backend, pre, s, u8_input)) { g_running.store(false); break; }
+                s.t_infer = Clock::now();
+                post_ring.try_push(id);
+            }
+        });
 
-        cv::imshow("YOLOv8 C++ (GStreamer + CAN)", frame);
+        // (C) 후처리 + CAN 전송 + 화면용 복사
+        post_thread = std::thread([&]() {
+            while (g_running.load()) {
+                int id;
+                if (!post_ring.pop(id)) { std::this_thread::sleep_for(std::chrono::microseconds(200)); continue; }
+                DetectSlot& s = slots[id];
+                postprocess(post, s, can_socket);
+                finish_frame(s);
+                if (!headless) {
+                    DisplayPacket pkt;
+                    s.frame.copyTo(pkt.vis);
+                    pkt.fps = current_fps();
+                    if (!display_ring.try_push(std::move(pkt))) dropped_display++;
+                }
+                free_ring.try_push(id);
+            }
+        });
 
-        if (cv::waitKey(1) == 'q') {
-            break; 
+        // (D) 화면 (HighGUI는 메인 스레드에서만)
+        DisplayPacket pkt;
+        while (g_running.load()) {
+            if (headless || !display_ring.pop_latest(pkt)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                continue;
+            }
+            cv::putText(pkt.vis, cv::format("FPS: %.2f", pkt.fps), cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
+            cv::imshow("YOLOv8 C++ (GStreamer + CAN)", pkt.vis);
+            if (cv::waitKey(1) == 'q') g_running.store(false);
         }
+        g_running.store(false);
+        capture_thread.join();
+        infer_thread.join();
+        post_thread.join();
+        if (dropped_display) printf("[DETECT] display skipped %llu frames\n", (unsigned long long)dropped_display);
     }
 
-    close(can_socket); 
+    double sec = ms_between(t_start, Clock::now()) / 1000.0;
+    printf("\n[DETECT] %s, %s %s, %u frames in %.1fs -> %.2f fps (cv threads %d)\n",
+           sequential ? "sequential" : "pipelined", backend->name(), model_path.c_str(), frames_done.load(), sec,
+           sec > 0 ? frames_done.load() / sec : 0.0, cv::getNumThreads());
+    stats.read.print("cap.read");
+    stats.pre.print("preprocess");
+    stats.infer_wait.print("infer queue");
+    stats.infer.print("forward");
+    stats.post.print("post+CAN");
+    stats.total.print("cap->CAN");
+
+    if (post.dump) fclose(post.dump);
+    if (can_socket >= 0) close(can_socket);
     cap.release();
     cv::destroyAllWindows();
     return 0;
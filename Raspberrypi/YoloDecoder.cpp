@@ -0,0 +1,107 @@
+#include "YoloDecoder.h"
+#include <cstddef>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define YOLO_DEC_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define YOLO_DEC_SSE2 1
+#endif
+
+void YoloDetections::reserve(int n) {
+    if ((int)anchor.size() >= n) return;
+    anchor.resize(n);
+    class_id.resize(n);
+    score.resize(n);
+    left.resize(n);
+    top.resize(n);
+    width.resize(n);
+    height.resize(n);
+}
+
+YoloDecoder::YoloDecoder(int num_classes, float conf_threshold)
+    : m_numClasses(num_classes), m_threshold(conf_threshold) {}
+
+// 통과한 anchor만 박스 평면을 읽음 (기존 후처리와 같은 식: 0.5 * w는 double 연산)
+void YoloDecoder::emit(const float* data, int num_anchors, int anchor, float score, int class_id,
+                       float x_factor, float y_factor, YoloDetections& out) const {
+    float cx = data[anchor];
+    float cy = data[num_anchors + anchor];
+    float w = data[2 * num_anchors + anchor];
+    float h = data[3 * num_anchors + anchor];
+    int k = out.count++;
+    out.anchor[k] = anchor;
+    out.class_id[k] = class_id;
+    out.score[k] = score;
+    out.left[k] = (int)((cx - 0.5 * w) * x_factor);
+    out.top[k] = (int)((cy - 0.5 * h) * y_factor);
+    out.width[k] = (int)(w * x_factor);
+    out.height[k] = (int)(h * y_factor);
+}
+
+int YoloDecoder::decode(const float* data, int num_anchors, float x_factor, float y_factor,
+                        YoloDetections& out) const {
+    out.reserve(num_anchors);
+    out.count = 0;
+    const float* cls = data + 4 * num_anchors;   // 클래스 0 평면
+    const int nc = m_numClasses;
+    int i = 0;
+
+#if defined(YOLO_DEC_NEON)
+    const float32x4_t th = vdupq_n_f32(m_threshold);
+    for (; i + 4 <= num_anchors; i += 4) {
+        float32x4_t best = vdupq_n_f32(0.0f);
+        int32x4_t id = vdupq_n_s32(-1);
+        for (int c = 0; c < nc; c++) {
+            float32x4_t v = vld1q_f32(cls + (size_t)c * num_anchors + i);
+            uint32x4_t gt = vcgtq_f32(v, best);
+            best = vbslq_f32(gt, v, best);
+            id = vbslq_s32(gt, vdupq_n_s32(c), id);
+        }
+        uint32x4_t pass = vcgtq_f32(best, th);
+        uint32x2_t any = vorr_u32(vget_low_u32(pass), vget_high_u32(pass));
+        if (vget_lane_u32(vpmax_u32(any, any), 0) == 0) continue;   // 4개 모두 탈락: 박스 평면 안 읽음
+        float b[4];
+        int32_t k[4];
+        uint32_t m[4];
+        vst1q_f32(b, best);
+        vst1q_s32(k, id);
+        vst1q_u32(m, pass);
+        for (int j = 0; j < 4; j++)
+            if (m[j]) emit(data, num_anchors, i + j, b[j], k[j], x_factor, y_factor, out);
+    }
+#elif defined(YOLO_DEC_SSE2)
+    const __m128 th = _mm_set1_ps(m_threshold);
+    for (; i + 4 <= num_anchors; i += 4) {
+        __m128 best = _mm_setzero_ps();
+        __m128i id = _mm_set1_epi32(-1);
+        for (int c = 0; c < nc; c++) {
+            __m128 v = _mm_loadu_ps(cls + (size_t)c * num_anchors + i);
+            __m128 gt = _mm_cmpgt_ps(v, best);
+            __m128i gti = _mm_castps_si128(gt);
+            best = _mm_or_ps(_mm_and_ps(gt, v), _mm_andnot_ps(gt, best));
+            id = _mm_or_si128(_mm_and_si128(gti, _mm_set1_epi32(c)), _mm_andnot_si128(gti, id));
+        }
+        int mask = _mm_movemask_ps(_mm_cmpgt_ps(best, th));
+        if (mask == 0) continue;   // 4개 모두 탈락: 박스 평면 안 읽음
+        float b[4];
+        int32_t k[4];
+        _mm_storeu_ps(b, best);
+        _mm_storeu_si128((__m128i*)k, id);
+        for (int j = 0; j < 4; j++)
+            if (mask & (1 << j)) emit(data, num_anchors, i + j, b[j], k[j], x_factor, y_factor, out);
+    }
+#endif
+
+    for (; i < num_anchors; i++) {
+        float best = 0.0f;
+        int id = -1;
+        for (int c = 0; c < nc; c++) {
+            float v = cls[(size_t)c * num_anchors + i];
+            if (v > best) { best = v; id = c; }
+        }
+        if (best > m_threshold) emit(data, num_anchors, i, best, id, x_factor, y_factor, out);
+    }
+    return out.count;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 임계값을 넘은 후보 (struct-of-arrays, 용량은 미리 할당)
+ *
+ * 각 배열의 앞 count개만 유효하며 anchor 번호 오름차순입니다. (기존 후처리 루프의 push_back 순서와 같음)
+ */
+struct YoloDetections {
+    int count = 0;
+    std::vector<int> anchor;       // 출력 텐서의 anchor 번호
+    std::vector<int> class_id;
+    std::vector<float> score;      // 최고 클래스 점수
+    std::vector<int> left, top, width, height;   // 원본 프레임 좌표 (픽셀)
+
+    /**
+     * @brief 최대 n개까지 재할당 없이 담을 수 있도록 용량을 맞춥니다.
+     */
+    void reserve(int n);
+};
+
+/**
+ * @brief YOLOv8 출력([1, 4 + 클래스 수, anchor 수]) 디코더
+ *
+ * 기존 후처리 루프(anchor마다 클래스 점수를 스칼라로 훑은 뒤 임계값 비교, 통과하면 박스 계산)와
+ * 같은 후보/순서/박스를 만들되,
+ *  - 클래스 점수 평면을 anchor 방향(열 방향)으로 4개씩 읽어 SIMD max / argmax를 구하고
+ *    (NEON / SSE2, 그 외는 스칼라)
+ *  - 임계값을 넘지 못한 anchor는 박스 평면(cx, cy, w, h)을 읽지 않고 버리며
+ *  - 통과한 anchor만 미리 할당한 YoloDetections에 씁니다. (디코드 중 할당 없음)
+ *
+ * 동점은 앞 클래스가 이기고 점수가 0 이하이면 class_id -1로 남습니다. (기존 루프의 `score > max_conf`와 같음)
+ */
+class YoloDecoder {
+public:
+    /**
+     * @param num_classes 클래스 수 (출력 채널 수 - 4)
+     * @param conf_threshold 최고 클래스 점수가 이 값보다 커야 후보 (기존 CONFIDENCE_THRESHOLD)
+     */
+    YoloDecoder(int num_classes, float conf_threshold);
+
+    /**
+     * @brief 출력 텐서 디코드
+     * @param data 출력 텐서 시작 (채널 우선: cx, cy, w, h, 클래스 0.. 평면이 anchor 수 간격으로 이어짐)
+     * @param num_anchors anchor 수 (320x320이면 2100)
+     * @param x_factor 네트워크 좌표 → 원본 프레임 x 배율 (letterbox 한 변 / 입력 폭)
+     * @param y_factor 네트워크 좌표 → 원본 프레임 y 배율
+     * @param out 결과 (필요하면 용량을 늘림)
+     * @return 후보 수 (out.count)
+     */
+    int decode(const float* data, int num_anchors, float x_factor, float y_factor, YoloDetections& out) const;
+
+    int numClasses() const { return m_numClasses; }
+    float threshold() const { return m_threshold; }
+
+private:
+    void emit(const float* data, int num_anchors, int anchor, float score, int class_id,
+              float x_factor, float y_factor, YoloDetections& out) const;
+
+    int m_numClasses;
+    float m_threshold;
+};
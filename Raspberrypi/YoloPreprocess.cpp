@@ -0,0 +1,207 @@
+#include "YoloPreprocess.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define YOLO_PRE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define YOLO_PRE_SSE2 1
+#endif
+
+// OpenCV INTER_RESIZE_COEF_BITS와 같은 가중치 정밀도
+static const int COEF_BITS = 11;
+static const int COEF_SCALE = 1 << COEF_BITS;
+
+static const float INV_255 = 1.0f / 255.0f;
+
+// 채널 한 행(u8) → 출력 텐서 한 행, 패딩 열은 0
+static void store_row(const uint8_t* src, int n, int w, float* dst) {
+    int i = 0;
+#if defined(YOLO_PRE_NEON)
+    const float32x4_t k = vdupq_n_f32(INV_255);
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = vmovl_u8(vld1_u8(src + i));
+        vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))), k));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))), k));
+    }
+#elif defined(YOLO_PRE_SSE2)
+    const __m128 k = _mm_set1_ps(INV_255);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + i)), zero);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), k));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), k));
+    }
+#endif
+    for (; i < n; i++) dst[i] = src[i] * INV_255;
+    if (n < w) std::memset(dst + n, 0, (w - n) * sizeof(float));
+}
+
+static void store_row(const uint8_t* src, int n, int w, uint8_t* dst) {
+    std::memcpy(dst, src, n);
+    if (n < w) std::memset(dst + n, 0, w - n);
+}
+
+YoloPreprocess::YoloPreprocess(int dst_w, int dst_h)
+    : m_dstW(dst_w), m_dstH(dst_h), m_cols(-1), m_rows(-1), m_scale(1.0),
+      m_fast(false), m_activeCols(0), m_activeRows(0),
+      m_r(dst_w), m_g(dst_w), m_b(dst_w) {}
+
+// cv::resize(INTER_LINEAR)와 같은 좌표 변환: 픽셀 중심 정렬, 경계는 가장자리 픽셀
+void YoloPreprocess::buildTaps(int src_len, int dst_len, std::vector<Tap>& taps, int& active) {
+    const int L = std::max(m_cols, m_rows);   // letterbox 한 변
+    const double inv = (double)L / dst_len;
+    taps.resize(dst_len);
+    active = 0;
+    for (int d = 0; d < dst_len; d++) {
+        double f = (d + 0.5) * inv - 0.5;
+        int s = (int)std::floor(f);
+        f -= s;
+        if (s < 0) { s = 0; f = 0.0; }
+        if (s >= L - 1) { s = L - 1; f = 0.0; }
+        Tap& t = taps[d];
+        t.i0 = s;
+        t.i1 = std::min(s + 1, L - 1);
+        t.w0 = (int)std::lround((1.0 - f) * COEF_SCALE);
+        t.w1 = (int)std::lround(f * COEF_SCALE);
+        // letterbox 패딩(0)에 걸린 탭은 가중치 0 → 읽지 않음
+        if (t.i1 >= src_len) { t.i1 = std::min(t.i0, src_len - 1); t.w1 = 0; }
+        if (t.i0 >= src_len) { t.i0 = 0; t.w0 = 0; }
+        if (t.w0 || t.w1) active = d + 1;
+    }
+}
+
+void YoloPreprocess::configure(int cols, int rows) {
+    m_cols = cols;
+    m_rows = rows;
+    const int L = std::max(cols, rows);
+    m_scale = (double)L / m_dstW;
+    m_fast = (L == 2 * m_dstW && L == 2 * m_dstH);
+    if (m_fast) {
+        m_activeCols = (cols + 1) / 2;
+        m_activeRows = (rows + 1) / 2;
+        m_hsum.assign((size_t)cols * 3, 0);
+    } else {
+        buildTaps(cols, m_dstW, m_xTaps, m_activeCols);
+        buildTaps(rows, m_dstH, m_yTaps, m_activeRows);
+    }
+}
+
+// 2배 축소: 출력 = (2x2 합 + 2) >> 2 (OpenCV resizeAreaFast와 같은 반올림), s1 == nullptr이면 아래 행은 패딩(0)
+void YoloPreprocess::rowFast(const uint8_t* s0, const uint8_t* s1) {
+    const int cols = m_cols;
+    const int pairs = cols / 2;
+    int dx = 0;
+#if defined(YOLO_PRE_NEON)
+    if (s1) {
+        for (; dx + 8 <= pairs; dx += 8) {
+            uint8x16x3_t a = vld3q_u8(s0 + dx * 6);
+            uint8x16x3_t b = vld3q_u8(s1 + dx * 6);
+            vst1_u8(&m_b[dx], vrshrn_n_u16(vaddq_u16(vpaddlq_u8(a.val[0]), vpaddlq_u8(b.val[0])), 2));
+            vst1_u8(&m_g[dx], vrshrn_n_u16(vaddq_u16(vpaddlq_u8(a.val[1]), vpaddlq_u8(b.val[1])), 2));
+            vst1_u8(&m_r[dx], vrshrn_n_u16(vaddq_u16(vpaddlq_u8(a.val[2]), vpaddlq_u8(b.val[2])), 2));
+        }
+    }
+#elif defined(YOLO_PRE_SSE2)
+    if (s1) {
+        // HWC 그대로 v[i] + v[i+3] (옆 픽셀) 세로 두 행 합 → 짝수 픽셀 위치만 골라 채널 분리
+        const int n = cols * 3;
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i two = _mm_set1_epi16(2);
+        uint8_t* h = m_hsum.data();
+        int i = 0;
+        for (; i + 11 <= n; i += 8) {
+            __m128i a0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(s0 + i)), zero);
+            __m128i a1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(s0 + i + 3)), zero);
+            __m128i b0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(s1 + i)), zero);
+            __m128i b1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(s1 + i + 3)), zero);
+            __m128i sum = _mm_add_epi16(_mm_add_epi16(a0, a1), _mm_add_epi16(b0, b1));
+            sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+            _mm_storel_epi64((__m128i*)(h + i), _mm_packus_epi16(sum, zero));
+        }
+        for (; dx < pairs && dx * 6 + 3 <= i; dx++) {
+            m_b[dx] = h[dx * 6];
+            m_g[dx] = h[dx * 6 + 1];
+            m_r[dx] = h[dx * 6 + 2];
+        }
+    }
+#endif
+    for (; dx < pairs; dx++) {
+        const uint8_t* p = s0 + dx * 6;
+        const uint8_t* q = s1 ? s1 + dx * 6 : nullptr;
+        m_b[dx] = (uint8_t)((p[0] + p[3] + (q ? q[0] + q[3] : 0) + 2) >> 2);
+        m_g[dx] = (uint8_t)((p[1] + p[4] + (q ? q[1] + q[4] : 0) + 2) >> 2);
+        m_r[dx] = (uint8_t)((p[2] + p[5] + (q ? q[2] + q[5] : 0) + 2) >> 2);
+    }
+    if (cols & 1) {   // 마지막 열: 오른쪽은 패딩
+        const uint8_t* p = s0 + (cols - 1) * 3;
+        const uint8_t* q = s1 ? s1 + (cols - 1) * 3 : nullptr;
+        m_b[dx] = (uint8_t)((p[0] + (q ? q[0] : 0) + 2) >> 2);
+        m_g[dx] = (uint8_t)((p[1] + (q ? q[1] : 0) + 2) >> 2);
+        m_r[dx] = (uint8_t)((p[2] + (q ? q[2] : 0) + 2) >> 2);
+    }
+}
+
+// 일반 배율: 미리 계산한 탭으로 쌍선형 보간
+// 세로 합은 OpenCV VResizeLinear(8u) 벡터 경로와 같은 순서로 자르고 반올림합니다. (비트 단위로 같은 결과)
+void YoloPreprocess::rowGeneric(const uint8_t* s0, const uint8_t* s1, int wy0, int wy1) {
+    const int n = m_activeCols;
+    for (int dx = 0; dx < n; dx++) {
+        const Tap& t = m_xTaps[dx];
+        const uint8_t* p0 = s0 + t.i0 * 3;
+        const uint8_t* p1 = s0 + t.i1 * 3;
+        int v[3];
+        for (int c = 0; c < 3; c++) {
+            int h0 = p0[c] * t.w0 + p1[c] * t.w1;
+            int h1 = 0;
+            if (wy1) h1 = s1[t.i0 * 3 + c] * t.w0 + s1[t.i1 * 3 + c] * t.w1;
+            v[c] = std::min(255, (((wy0 * (h0 >> 4)) >> 16) + ((wy1 * (h1 >> 4)) >> 16) + 2) >> 2);
+        }
+        m_b[dx] = (uint8_t)v[0];
+        m_g[dx] = (uint8_t)v[1];
+        m_r[dx] = (uint8_t)v[2];
+    }
+}
+
+template <typename T>
+void YoloPreprocess::runImpl(const uint8_t* bgr, size_t step, int cols, int rows, T* dst) {
+    if (cols != m_cols || rows != m_rows) configure(cols, rows);
+
+    const int W = m_dstW, H = m_dstH;
+    const size_t plane = (size_t)W * H;
+    T* dr = dst;               // blobFromImage(swapRB=true): 채널 0 = R
+    T* dg = dst + plane;
+    T* db = dst + 2 * plane;
+
+    for (int dy = 0; dy < m_activeRows; dy++) {
+        if (m_fast) {
+            int y0 = dy * 2;
+            rowFast(bgr + y0 * step, (y0 + 1 < rows) ? bgr + (y0 + 1) * step : nullptr);
+        } else {
+            const Tap& t = m_yTaps[dy];
+            rowGeneric(bgr + t.i0 * step, bgr + t.i1 * step, t.w0, t.w1);
+        }
+        store_row(m_r.data(), m_activeCols, W, dr + (size_t)dy * W);
+        store_row(m_g.data(), m_activeCols, W, dg + (size_t)dy * W);
+        store_row(m_b.data(), m_activeCols, W, db + (size_t)dy * W);
+    }
+    // 아래쪽 letterbox 패딩 행
+    const size_t pad = (size_t)(H - m_activeRows) * W;
+    if (pad) {
+        const size_t ofs = (size_t)m_activeRows * W;
+        std::memset(dr + ofs, 0, pad * sizeof(T));
+        std::memset(dg + ofs, 0, pad * sizeof(T));
+        std::memset(db + ofs, 0, pad * sizeof(T));
+    }
+}
+
+void YoloPreprocess::run(const uint8_t* bgr, size_t step, int cols, int rows, float* dst) {
+    runImpl(bgr, step, cols, rows, dst);
+}
+
+void YoloPreprocess::runU8(const uint8_t* bgr, size_t step, int cols, int rows, uint8_t* dst) {
+    runImpl(bgr, step, cols, rows, dst);
+}
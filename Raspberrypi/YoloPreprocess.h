@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief YOLO 입력 전처리 커널 (letterbox + 리사이즈 + 1/255 + BGR→RGB + HWC→CHW 한 번에)
+ *
+ * 기존 경로(format_yolo: _max x _max 0 행렬 할당 → 복사 → cv::resize, 이어서 blobFromImage:
+ * float 변환 → 스케일 → 채널 분리)와 같은 텐서를 만들되,
+ *  - 원본 프레임을 한 번만 읽어 미리 할당된 NCHW 텐서(1x3xHxW)에 바로 씁니다. (중간 Mat 없음)
+ *  - 리사이즈 맵(열/행 오프셋 + 고정소수점 가중치)은 입력 크기가 바뀔 때만 계산합니다.
+ *  - letterbox 패딩(오른쪽/아래, format_yolo와 같은 위치)은 리사이즈하지 않고 0으로 채웁니다.
+ *  - letterbox 한 변이 출력의 정확히 2배이면(640x480 → 320x320) 2x2 평균 경로를 쓰며
+ *    NEON(vld3 + 쌍 덧셈) / SSE2(2x2 합)로 벡터화됩니다.
+ *
+ * 결과는 format_yolo + blobFromImage와 비트 단위로 같습니다. (2배 경로는 cv::resize가 내부적으로 쓰는
+ * INTER_AREA 반올림, 일반 배율은 INTER_LINEAR 고정소수점 반올림을 그대로 따름)
+ * OpenCV에 의존하지 않으므로 cv::Mat 없이도 사용할 수 있습니다.
+ */
+class YoloPreprocess {
+public:
+    /**
+     * @param dst_w 네트워크 입력 폭
+     * @param dst_h 네트워크 입력 높이
+     */
+    explicit YoloPreprocess(int dst_w = 320, int dst_h = 320);
+
+    /**
+     * @brief BGR 8UC3 프레임 → float NCHW (RGB, 0~1)
+     * @param bgr 첫 행 시작 포인터
+     * @param step 행 간격 (바이트)
+     * @param cols 프레임 폭
+     * @param rows 프레임 높이
+     * @param dst tensorSize()개 float (1x3xHxW)
+     */
+    void run(const uint8_t* bgr, size_t step, int cols, int rows, float* dst);
+
+    /**
+     * @brief BGR 8UC3 프레임 → uint8 NCHW (RGB, 0~255, 양자화 입력용: 1/255는 입력 양자화 스케일로)
+     */
+    void runU8(const uint8_t* bgr, size_t step, int cols, int rows, uint8_t* dst);
+
+    int width() const { return m_dstW; }
+    int height() const { return m_dstH; }
+    size_t tensorSize() const { return (size_t)3 * m_dstW * m_dstH; }
+
+    /**
+     * @brief letterbox 한 변 / 출력 폭 (후처리의 x_factor, y_factor)
+     */
+    double scale() const { return m_scale; }
+
+    /**
+     * @brief 패딩이 아닌(원본 픽셀이 섞인) 출력 열/행 수 (마지막 run() 기준)
+     */
+    int activeCols() const { return m_activeCols; }
+    int activeRows() const { return m_activeRows; }
+
+    /**
+     * @brief 2x2 평균 경로 사용 여부 (마지막 run() 기준)
+     */
+    bool fastPath() const { return m_fast; }
+
+private:
+    // 한 방향 보간 탭: 원본 좌표 두 개와 Q11 가중치 (패딩 쪽 탭은 가중치 0)
+    struct Tap {
+        int i0, i1;
+        int w0, w1;
+    };
+
+    void configure(int cols, int rows);
+    void buildTaps(int src_len, int dst_len, std::vector<Tap>& taps, int& active);
+    template <typename T> void runImpl(const uint8_t* bgr, size_t step, int cols, int rows, T* dst);
+    void rowFast(const uint8_t* s0, const uint8_t* s1);
+    void rowGeneric(const uint8_t* s0, const uint8_t* s1, int wy0, int wy1);
+
+    int m_dstW, m_dstH;
+    int m_cols, m_rows;           // 맵을 계산한 입력 크기 (-1: 미계산)
+    double m_scale;
+    bool m_fast;
+    int m_activeCols, m_activeRows;
+    std::vector<Tap> m_xTaps, m_yTaps;
+    std::vector<uint8_t> m_hsum;             // 2배 경로: 2x2 평균 (HWC, 짝수 픽셀 위치만 사용)
+    std::vector<uint8_t> m_r, m_g, m_b;      // 출력 한 행 (채널별)
+};
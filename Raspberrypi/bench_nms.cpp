@@ -0,0 +1,197 @@
+/**
+ * @file bench_nms.cpp
+ * @brief 후보가 많은 장면에서 cv::dnn::NMSBoxes와 FastNms(클래스별, 고정 버퍼)를 비교합니다.
+ *
+ * - 장면 입력 (셋 중 하나)
+ *   1) Send_Detect2 --dump-candidates로 저장한 CSV (frame,class,score,left,top,width,height)
+ *   2) YOLO 라벨 폴더: 정답 박스마다 흔들린 후보 20~60개(10%는 다른 클래스)를 만든 합성 장면
+ *   3) 인자 없음: 물체 5~40개가 겹쳐 있는 합성 밀집 장면
+ * - 장면마다 기존 방식(매 프레임 vector<Rect>/vector<float>를 새로 채워 NMSBoxes)과
+ *   FastNms(클래스 무시 / 클래스별 탐욕 / 클래스별 Fast NMS)의 장면당 시간(us)과 남은 박스 수를 출력합니다.
+ * - FastNms 클래스 무시 + top_k 0은 NMSBoxes와 남은 인덱스가 같은지 검사합니다.
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o bench_nms bench_nms.cpp FastNms.cpp YoloDecoder.cpp -std=c++17 `pkg-config --cflags --libs opencv4`
+ *
+ * [실행 방법]
+ * ./bench_nms [candidates.csv | 라벨 폴더] [반복 횟수]
+ * (예: ./bench_nms ../PC/Detection.v2-v2.yolov8/valid/labels 200)
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <opencv2/opencv.hpp>
+#include <opencv2/dnn.hpp>
+
+#include "FastNms.h"
+
+using namespace std;
+
+static const int NUM_CLASSES = 3;
+static const int FRAME_W = 640, FRAME_H = 480;
+static const float SCORE_THRESHOLD = 0.5f;
+static const float NMS_THRESHOLD = 0.45f;
+
+static void push(YoloDetections& d, int cls, float score, int l, int t, int w, int h) {
+    if (d.count == (int)d.anchor.size()) d.reserve(d.count * 2 + 16);
+    int k = d.count++;
+    d.anchor[k] = k;
+    d.class_id[k] = cls;
+    d.score[k] = score;
+    d.left[k] = l;
+    d.top[k] = t;
+    d.width[k] = w;
+    d.height[k] = h;
+}
+
+// 정답 박스(픽셀) 하나 주변에 YOLO처럼 겹친 후보를 뿌림
+static void add_cluster(YoloDetections& d, mt19937& rng, int cls, float cx, float cy, float w, float h) {
+    uniform_int_distribution<int> count(20, 60);
+    normal_distribution<float> pos(0.0f, 0.06f), size(1.0f, 0.1f);
+    uniform_real_distribution<float> u(0.0f, 1.0f);
+    int n = count(rng);
+    for (int i = 0; i < n; i++) {
+        float bw = w * max(0.3f, size(rng)), bh = h * max(0.3f, size(rng));
+        float bx = cx + w * pos(rng), by = cy + h * pos(rng);
+        int c = (u(rng) < 0.1f) ? (cls + 1) % NUM_CLASSES : cls;
+        push(d, c, 0.5f + 0.45f * u(rng), (int)(bx - bw / 2), (int)(by - bh / 2), (int)bw, (int)bh);
+    }
+}
+
+static bool is_dir(const string& p) {
+    struct stat st;
+    return stat(p.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static vector<YoloDetections> load_csv(const string& path) {
+    map<long, YoloDetections> frames;
+    ifstream in(path);
+    string line;
+    while (getline(in, line)) {
+        long frame;
+        int cls, l, t, w, h;
+        float score;
+        if (sscanf(line.c_str(), "%ld,%d,%f,%d,%d,%d,%d", &frame, &cls, &score, &l, &t, &w, &h) == 7)
+            push(frames[frame], cls, score, l, t, w, h);
+    }
+    vector<YoloDetections> out;
+    for (auto& kv : frames) out.push_back(kv.second);
+    return out;
+}
+
+static vector<YoloDetections> load_labels(const string& dir, mt19937& rng) {
+    vector<string> files;
+    cv::glob(dir + "/*.txt", files, false);
+    vector<YoloDetections> out;
+    for (const auto& f : files) {
+        ifstream in(f);
+        YoloDetections d;
+        int cls;
+        float cx, cy, w, h;
+        while (in >> cls >> cx >> cy >> w >> h)
+            add_cluster(d, rng, cls, cx * FRAME_W, cy * FRAME_H, w * FRAME_W, h * FRAME_H);
+        if (d.count) out.push_back(d);
+    }
+    return out;
+}
+
+static vector<YoloDetections> synthetic(mt19937& rng, int scenes) {
+    uniform_int_distribution<int> objects(5, 40), cls(0, NUM_CLASSES - 1);
+    uniform_real_distribution<float> x(0, FRAME_W), y(0, FRAME_H), s(20, 160);
+    vector<YoloDetections> out;
+    for (int i = 0; i < scenes; i++) {
+        YoloDetections d;
+        int n = objects(rng);
+        for (int k = 0; k < n; k++) add_cluster(d, rng, cls(rng), x(rng), y(rng), s(rng), s(rng));
+        out.push_back(d);
+    }
+    return out;
+}
+
+// 기존 Send_Detect2 방식: 매 프레임 vector를 새로 채워 NMSBoxes
+static void legacy_nms(const YoloDetections& d, vector<int>& indices) {
+    vector<cv::Rect> boxes;
+    vector<float> confidences;
+    for (int k = 0; k < d.count; k++) {
+        boxes.push_back(cv::Rect(d.left[k], d.top[k], d.width[k], d.height[k]));
+        confidences.push_back(d.score[k]);
+    }
+    cv::dnn::NMSBoxes(boxes, confidences, SCORE_THRESHOLD, NMS_THRESHOLD, indices);
+}
+
+int main(int argc, char** argv) {
+    string input = (argc > 1) ? argv[1] : "";
+    int iters = (argc > 2) ? atoi(argv[2]) : 200;
+    cv::setNumThreads(1);
+    mt19937 rng(3);
+
+    vector<YoloDetections> scenes;
+    if (input.empty()) scenes = synthetic(rng, 50);
+    else if (is_dir(input)) scenes = load_labels(input, rng);
+    else scenes = load_csv(input);
+    if (scenes.empty()) { cerr << "[ERR] 장면이 없습니다: " << input << endl; return 1; }
+
+    int max_count = 0;
+    long total = 0;
+    for (const auto& s : scenes) { max_count = max(max_count, s.count); total += s.count; }
+    printf("[NMS] %zu scenes, candidates avg %.1f, max %d\n", scenes.size(), (double)total / scenes.size(), max_count);
+
+    FastNms nms(max(8400, max_count), NUM_CLASSES);
+    NmsParams agnostic;
+    agnostic.score_threshold = SCORE_THRESHOLD;
+    agnostic.iou_threshold = NMS_THRESHOLD;
+    agnostic.class_aware = false;
+    agnostic.top_k = 0;
+    NmsParams aware = agnostic;
+    aware.class_aware = true;
+    aware.top_k = 100;
+    NmsParams fast = aware;
+    fast.fast = true;
+
+    // 결과 비교
+    int mismatch = 0;
+    long kept_legacy = 0, kept_agnostic = 0, kept_aware = 0, kept_fast = 0;
+    vector<int> indices;
+    for (const auto& s : scenes) {
+        legacy_nms(s, indices);
+        int n = nms.run(s, agnostic);
+        vector<int> mine(nms.kept(), nms.kept() + n);
+        if (mine != indices) mismatch++;
+        kept_legacy += indices.size();
+        kept_agnostic += n;
+        kept_aware += nms.run(s, aware);
+        kept_fast += nms.run(s, fast);
+    }
+
+    // 시간
+    auto time_us = [&](auto&& fn) {
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < iters; i++)
+            for (const auto& s : scenes) fn(s);
+        auto t1 = chrono::steady_clock::now();
+        return chrono::duration<double, micro>(t1 - t0).count() / ((double)iters * scenes.size());
+    };
+    double us_legacy = time_us([&](const YoloDetections& s) { legacy_nms(s, indices); });
+    double us_agnostic = time_us([&](const YoloDetections& s) { nms.run(s, agnostic); });
+    double us_aware = time_us([&](const YoloDetections& s) { nms.run(s, aware); });
+    double us_fast = time_us([&](const YoloDetections& s) { nms.run(s, fast); });
+
+    const double ns = (double)scenes.size();
+    printf("  NMSBoxes (vector 재구성)      : %8.2f us/scene, kept %.2f\n", us_legacy, kept_legacy / ns);
+    printf("  FastNms 클래스 무시, top_k 0  : %8.2f us/scene, kept %.2f (x%.2f)\n", us_agnostic, kept_agnostic / ns, us_legacy / us_agnostic);
+    printf("  FastNms 클래스별, top_k 100   : %8.2f us/scene, kept %.2f (x%.2f)\n", us_aware, kept_aware / ns, us_legacy / us_aware);
+    printf("  FastNms 클래스별 Fast NMS     : %8.2f us/scene, kept %.2f (x%.2f)\n", us_fast, kept_fast / ns, us_legacy / us_fast);
+    printf("  NMSBoxes와 다른 장면 (클래스 무시): %d\n", mismatch);
+    cout << (mismatch ? "[FAIL]" : "[PASS]") << " class-agnostic FastNms matches NMSBoxes" << endl;
+    return mismatch ? 1 : 0;
+}
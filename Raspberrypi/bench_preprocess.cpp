@@ -0,0 +1,123 @@
+/**
+ * @file bench_preprocess.cpp
+ * @brief YOLO 입력 전처리: 기존 경로(format_yolo + blobFromImage)와 YoloPreprocess(한 번에)를 비교합니다.
+ *
+ * - 기존: _max x _max 0 행렬 할당 → 프레임 복사 → cv::resize → blobFromImage(float 변환, 1/255, RGB, CHW)
+ * - 새 경로: YoloPreprocess::run()이 미리 할당한 1x3xHxW 텐서에 바로 씀 (+ runU8: uint8 텐서)
+ * - 두 결과의 최대 차이(LSB, 1/255 단위)와 일치율, 호출당 시간(us)을 출력합니다.
+ *   (정상이면 최대 차이 0: 비트 단위로 같은 텐서)
+ * - 프레임 크기 여러 개(640x480 = 2배 경로, 그 외 = 일반 보간 경로)를 모두 검사합니다.
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o bench_preprocess bench_preprocess.cpp YoloPreprocess.cpp -std=c++17 `pkg-config --cflags --libs opencv4`
+ *
+ * [실행 방법]
+ * ./bench_preprocess [반복 횟수] [이미지 파일]
+ * (예: ./bench_preprocess 500 ../PC/Detection.v2-v2.yolov8/valid/images/xxx.jpg)
+ * 이미지를 주지 않으면 난수 프레임을 사용합니다. 이미지를 주면 그 크기로만 측정합니다.
+ * 스레드 수 영향을 빼려면 OpenCV 스레드를 1개로 고정합니다. (cv::setNumThreads(1))
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <opencv2/opencv.hpp>
+#include <opencv2/dnn.hpp>
+
+#include "YoloPreprocess.h"
+
+using namespace std;
+
+static const int INPUT_SIZE = 320;
+
+// Send_Detect2.cpp의 기존 format_yolo
+static cv::Mat format_yolo(const cv::Mat &source) {
+    int col = source.cols;
+    int row = source.rows;
+    int _max = MAX(col, row);
+    cv::Mat result = cv::Mat::zeros(_max, _max, CV_8UC3);
+    source.copyTo(result(cv::Rect(0, 0, col, row)));
+    cv::resize(result, result, cv::Size(INPUT_SIZE, INPUT_SIZE));
+    return result;
+}
+
+static void legacy(const cv::Mat& frame, cv::Mat& blob) {
+    cv::Mat input_image = format_yolo(frame);
+    cv::dnn::blobFromImage(input_image, blob, 1./255., cv::Size(INPUT_SIZE, INPUT_SIZE), cv::Scalar(), true, false);
+}
+
+static bool run_case(const cv::Mat& frame, int iters) {
+    YoloPreprocess pre(INPUT_SIZE, INPUT_SIZE);
+    vector<float> tensor(pre.tensorSize());
+    vector<uint8_t> tensor_u8(pre.tensorSize());
+    cv::Mat blob;
+
+    // 정확도
+    legacy(frame, blob);
+    pre.run(frame.ptr<uint8_t>(), frame.step, frame.cols, frame.rows, tensor.data());
+    pre.runU8(frame.ptr<uint8_t>(), frame.step, frame.cols, frame.rows, tensor_u8.data());
+    const float* ref = blob.ptr<float>();
+    double max_diff = 0.0;
+    size_t exact = 0, u8_bad = 0;
+    for (size_t i = 0; i < tensor.size(); i++) {
+        double d = fabs((double)tensor[i] - ref[i]) * 255.0;
+        max_diff = max(max_diff, d);
+        if (tensor[i] == ref[i]) exact++;
+        if (fabs(tensor_u8[i] - ref[i] * 255.0) > 0.01) u8_bad++;
+    }
+
+    // 시간
+    auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < iters; i++) legacy(frame, blob);
+    auto t1 = chrono::steady_clock::now();
+    for (int i = 0; i < iters; i++)
+        pre.run(frame.ptr<uint8_t>(), frame.step, frame.cols, frame.rows, tensor.data());
+    auto t2 = chrono::steady_clock::now();
+    for (int i = 0; i < iters; i++)
+        pre.runU8(frame.ptr<uint8_t>(), frame.step, frame.cols, frame.rows, tensor_u8.data());
+    auto t3 = chrono::steady_clock::now();
+
+    double us_legacy = chrono::duration<double, micro>(t1 - t0).count() / iters;
+    double us_fused = chrono::duration<double, micro>(t2 - t1).count() / iters;
+    double us_u8 = chrono::duration<double, micro>(t3 - t2).count() / iters;
+
+    printf("%4dx%-4d %-7s active %3dx%-3d | max diff %.3f LSB, exact %6.2f%%, u8 mismatch %zu | "
+           "legacy %7.1f us, fused %7.1f us (x%.2f), u8 %7.1f us\n",
+           frame.cols, frame.rows, pre.fastPath() ? "2x" : "linear", pre.activeCols(), pre.activeRows(),
+           max_diff, 100.0 * exact / tensor.size(), u8_bad,
+           us_legacy, us_fused, us_legacy / us_fused, us_u8);
+    return max_diff < 1e-3 && u8_bad == 0;
+}
+
+int main(int argc, char** argv) {
+    int iters = (argc > 1) ? atoi(argv[1]) : 300;
+    cv::setNumThreads(1);
+
+    vector<cv::Mat> frames;
+    if (argc > 2) {
+        cv::Mat img = cv::imread(argv[2]);
+        if (img.empty()) { cerr << "[ERR] 이미지를 열 수 없습니다: " << argv[2] << endl; return 1; }
+        frames.push_back(img);
+    } else {
+        const cv::Size sizes[] = {{640, 480}, {480, 640}, {641, 481}, {1280, 720}, {320, 240}};
+        mt19937 rng(1);
+        for (const cv::Size& sz : sizes) {
+            cv::Mat f(sz, CV_8UC3);
+            for (int y = 0; y < f.rows; y++) {
+                uint8_t* p = f.ptr<uint8_t>(y);
+                for (int x = 0; x < f.cols * 3; x++) p[x] = (uint8_t)(rng() & 0xFF);
+            }
+            frames.push_back(f);
+        }
+    }
+
+    bool ok = true;
+    for (const cv::Mat& f : frames) ok &= run_case(f, iters);
+    cout << (ok ? "[PASS]" : "[FAIL]") << " fused tensor matches format_yolo + blobFromImage" << endl;
+    return ok ? 0 : 1;
+}
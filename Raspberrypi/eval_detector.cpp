@@ -0,0 +1,272 @@
+/**
+ * @file eval_detector.cpp
+ * @brief 검출기 백엔드/모델별 mAP50과 fps를 검증 세트로 측정합니다.
+ *
+ * - Send_Detect2와 같은 경로: YoloPreprocess → DetectorBackend → YoloDecoder → FastNms(클래스별)
+ * - mAP50: ultralytics val과 같은 방식
+ *   (conf 0.001, NMS IoU 0.7, 예측마다 IoU 0.5 이상 같은 클래스 정답 중 IoU 최대를 고르고
+ *    정답 하나는 점수가 가장 높은 예측만 TP, 101점 보간 AP의 클래스 평균)
+ * - 시간: 이미지마다 추론(ms), 전처리+추론+후처리 전체(ms) → fps (한 스레드, 파이프라인 없음)
+ * - 백엔드/모델 쌍을 여러 개 주면 같은 이미지로 차례로 측정해 표로 출력합니다.
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o eval_detector eval_detector.cpp DetectorBackend.cpp YoloPreprocess.cpp YoloDecoder.cpp FastNms.cpp -std=c++17 `pkg-config --cflags --libs opencv4`
+ * (ONNX Runtime: -DDETECTOR_WITH_ONNXRUNTIME -lonnxruntime 추가)
+ * (TFLite: -DDETECTOR_WITH_TFLITE -ltensorflowlite 추가, XNNPACK 델리게이트 포함 빌드)
+ *
+ * [실행 방법]
+ * ./eval_detector [--data 폴더] [--threads N] [--max 이미지 수] --backend 이름 모델 [--backend 이름 모델 ...]
+ * (예: ./eval_detector --threads 4 --backend opencv best.onnx --backend opencv best_int8.onnx
+ *                      --backend ort best_int8.onnx --backend tflite best_int8.tflite)
+ * 폴더 기본값: ../PC/Detection.v2-v2.yolov8/valid (images 폴더의 jpg + labels 폴더의 txt)
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <cstdio>
+#include <cstdlib>
+#include <opencv2/opencv.hpp>
+
+#include "DetectorBackend.h"
+#include "YoloPreprocess.h"
+#include "YoloDecoder.h"
+#include "FastNms.h"
+#include "../LKAS_ACC/LatencyStats.h"
+
+using namespace std;
+
+static const vector<string> CLASS_NAMES = {"Box", "Sign_A", "Sign_B"};
+static const int INPUT_SIZE = 320;
+static const float EVAL_CONF = 0.001f;   // ultralytics val 기본값
+static const float EVAL_NMS_IOU = 0.7f;
+static const float MATCH_IOU = 0.5f;     // mAP50
+
+struct GtBox { int cls; float x1, y1, x2, y2; };
+
+struct Sample {
+    string image;
+    vector<GtBox> gt;
+};
+
+// 예측 하나의 평가 결과 (클래스별 AP 계산용)
+struct Scored { float score; bool tp; };
+
+static float iou(float ax1, float ay1, float ax2, float ay2, float bx1, float by1, float bx2, float by2) {
+    float iw = min(ax2, bx2) - max(ax1, bx1);
+    float ih = min(ay2, by2) - max(ay1, by1);
+    if (iw <= 0 || ih <= 0) return 0.0f;
+    float inter = iw * ih;
+    return inter / ((ax2 - ax1) * (ay2 - ay1) + (bx2 - bx1) * (by2 - by1) - inter);
+}
+
+static vector<Sample> load_dataset(const string& dir, int max_images) {
+    vector<string> files;
+    cv::glob(dir + "/images/*.jpg", files, false);
+    sort(files.begin(), files.end());
+    vector<Sample> out;
+    for (const string& f : files) {
+        if (max_images > 0 && (int)out.size() >= max_images) break;
+        size_t slash = f.find_last_of('/');
+        string stem = f.substr(slash + 1, f.find_last_of('.') - slash - 1);
+        Sample s;
+        s.image = f;
+        // 라벨은 정규화 좌표라 이미지 크기가 필요 → 이미지를 읽을 때 픽셀로 변환 (여기서는 정규화 값 보관)
+        ifstream in(dir + "/labels/" + stem + ".txt");
+        int cls;
+        float cx, cy, w, h;
+        while (in >> cls >> cx >> cy >> w >> h) s.gt.push_back({cls, cx - w / 2, cy - h / 2, cx + w / 2, cy + h / 2});
+        out.push_back(s);
+    }
+    return out;
+}
+
+// ultralytics compute_ap: 정밀도 포락선 → 재현율 0~1 101점 선형 보간 → 사다리꼴 적분
+static double compute_ap(const vector<double>& recall, const vector<double>& precision) {
+    vector<double> mrec, mpre;
+    mrec.push_back(0.0);
+    mpre.push_back(1.0);
+    mrec.insert(mrec.end(), recall.begin(), recall.end());
+    mpre.insert(mpre.end(), precision.begin(), precision.end());
+    mrec.push_back(1.0);
+    mpre.push_back(0.0);
+    for (size_t i = mpre.size() - 1; i > 0; i--) mpre[i - 1] = max(mpre[i - 1], mpre[i]);
+
+    auto interp = [&](double x) {   // np.interp
+        if (x < mrec.front()) return mpre.front();   // x == 0 은 np.interp처럼 중복 중 마지막 점 사용
+        if (x >= mrec.back()) return mpre.back();
+        size_t j = upper_bound(mrec.begin(), mrec.end(), x) - mrec.begin() - 1;
+        return mpre[j] + (x - mrec[j]) * (mpre[j + 1] - mpre[j]) / (mrec[j + 1] - mrec[j]);
+    };
+    // np.linspace(0, 1, 101): x_i = i * 0.01, 마지막 점은 정확히 1
+    double ap = 0.0, prev_x = 0.0, prev_y = interp(0.0);
+    for (int i = 1; i <= 100; i++) {
+        double x = (i == 100) ? 1.0 : i * 0.01;
+        double y = interp(x);
+        ap += (x - prev_x) * (prev_y + y) / 2.0;
+        prev_x = x;
+        prev_y = y;
+    }
+    return ap;
+}
+
+struct EvalResult {
+    double map50 = 0.0;
+    vector<double> ap;           // 클래스별 (정답이 없는 클래스는 -1)
+    LatencyStats infer{0.1, 10000};
+    LatencyStats total{0.1, 10000};
+    int images = 0;
+    bool ok = false;
+};
+
+static EvalResult evaluate(const string& backend_name, const string& model, int threads, const vector<Sample>& data) {
+    EvalResult r;
+    unique_ptr<DetectorBackend> backend = createDetectorBackend(backend_name);
+    if (!backend) {
+        cerr << "[ERR] 백엔드 '" << backend_name << "' 없음 (이 빌드: " << availableDetectorBackends() << ")" << endl;
+        return r;
+    }
+    if (!backend->load(model, threads)) return r;
+
+    const int nc = (int)CLASS_NAMES.size();
+    YoloPreprocess pre(INPUT_SIZE, INPUT_SIZE);
+    DetectorOutput output;
+    const bool u8 = backend->acceptsU8();   // 정수 입력 모델은 Send_Detect2와 같이 uint8 텐서로
+    vector<float> tensor(u8 ? 0 : pre.tensorSize());
+    vector<uint8_t> tensor_u8(u8 ? pre.tensorSize() : 0);
+    auto preprocess = [&](const cv::Mat& frame) {
+        if (u8) pre.runU8(frame.ptr<uint8_t>(), frame.step, frame.cols, frame.rows, tensor_u8.data());
+        else pre.run(frame.ptr<uint8_t>(), frame.step, frame.cols, frame.rows, tensor.data());
+    };
+    auto infer = [&]() {
+        return u8 ? backend->inferU8(tensor_u8.data(), INPUT_SIZE, INPUT_SIZE, output)
+                  : backend->infer(tensor.data(), INPUT_SIZE, INPUT_SIZE, output);
+    };
+    YoloDecoder decoder(nc, EVAL_CONF);
+    YoloDetections det;
+    FastNms nms(8400, nc);
+    NmsParams np;
+    np.score_threshold = EVAL_CONF;
+    np.iou_threshold = EVAL_NMS_IOU;
+    np.top_k = 300;
+
+    vector<vector<Scored>> per_class(nc);
+    vector<int> num_gt(nc, 0);
+    bool warmed = false;
+
+    for (const Sample& s : data) {
+        cv::Mat frame = cv::imread(s.image);
+        if (frame.empty()) { cerr << "[WARN] 이미지를 열 수 없습니다: " << s.image << endl; continue; }
+        if (!warmed) {   // 첫 추론(그래프 준비, 메모리 할당)은 시간에서 제외
+            preprocess(frame);
+            if (!infer()) return r;
+            warmed = true;
+        }
+
+        auto t0 = chrono::steady_clock::now();
+        preprocess(frame);
+        auto t1 = chrono::steady_clock::now();
+        if (!infer()) return r;
+        auto t2 = chrono::steady_clock::now();
+        if (output.channels != 4 + nc) {
+            cerr << "[ERR] 모델 출력 채널 " << output.channels << " != 4 + 클래스 " << nc << endl;
+            return r;
+        }
+        float factor = (float)max(frame.cols, frame.rows) / INPUT_SIZE;
+        decoder.decode(output.data.data(), output.anchors, factor, factor, det);
+        int kept = nms.run(det, np);
+        auto t3 = chrono::steady_clock::now();
+        r.infer.add(chrono::duration<double, milli>(t2 - t1).count());
+        r.total.add(chrono::duration<double, milli>(t3 - t0).count());
+        r.images++;
+
+        // 정답 (정규화 → 픽셀)
+        vector<GtBox> gt = s.gt;
+        for (GtBox& g : gt) {
+            g.x1 *= frame.cols; g.x2 *= frame.cols;
+            g.y1 *= frame.rows; g.y2 *= frame.rows;
+            if (g.cls >= 0 && g.cls < nc) num_gt[g.cls]++;
+        }
+
+        // 예측마다 IoU가 가장 큰 같은 클래스 정답 → 정답마다 점수가 가장 높은 예측만 TP (kept는 점수 내림차순)
+        vector<bool> claimed(gt.size(), false);
+        for (int n = 0; n < kept; n++) {
+            int k = nms.kept()[n];
+            int c = det.class_id[k];
+            if (c < 0 || c >= nc) continue;
+            float x1 = (float)det.left[k], y1 = (float)det.top[k];
+            float x2 = x1 + det.width[k], y2 = y1 + det.height[k];
+            int best = -1;
+            float best_iou = MATCH_IOU;
+            for (size_t g = 0; g < gt.size(); g++) {
+                if (gt[g].cls != c) continue;
+                float v = iou(x1, y1, x2, y2, gt[g].x1, gt[g].y1, gt[g].x2, gt[g].y2);
+                if (v >= best_iou) { best_iou = v; best = (int)g; }
+            }
+            bool tp = best >= 0 && !claimed[best];
+            if (tp) claimed[best] = true;
+            per_class[c].push_back({det.score[k], tp});
+        }
+    }
+
+    int classes_with_gt = 0;
+    r.ap.assign(nc, -1.0);
+    for (int c = 0; c < nc; c++) {
+        if (num_gt[c] == 0) continue;
+        classes_with_gt++;
+        vector<Scored>& v = per_class[c];
+        stable_sort(v.begin(), v.end(), [](const Scored& a, const Scored& b) { return a.score > b.score; });
+        vector<double> recall, precision;
+        double tp = 0, fp = 0;
+        for (const Scored& s : v) {
+            (s.tp ? tp : fp) += 1;
+            recall.push_back(tp / (num_gt[c] + 1e-16));
+            precision.push_back(tp / (tp + fp));
+        }
+        r.ap[c] = v.empty() ? 0.0 : compute_ap(recall, precision);
+        r.map50 += r.ap[c];
+    }
+    if (classes_with_gt) r.map50 /= classes_with_gt;
+    r.ok = r.images > 0;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    string data_dir = "../PC/Detection.v2-v2.yolov8/valid";
+    int threads = 0;
+    int max_images = 0;
+    vector<pair<string, string>> runs;   // (백엔드, 모델)
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--data" && i + 1 < argc) data_dir = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (arg == "--max" && i + 1 < argc) max_images = atoi(argv[++i]);
+        else if (arg == "--backend" && i + 2 < argc) { runs.push_back({argv[i + 1], argv[i + 2]}); i += 2; }
+    }
+    if (runs.empty()) runs.push_back({"opencv", "./best.onnx"});
+
+    vector<Sample> data = load_dataset(data_dir, max_images);
+    if (data.empty()) { cerr << "[ERR] 이미지가 없습니다: " << data_dir << "/images" << endl; return 1; }
+    printf("[EVAL] %zu images from %s, threads %d, backends built: %s\n",
+           data.size(), data_dir.c_str(), threads, availableDetectorBackends().c_str());
+
+    printf("\n%-8s %-28s %7s", "backend", "model", "mAP50");
+    for (const string& n : CLASS_NAMES) printf(" %7s", n.c_str());
+    printf(" %9s %9s %8s\n", "infer ms", "p95 ms", "fps");
+    bool all_ok = true;
+    for (const auto& run : runs) {
+        EvalResult r = evaluate(run.first, run.second, threads, data);
+        if (!r.ok) { printf("%-8s %-28s  (실패)\n", run.first.c_str(), run.second.c_str()); all_ok = false; continue; }
+        printf("%-8s %-28s %7.4f", run.first.c_str(), run.second.c_str(), r.map50);
+        for (double ap : r.ap) {
+            if (ap < 0) printf(" %7s", "-");
+            else printf(" %7.4f", ap);
+        }
+        printf(" %9.2f %9.2f %8.1f\n", r.infer.mean(), r.infer.percentile(0.95), 1000.0 / r.total.mean());
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file test_YoloDecoder.cpp
+ * @brief YoloDecoder를 기존 Send_Detect2 후처리 루프(anchor마다 스칼라 클래스 탐색)와 비교합니다.
+ *
+ * - 출력 텐서를 만들어 두 경로의 후보 수 / 순서 / class_id / 점수 / 박스(left, top, width, height)가
+ *   완전히 같은지 검사합니다.
+ *   (난수 점수, 실제와 비슷한 희소 점수, 동점, 임계값과 같은 점수, NaN, 음수, 모두 탈락/모두 통과)
+ * - anchor 수: 2100(320x320), 8400(640x640), 4의 배수가 아닌 수(스칼라 꼬리), 0
+ * - 클래스 수: 1, 3(현재 모델), 80
+ * - 프레임당 디코드 시간 (기존 루프 vs YoloDecoder, 희소 점수 2100 anchor x 3 클래스)
+ *
+ * [컴파일 방법]
+ * g++ -O2 -o test_YoloDecoder test_YoloDecoder.cpp YoloDecoder.cpp -std=c++17
+ * (스칼라 경로 확인: 위 명령에 -U__SSE2__ 추가)
+ *
+ * [실행 방법]
+ * ./test_YoloDecoder
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <cstdio>
+
+#include "YoloDecoder.h"
+
+using namespace std;
+
+static int g_failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { if (g_failures++ < 10) cerr << "[FAIL] " << msg << " (" #cond ")\n"; } \
+} while (0)
+
+static const float CONFIDENCE_THRESHOLD = 0.5f;
+
+struct Box { int x, y, w, h; };
+
+struct Reference {
+    vector<int> class_ids;
+    vector<float> confidences;
+    vector<Box> boxes;
+};
+
+// Send_Detect2.cpp의 기존 후처리 루프 (cv::Rect 대신 Box)
+static void reference_decode(const float* data, int num_detections, int num_classes,
+                             float x_factor, float y_factor, Reference& r) {
+    r.class_ids.clear();
+    r.confidences.clear();
+    r.boxes.clear();
+    const float *cx_data = data;
+    const float *cy_data = data + num_detections;
+    const float *w_data = data + 2 * num_detections;
+    const float *h_data = data + 3 * num_detections;
+    for (int i = 0; i < num_detections; ++i) {
+        float max_conf = 0.0;
+        int class_id = -1;
+        for (int j = 0; j < num_classes; ++j) {
+            float score = data[(4 + j) * num_detections + i];
+            if (score > max_conf) {
+                max_conf = score;
+                class_id = j;
+            }
+        }
+        if (max_conf > CONFIDENCE_THRESHOLD) {
+            r.confidences.push_back(max_conf);
+            r.class_ids.push_back(class_id);
+            float cx = cx_data[i];
+            float cy = cy_data[i];
+            float w =  w_data[i];
+            float h =  h_data[i];
+            int left = (int)((cx - 0.5 * w) * x_factor);
+            int top = (int)((cy - 0.5 * h) * y_factor);
+            int width = (int)(w * x_factor);
+            int height = (int)(h * y_factor);
+            r.boxes.push_back({left, top, width, height});
+        }
+    }
+}
+
+enum class Scores { UNIFORM, SPARSE, TIES, EDGE, NONE, ALL };
+
+static vector<float> make_output(int n, int nc, Scores kind, mt19937& rng) {
+    vector<float> out((size_t)(4 + nc) * n);
+    uniform_real_distribution<float> pos(0.0f, 320.0f), size(2.0f, 200.0f), u(0.0f, 1.0f);
+    for (int i = 0; i < n; i++) {
+        out[i] = pos(rng);
+        out[n + i] = pos(rng);
+        out[2 * n + i] = size(rng);
+        out[3 * n + i] = size(rng);
+    }
+    const float nan = numeric_limits<float>::quiet_NaN();
+    const float edge[] = {0.5f, 0.5f, nextafterf(0.5f, 1.0f), 0.0f, -0.7f, nan, 0.75f, 0.75f, 1.0f};
+    for (int c = 0; c < nc; c++) {
+        float* s = out.data() + (size_t)(4 + c) * n;
+        for (int i = 0; i < n; i++) {
+            float v = u(rng);
+            switch (kind) {
+            case Scores::UNIFORM: s[i] = v; break;
+            case Scores::SPARSE:  s[i] = (v < 0.01f) ? 0.5f + v * 45.0f : v * 0.1f; break;  // 약 1%만 통과
+            case Scores::TIES:    s[i] = (float)((int)(v * 4)) * 0.25f; break;               // 0, 0.25, 0.5, 0.75
+            case Scores::EDGE:    s[i] = edge[(i * 7 + c * 3) % 9]; break;
+            case Scores::NONE:    s[i] = v * 0.5f; break;
+            case Scores::ALL:     s[i] = 0.5001f + v * 0.4f; break;
+            }
+        }
+    }
+    return out;
+}
+
+static void compare(const char* name, const vector<float>& out, int n, int nc, float xf, float yf) {
+    Reference ref;
+    reference_decode(out.data(), n, nc, xf, yf, ref);
+    YoloDecoder dec(nc, CONFIDENCE_THRESHOLD);
+    YoloDetections det;
+    int count = dec.decode(out.data(), n, xf, yf, det);
+    CHECK(count == det.count, name);
+    CHECK(count == (int)ref.confidences.size(),
+          name << " n=" << n << " nc=" << nc << " count " << count << " vs " << ref.confidences.size());
+    int m = min(count, (int)ref.confidences.size());
+    int bad = 0;
+    for (int k = 0; k < m; k++) {
+        const Box& b = ref.boxes[k];
+        bool same = det.class_id[k] == ref.class_ids[k] && det.score[k] == ref.confidences[k] &&
+                    det.left[k] == b.x && det.top[k] == b.y && det.width[k] == b.w && det.height[k] == b.h;
+        if (!same && bad++ == 0)
+            CHECK(same, name << " n=" << n << " nc=" << nc << " candidate " << k << " anchor " << det.anchor[k]);
+    }
+    for (int k = 1; k < count; k++) CHECK(det.anchor[k - 1] < det.anchor[k], name << " anchor order");
+}
+
+static void bench(mt19937& rng) {
+    const int n = 2100, nc = 3, iters = 20000;
+    vector<float> out = make_output(n, nc, Scores::SPARSE, rng);
+    Reference ref;
+    YoloDecoder dec(nc, CONFIDENCE_THRESHOLD);
+    YoloDetections det;
+    volatile size_t sink = 0;
+    auto t0 = chrono::steady_clock::now();
+    for (int i = 0; i < iters; i++) { reference_decode(out.data(), n, nc, 2.0f, 2.0f, ref); sink = sink + ref.boxes.size(); }
+    auto t1 = chrono::steady_clock::now();
+    for (int i = 0; i < iters; i++) { dec.decode(out.data(), n, 2.0f, 2.0f, det); sink = sink + det.count; }
+    auto t2 = chrono::steady_clock::now();
+    double us_ref = chrono::duration<double, micro>(t1 - t0).count() / iters;
+    double us_dec = chrono::duration<double, micro>(t2 - t1).count() / iters;
+    printf("[TIME] %d anchors x %d classes, %d candidates: loop %.2f us, YoloDecoder %.2f us (x%.1f)\n",
+           n, nc, det.count, us_ref, us_dec, us_ref / us_dec);
+}
+
+int main() {
+    mt19937 rng(7);
+    const struct { Scores kind; const char* name; } kinds[] = {
+        {Scores::UNIFORM, "uniform"}, {Scores::SPARSE, "sparse"}, {Scores::TIES, "ties"},
+        {Scores::EDGE, "edge"}, {Scores::NONE, "none"}, {Scores::ALL, "all"},
+    };
+    const int anchors[] = {2100, 8400, 2101, 2103, 3, 1, 0};
+    const int classes[] = {1, 3, 80};
+    int cases = 0;
+    for (const auto& k : kinds)
+        for (int n : anchors)
+            for (int nc : classes) {
+                vector<float> out = make_output(n, nc, k.kind, rng);
+                compare(k.name, out, n, nc, 2.0f, 2.0f);
+                compare(k.name, out, n, nc, 1.3f, 0.7f);
+                cases += 2;
+            }
+    printf("[DECODE] %d cases\n", cases);
+
+    // 재사용: 큰 출력 다음 작은 출력 (count가 초기화되는지)
+    {
+        YoloDecoder dec(3, CONFIDENCE_THRESHOLD);
+        YoloDetections det;
+        vector<float> big = make_output(8400, 3, Scores::ALL, rng);
+        vector<float> none = make_output(2100, 3, Scores::NONE, rng);
+        dec.decode(big.data(), 8400, 2.0f, 2.0f, det);
+        CHECK(det.count == 8400, "all pass");
+        CHECK(dec.decode(none.data(), 2100, 2.0f, 2.0f, det) == 0 && det.count == 0, "reuse resets count");
+    }
+
+    bench(rng);
+    cout << (g_failures ? "[FAIL] " : "[PASS] ") << g_failures << " failures\n";
+    return g_failures ? 1 : 0;
+}
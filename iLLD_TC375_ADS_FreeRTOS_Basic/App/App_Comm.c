@@ -21,10 +21,14 @@
 
 static TaskHandle_t g_someipTaskHandle = NULL;
 static bool g_offerSent = false;
+static bool g_driveSeqValid = false;
+static uint16_t g_driveLastSeq = 0U;
+static uint32_t g_driveSeqGaps = 0U;
 static eth_addr_t g_mac = { .addr = {0x00, 0x00, 0x00, 0x11, 0x11, 0x12} };
 
 static void task_someip_service(void *arg);
 static void send_service_offer_once(void);
+static bool decode_binary_drive_command(const uint8_t *payload, uint16_t length, DriveCommand *out_cmd);
 void AppComm_SendOffer_FromTcpip(void *arg);
 
 void AppComm_Init(void)
@@ -47,6 +51,46 @@ void AppComm_Init(void)
     configASSERT(ok == pdPASS);
 }
 
+static inline uint16_t be16(const uint8_t *p)
+{
+    return (uint16_t)(((uint16_t)p[0] << 8) | (uint16_t)p[1]);
+}
+
+// 바이너리 페이로드 디코드 (수신 버퍼에서 바로 읽음, 복사/sscanf 없음)
+static bool decode_binary_drive_command(const uint8_t *payload, uint16_t length, DriveCommand *out_cmd)
+{
+    if ((length < APP_COMM_DRIVE_BIN_SIZE) ||
+        (payload[APP_COMM_DRIVE_BIN_OFS_VERSION] != APP_COMM_DRIVE_BIN_VERSION))
+    {
+        return false;
+    }
+
+    uint16_t seq = be16(&payload[APP_COMM_DRIVE_BIN_OFS_SEQUENCE]);
+    if (g_driveSeqValid && (seq != (uint16_t)(g_driveLastSeq + 1U)))
+    {
+        g_driveSeqGaps++;   /* 유실/순서 바뀜 (진단용, 명령은 그대로 적용) */
+    }
+    g_driveLastSeq = seq;
+    g_driveSeqValid = true;
+
+    int duty1 = (int16_t)be16(&payload[APP_COMM_DRIVE_BIN_OFS_DUTY1]);
+    int duty2 = (int16_t)be16(&payload[APP_COMM_DRIVE_BIN_OFS_DUTY2]);
+    int dir1 = payload[APP_COMM_DRIVE_BIN_OFS_DIR1];
+    int dir2 = payload[APP_COMM_DRIVE_BIN_OFS_DIR2];
+
+    if (!AppShared_MakeDriveCommand(duty1, duty2, dir1, dir2, out_cmd))
+    {
+        return false;
+    }
+    // 연속 조향 값 (구 버전 송신측은 flags = 0 → 기존처럼 듀티로 방향지시등 판단)
+    if ((payload[APP_COMM_DRIVE_BIN_OFS_FLAGS] & APP_COMM_DRIVE_BIN_FLAG_STEER) != 0U)
+    {
+        out_cmd->steer = (int8_t)payload[APP_COMM_DRIVE_BIN_OFS_STEER];
+        out_cmd->steer_valid = true;
+    }
+    return true;
+}
+
 //속도값 받은거 처리
 void AppComm_HandleDriveCommandPayload(const uint8_t *payload, uint16_t length)
 {
@@ -56,6 +100,25 @@ void AppComm_HandleDriveCommandPayload(const uint8_t *payload, uint16_t length)
         return;
     }
 
+    // 바이너리 형식 (첫 바이트 = magic, 텍스트는 숫자로 시작)
+    if (payload[APP_COMM_DRIVE_BIN_OFS_MAGIC] == APP_COMM_DRIVE_BIN_MAGIC)
+    {
+        DriveCommand bin_cmd;
+        if (decode_binary_drive_command(payload, length, &bin_cmd))
+        {
+            AppShared_SetCommand(&bin_cmd);
+        }
+        else
+        {
+            my_printf("SOME/IP invalid binary payload (len=%u, ver=%u, seq gaps=%lu)\n",
+                      (unsigned int)length,
+                      (unsigned int)((length > 1U) ? payload[APP_COMM_DRIVE_BIN_OFS_VERSION] : 0U),
+                      (unsigned long)g_driveSeqGaps);
+        }
+        return;
+    }
+
+    // 텍스트 형식 "L;R;Ldir;Rdir" (기존 호환)
     char line[SOMEIP_PAYLOAD_MAX];
     size_t copy_len = (length < (SOMEIP_PAYLOAD_MAX - 1U)) ? length : (SOMEIP_PAYLOAD_MAX - 1U);
 
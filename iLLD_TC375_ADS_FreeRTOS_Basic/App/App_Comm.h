@@ -11,4 +11,40 @@ void AppComm_HandleDriveCommandPayload(const uint8_t *payload, uint16_t length);
 
 #define APP_COMM_SOMEIP_METHOD_DRIVE_COMMAND   (0x0201U)
 
+/*
+ * Binary drive command payload (method 0x0201), packed, big-endian, 16 bytes.
+ * Must match SomeipSender (LKAS_ACC/SomeipSender.h) on the Raspberry Pi.
+ *
+ *  off size field
+ *   0   1   magic     (0xD5, never a digit/sign -> text payloads still accepted)
+ *   1   1   version   (0x01)
+ *   2   2   sequence  (wraps at 0xFFFF)
+ *   4   4   timestamp (sender steady clock, ms, low 32 bits)
+ *   8   2   duty 1    (int16, same slot as 1st text field -> left_duty)
+ *  10   2   duty 2    (int16, same slot as 2nd text field -> right_duty)
+ *  12   1   dir 1     (0/1, 3rd text field -> left_dir)
+ *  13   1   dir 2     (0/1, 4th text field -> right_dir)
+ *  14   1   flags     (bit0 STEER: byte 15 is valid, other bits 0)
+ *  15   1   steer     (int8, -100..+100, continuous steering from the Pi PD mode;
+ *                      + = duty 1 wheel slower (left lamp), 0 when STEER is clear)
+ *
+ * Newer versions may append fields; decoders accept length >= SIZE for the same version.
+ */
+#define APP_COMM_DRIVE_BIN_MAGIC               (0xD5U)
+#define APP_COMM_DRIVE_BIN_VERSION             (0x01U)
+#define APP_COMM_DRIVE_BIN_SIZE                (16U)
+
+#define APP_COMM_DRIVE_BIN_OFS_MAGIC           (0U)
+#define APP_COMM_DRIVE_BIN_OFS_VERSION         (1U)
+#define APP_COMM_DRIVE_BIN_OFS_SEQUENCE        (2U)
+#define APP_COMM_DRIVE_BIN_OFS_TIMESTAMP       (4U)
+#define APP_COMM_DRIVE_BIN_OFS_DUTY1           (8U)
+#define APP_COMM_DRIVE_BIN_OFS_DUTY2           (10U)
+#define APP_COMM_DRIVE_BIN_OFS_DIR1            (12U)
+#define APP_COMM_DRIVE_BIN_OFS_DIR2            (13U)
+#define APP_COMM_DRIVE_BIN_OFS_FLAGS           (14U)
+#define APP_COMM_DRIVE_BIN_OFS_STEER           (15U)
+
+#define APP_COMM_DRIVE_BIN_FLAG_STEER          (0x01U)
+
 #endif /* APP_COMM_H_ */
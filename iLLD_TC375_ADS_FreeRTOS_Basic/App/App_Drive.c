@@ -1,6 +1,7 @@
 #include "App_Drive.h"
 
 #include "App_Shared.h"
+#include "App_DriveLaw.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "Motor.h"
@@ -15,19 +16,6 @@
 
 static TaskHandle_t g_driveTaskHandle = NULL;
 
-static inline int clampi(int value, int lo, int hi)
-{
-    if (value < lo)
-    {
-        return lo;
-    }
-    if (value > hi)
-    {
-        return hi;
-    }
-    return value;
-}
-
 static void task_motor_control(void *arg)
 {
     (void)arg;
@@ -58,21 +46,25 @@ static void task_motor_control(void *arg)
         int targetRight = 0;
         int targetLeftDir = 1;
         int targetRightDir = 1;
+        int targetSteer = 0;
+        bool targetSteerValid = false;
 
         //cmd가 유효하면
         if (diagActive && haveOverride)
         {
-            targetLeft = clampi(overrideSpeed, DUTY_MIN, DUTY_MAX);
-            targetRight = clampi(overrideSpeed, DUTY_MIN, DUTY_MAX);
+            targetLeft = DriveLaw_ClampI(overrideSpeed, DUTY_MIN, DUTY_MAX);
+            targetRight = DriveLaw_ClampI(overrideSpeed, DUTY_MIN, DUTY_MAX);
             targetLeftDir = overrideDir ? 1 : 0;
             targetRightDir = overrideDir ? 1 : 0;
         }
         else if (haveFresh)
         {
-            targetLeft = clampi(cmd.left_duty, DUTY_MIN, DUTY_MAX);
-            targetRight = clampi(cmd.right_duty, DUTY_MIN, DUTY_MAX);
+            targetLeft = DriveLaw_ClampI(cmd.left_duty, DUTY_MIN, DUTY_MAX);
+            targetRight = DriveLaw_ClampI(cmd.right_duty, DUTY_MIN, DUTY_MAX);
             targetLeftDir = cmd.left_dir ? 1 : 0;
             targetRightDir = cmd.right_dir ? 1 : 0;
+            targetSteer = cmd.steer;
+            targetSteerValid = cmd.steer_valid;
         }
         //AEB가 활성화되어있고 전진상태라면 정지
         if (!diagActive && aebActive && (targetLeftDir == 1) && (targetRightDir == 1))
@@ -82,7 +74,14 @@ static void task_motor_control(void *arg)
         }
 
         // 깜빡이 상태 업데이트: 최종 타겟 듀티 기준
-        AppLamp_UpdateBySpeeds(targetLeft, targetRight);
+        if (targetSteerValid)
+        {
+            AppLamp_UpdateBySteer(targetLeft, targetRight, targetSteer);
+        }
+        else
+        {
+            AppLamp_UpdateBySpeeds(targetLeft, targetRight);
+        }
         // 속도 즉시 적용 (램프 기능 제거)
         currentLeft = targetLeft;
         currentRight = targetRight;
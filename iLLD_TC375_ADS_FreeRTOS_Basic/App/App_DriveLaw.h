@@ -0,0 +1,102 @@
+#ifndef APP_DRIVELAW_H_
+#define APP_DRIVELAW_H_
+
+#include <stdint.h>
+
+/*
+ * Fixed-point drive law shared by the TC375 and the Raspberry Pi (LKAS_ACC).
+ *
+ * Header-only C99, integer only: no float, no libc, no 64-bit division.
+ * It builds unchanged with the TriCore toolchain and with g++ on the Pi.
+ *
+ *  - DriveLaw_AccBaseSpeed : ACCController::computeBaseSpeed + scaleSpeedToCommand
+ *                            (ToF distance mm -> base speed command 0..100)
+ *  - DriveLaw_Mix          : differential mix of drive mode + base speed (Pi build_motor)
+ *  - DriveLaw_ClampI       : duty clamp used by task_motor_control
+ *
+ * Units: distance mm, speed mm/s, gains Q16.16 (1.0 = 65536).
+ * The helpers are branch-free: comparisons become sign masks (x >> 31).
+ * This assumes an arithmetic right shift of negative values, which GCC and
+ * the TASKING/HighTec TriCore compilers provide.
+ * Operands of the min/max helpers must differ by less than 2^31.
+ *
+ * Compared with the double reference, results can be 1 count lower only
+ * where the reference lands within rounding of an integer step.
+ * LKAS_ACC/test_DriveLaw.cpp checks every distance 0..65535 mm.
+ */
+
+#define DRIVELAW_Q16_ONE          (65536)
+#define DRIVELAW_Q16(x)           ((int32_t)((x) * 65536.0 + 0.5))   /* constant expressions only */
+
+typedef struct
+{
+    int32_t max_speed_mms;        /* speed mapped to cmd_max                          */
+    int32_t base_speed_mms;       /* speed at the target distance                     */
+    int32_t stop_distance_mm;     /* below this: command 0                            */
+    int32_t target_distance_mm;   /* target safe distance                             */
+    int32_t kp_q16;               /* (mm/s) per mm of distance error, Q16             */
+    int32_t cmd_max;              /* motor command at max_speed_mms (100)             */
+    int32_t cmd_min_run;          /* lowest command that still turns the motor (40)   */
+} DriveLawAccParams;
+
+/* Same values as ACCController::ACCController() */
+#define DRIVELAW_ACC_DEFAULTS   { 1000, 800, 400, 1200, DRIVELAW_Q16(0.4), 100, 40 }
+
+/* all ones if a < b, else 0 */
+static inline int32_t DriveLaw_MaskLt(int32_t a, int32_t b)
+{
+    return (a - b) >> 31;
+}
+
+static inline int32_t DriveLaw_MinI(int32_t a, int32_t b)
+{
+    int32_t d = a - b;
+    return b + (d & (d >> 31));
+}
+
+static inline int32_t DriveLaw_MaxI(int32_t a, int32_t b)
+{
+    int32_t d = a - b;
+    return a - (d & (d >> 31));
+}
+
+static inline int32_t DriveLaw_ClampI(int32_t value, int32_t lo, int32_t hi)
+{
+    return DriveLaw_MinI(DriveLaw_MaxI(value, lo), hi);
+}
+
+/* Speed (mm/s) -> motor command: 0 if speed <= 0, else cmd_min_run..cmd_max linear up to max_speed_mms. */
+static inline int32_t DriveLaw_SpeedToCommand(const DriveLawAccParams *p, int32_t speed_mms)
+{
+    int32_t speed = DriveLaw_ClampI(speed_mms, 0, p->max_speed_mms);
+    int32_t span = p->cmd_max - p->cmd_min_run;
+    int32_t cmd = p->cmd_min_run + (speed * span) / p->max_speed_mms;   /* 32-bit divide (native on TriCore) */
+    return cmd & DriveLaw_MaskLt(0, speed);                              /* speed == 0 -> 0 */
+}
+
+/* ToF distance (mm) -> ACC base speed command (0..cmd_max). */
+static inline int32_t DriveLaw_AccBaseSpeed(const DriveLawAccParams *p, int32_t distance_mm)
+{
+    int32_t error_mm = distance_mm - p->target_distance_mm;
+    int32_t target = p->base_speed_mms + (int32_t)(((int64_t)p->kp_q16 * error_mm) >> 16);
+    int32_t cmd = DriveLaw_SpeedToCommand(p, target);
+    return cmd & ~DriveLaw_MaskLt(distance_mm, p->stop_distance_mm);      /* emergency stop */
+}
+
+/*
+ * Differential mix: drive_mode 0 = straight (both base), < 0 = left turn (right wheel base + turn_delta, left 0),
+ * > 0 = right turn (left wheel base + turn_delta, right 0). Duties clamped to 0..100.
+ */
+static inline void DriveLaw_Mix(int32_t drive_mode, int32_t base_speed, int32_t turn_delta,
+                                int32_t *right_duty, int32_t *left_duty)
+{
+    int32_t left_turn = DriveLaw_MaskLt(drive_mode, 0);     /* all ones if mode < 0 */
+    int32_t right_turn = DriveLaw_MaskLt(0, drive_mode);    /* all ones if mode > 0 */
+    int32_t turning = base_speed + turn_delta;
+    int32_t r = (base_speed & ~(left_turn | right_turn)) | (turning & left_turn);
+    int32_t l = (base_speed & ~(left_turn | right_turn)) | (turning & right_turn);
+    *right_duty = DriveLaw_ClampI(r, 0, 100);
+    *left_duty = DriveLaw_ClampI(l, 0, 100);
+}
+
+#endif /* APP_DRIVELAW_H_ */
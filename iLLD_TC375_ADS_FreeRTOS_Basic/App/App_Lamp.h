@@ -64,4 +64,23 @@ static inline void AppLamp_UpdateBySpeeds(int left_duty, int right_duty)
     AppLamp_SetHazard(hz_on);
 }
 
+/*
+ * Continuous steering (binary payload steer byte): both wheels keep turning, so the duty-based rule above
+ * never blinks. Blink on the steer value instead; + = duty 1 (left_duty) wheel slower = left lamp,
+ * matching AppLamp_UpdateBySpeeds for the 3-state command.
+ */
+#define APP_LAMP_STEER_THRESHOLD    (40)
+
+static inline void AppLamp_UpdateBySteer(int left_duty, int right_duty, int steer)
+{
+    if ((left_duty == 0) && (right_duty == 0))
+    {
+        AppLamp_UpdateBySpeeds(0, 0);   /* stopped: hazard */
+        return;
+    }
+    AppLamp_SetLeft(steer >= APP_LAMP_STEER_THRESHOLD);
+    AppLamp_SetRight(steer <= -APP_LAMP_STEER_THRESHOLD);
+    AppLamp_SetHazard(false);
+}
+
 #endif /* APP_LAMP_H_ */
@@ -36,6 +36,8 @@ void AppShared_Init(void)
     g_latestCommand.right_duty = 0;
     g_latestCommand.left_dir = 1;
     g_latestCommand.right_dir = 1;
+    g_latestCommand.steer = 0;
+    g_latestCommand.steer_valid = false;
 
     g_aebActive = false;
     g_diagSessionActive = false;
@@ -67,6 +69,16 @@ bool AppShared_ParseBleCommand(const char *line, DriveCommand *out_cmd)
         return false;
     }
 
+    return AppShared_MakeDriveCommand(left, right, left_dir, right_dir, out_cmd);
+}
+
+bool AppShared_MakeDriveCommand(int left, int right, int left_dir, int right_dir, DriveCommand *out_cmd)
+{
+    if (out_cmd == NULL)
+    {
+        return false;
+    }
+
     if (left < DUTY_MIN || left > 1000 || right < DUTY_MIN || right > 1000)
     {
         return false;
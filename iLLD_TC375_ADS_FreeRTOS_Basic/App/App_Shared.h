@@ -14,6 +14,8 @@ typedef struct
     int right_duty;
     int left_dir;
     int right_dir;
+    int steer;          /* -100..100 continuous steering (binary payload byte 15), 0 if not sent */
+    bool steer_valid;   /* steer was sent (flags bit0); lamps follow steer instead of duties */
     TickType_t timestamp;
     bool valid;
 } DriveCommand;
@@ -21,6 +23,8 @@ typedef struct
 void AppShared_Init(void);
 
 bool AppShared_ParseBleCommand(const char *line, DriveCommand *out_cmd);
+/* Validate/clamp raw fields (text or binary payload) into a DriveCommand. */
+bool AppShared_MakeDriveCommand(int left, int right, int left_dir, int right_dir, DriveCommand *out_cmd);
 
 void AppShared_SetCommand(const DriveCommand *cmd);
 bool AppShared_GetCommand(DriveCommand *out_cmd);